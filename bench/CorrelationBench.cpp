@@ -0,0 +1,73 @@
+// Lag search by FFT cross-correlation against direct correlation over the
+// same lags, with lags up to a quarter of the span as used for whole logs.
+//
+// Usage: correlation_bench [max samples]
+
+#include "filter/CrossCorrelation.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Best lag by summing every product; O(n * lags)
+    long directLag(const std::vector<double>& reference, const std::vector<double>& signal, size_t count, size_t maxLag) {
+        long best = 0;
+        double bestValue = -1e300;
+        for (long lag = -static_cast<long>(maxLag); lag <= static_cast<long>(maxLag); ++lag) {
+            double sum = 0.0;
+            for (size_t t = maxLag; t < count - maxLag; ++t) {
+                sum += signal[t] * reference[t - lag];
+            }
+            if (sum > bestValue) {
+                bestValue = sum;
+                best = lag;
+            }
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t maxSamples = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1 << 20;
+
+    // Smoothed noise as the reference, and a copy 37 samples late with noise added
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> reference(maxSamples);
+    std::vector<double> signal(maxSamples);
+    double state = 0.0;
+    for (size_t i = 0; i < maxSamples; ++i) {
+        state = 0.95 * state + noise(random);
+        reference[i] = state;
+    }
+    for (size_t i = 0; i < maxSamples; ++i) {
+        signal[i] = (i >= 37 ? reference[i - 37] : 0.0) + 0.2 * noise(random);
+    }
+
+    std::printf("%10s %8s %12s %12s %10s\n", "samples", "lag", "fft ms", "direct ms", "fft lag");
+    for (size_t count = 1024; count <= maxSamples; count *= 4) {
+        const size_t maxLag = count / 4;
+        auto start = Clock::now();
+        const filter::CorrelationPeak peak = filter::correlate(reference.data(), signal.data(), count, maxLag, 1.0);
+        const double fft = millisecondsSince(start);
+
+        // Direct correlation is skipped once it would take minutes
+        if (count <= 65536) {
+            start = Clock::now();
+            const long lag = directLag(reference, signal, count, maxLag);
+            std::printf("%10zu %8ld %12.2f %12.2f %10.2f\n", count, lag, fft, millisecondsSince(start), peak.lagSamples);
+        } else {
+            std::printf("%10zu %8s %12.2f %12s %10.2f\n", count, "-", fft, "-", peak.lagSamples);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Kalman filters against low-pass IIR filters at equal noise rejection.
+// Each IIR cutoff is tuned so white measurement noise comes out with the
+// same variance as from the Kalman filter; what differs is how far each
+// lags a moving target, and the cost per sample.
+//
+// Usage: kalman_bench [samples]
+
+#include "filter/FilterDesign.hpp"
+#include "filter/KalmanFilter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr double kSampleRate = 100.0;
+    constexpr double kMeasurementNoise = 0.05;
+    constexpr size_t kImpulseLength = 1 << 16;
+
+    double nanosecondsPerSample(Clock::time_point start, size_t samples) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(samples);
+    }
+
+    // Best of a few runs, so clock ramp-up and first-touch page faults do not count
+    double fastest(const std::function<double()>& run) {
+        double best = run();
+        for (int i = 0; i < 2; ++i) {
+            best = std::min(best, run());
+        }
+        return best;
+    }
+
+    // Output variance per unit of white input variance: the sum of the
+    // squared impulse response
+    double noiseGain(const std::function<void(std::vector<double>&)>& run) {
+        std::vector<double> impulse(kImpulseLength, 0.0);
+        impulse[0] = 1.0;
+        run(impulse);
+        double sum = 0.0;
+        for (double value : impulse) {
+            sum += value * value;
+        }
+        return sum;
+    }
+
+    std::shared_ptr<const std::vector<filter::Biquad>> design(filter::DesignType type, int order, double cutoff) {
+        filter::DesignSpec spec;
+        spec.type = type;
+        spec.order = order;
+        spec.cutoffFreq = cutoff;
+        spec.sampleRate = kSampleRate;
+        return std::make_shared<const std::vector<filter::Biquad>>(filter::designLowPass(spec));
+    }
+
+    double iirNoiseGain(const std::shared_ptr<const std::vector<filter::Biquad>>& sections) {
+        return noiseGain([&](std::vector<double>& data) {
+            filter::BiquadCascade cascade(sections);
+            cascade.process(data.data(), data.data(), data.size());
+        });
+    }
+
+    // Cutoff with the given noise gain; the gain rises with the cutoff
+    double matchCutoff(filter::DesignType type, int order, double gain) {
+        double low = 1e-4;
+        double high = 0.49 * kSampleRate;
+        for (int i = 0; i < 60; ++i) {
+            const double middle = std::sqrt(low * high);
+            (iirNoiseGain(design(type, order, middle)) < gain ? low : high) = middle;
+        }
+        return std::sqrt(low * high);
+    }
+
+    double rmsError(const std::vector<double>& output, const std::vector<double>& truth) {
+        // The first seconds are left out, so start-up transients do not count
+        const size_t skip = static_cast<size_t>(5.0 * kSampleRate);
+        double sum = 0.0;
+        for (size_t i = skip; i < output.size(); ++i) {
+            sum += (output[i] - truth[i]) * (output[i] - truth[i]);
+        }
+        return std::sqrt(sum / static_cast<double>(output.size() - skip));
+    }
+
+    void report(const char* name, double gain, double ns, const std::vector<double>& output, const std::vector<double>& truth) {
+        std::printf("  %-30s %10.2f %10.4f %10.2f\n", name, 10.0 * std::log10(gain), rmsError(output, truth), ns);
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t samples = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1 << 20;
+
+    // A mechanism moving back and forth, measured with white noise
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, kMeasurementNoise);
+    std::vector<double> truth(samples);
+    std::vector<double> measured(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        truth[i] = 2.0 * std::sin(0.5 * t) + 0.5 * std::sin(1.7 * t);
+        measured[i] = truth[i] + noise(random);
+    }
+
+    struct Case {
+        const char* name;
+        filter::KinematicModel model;
+        double processNoise;
+        bool steadyState;
+    };
+    const Case cases[] = {
+        {"constant velocity, q=1", filter::KinematicModel::ConstantVelocity, 1.0, true},
+        {"constant velocity, q=10", filter::KinematicModel::ConstantVelocity, 10.0, true},
+        {"constant velocity, q=10, full", filter::KinematicModel::ConstantVelocity, 10.0, false},
+        {"constant acceleration, q=10", filter::KinematicModel::ConstantAcceleration, 10.0, true},
+        {"constant acceleration, q=100", filter::KinematicModel::ConstantAcceleration, 100.0, true},
+    };
+
+    std::printf("%d Hz, measurement noise %.3f, raw rms error %.4f\n\n", static_cast<int>(kSampleRate),
+                kMeasurementNoise, rmsError(measured, truth));
+    std::printf("  %-30s %10s %10s %10s\n", "filter", "noise dB", "rms error", "ns/sample");
+    for (const Case& test : cases) {
+        filter::KinematicSettings settings;
+        settings.sampleRate = kSampleRate;
+        settings.processNoise = test.processNoise;
+        settings.measurementNoise = kMeasurementNoise;
+        settings.steadyState = test.steadyState;
+
+        // Linear once started at zero; the full form also needs its
+        // covariance settled before the impulse
+        const double gain = noiseGain([&](std::vector<double>& data) {
+            auto kalman = filter::makeKinematicKalmanFilter(test.model, settings);
+            kalman->processBlock(std::vector<double>(kImpulseLength, 0.0));
+            data = kalman->processBlock(data);
+        });
+
+        std::printf("%s\n", test.name);
+        std::vector<double> kalmanOutput;
+        const double kalmanNs = fastest([&]() {
+            auto kalman = filter::makeKinematicKalmanFilter(test.model, settings);
+            const auto start = Clock::now();
+            kalmanOutput = kalman->processBlock(measured);
+            return nanosecondsPerSample(start, samples);
+        });
+        report("kalman", gain, kalmanNs, kalmanOutput, truth);
+
+        for (auto [type, order] : {std::pair{filter::DesignType::FirstOrder, 1},
+                                   std::pair{filter::DesignType::Butterworth, 2},
+                                   std::pair{filter::DesignType::Butterworth, 4}}) {
+            const double cutoff = matchCutoff(type, order, gain);
+            const auto sections = design(type, order, cutoff);
+            std::vector<double> output(samples);
+            const double ns = fastest([&]() {
+                filter::BiquadCascade cascade(sections);
+                const auto start = Clock::now();
+                cascade.process(measured.data(), output.data(), samples);
+                return nanosecondsPerSample(start, samples);
+            });
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s %d, %.2f Hz", filter::designTypeName(type).c_str(), order, cutoff);
+            report(name, iirNoiseGain(sections), ns, output, truth);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Sliding-window median: O(log w) partitioned window against re-selecting
+// the median of a copy of the window for every sample.
+//
+// Usage: order_statistic_bench [samples]
+
+#include "filter/OrderStatisticFilter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double nanosecondsPerSample(Clock::time_point start, size_t samples) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(samples);
+    }
+
+    // Median of a copy of the window via nth_element: O(w) per sample
+    std::vector<double> naiveMedian(const std::vector<double>& input, size_t windowSize) {
+        std::vector<double> output(input.size());
+        std::deque<double> window;
+        std::vector<double> scratch;
+        for (size_t i = 0; i < input.size(); ++i) {
+            window.push_back(input[i]);
+            if (window.size() > windowSize) {
+                window.pop_front();
+            }
+            scratch.assign(window.begin(), window.end());
+            const size_t middle = scratch.size() / 2;
+            std::nth_element(scratch.begin(), scratch.begin() + middle, scratch.end());
+            double median = scratch[middle];
+            if (scratch.size() % 2 == 0) {
+                median = 0.5 * (median + *std::max_element(scratch.begin(), scratch.begin() + middle));
+            }
+            output[i] = median;
+        }
+        return output;
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t samples = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 200000;
+
+    // Noisy signal with occasional spikes, like encoder glitches
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    std::vector<double> input(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        input[i] = std::sin(i * 0.01) + noise(random) + (i % 97 == 0 ? 50.0 : 0.0);
+    }
+
+    std::printf("%8s %14s %14s %9s\n", "window", "sliding ns/s", "naive ns/s", "speedup");
+    for (size_t windowSize : {9, 101, 1001, 5001}) {
+        auto start = Clock::now();
+        filter::MedianFilter median(windowSize);
+        const std::vector<double> fast = median.processBlock(input);
+        const double fastTime = nanosecondsPerSample(start, samples);
+
+        // The naive version is slow for large windows; time a prefix
+        const size_t naiveSamples = std::min(samples, windowSize > 1000 ? size_t(20000) : samples);
+        const std::vector<double> prefix(input.begin(), input.begin() + naiveSamples);
+        start = Clock::now();
+        const std::vector<double> slow = naiveMedian(prefix, windowSize);
+        const double naiveTime = nanosecondsPerSample(start, naiveSamples);
+
+        for (size_t i = 0; i < naiveSamples; ++i) {
+            if (std::fabs(fast[i] - slow[i]) > 1e-12) {
+                std::fprintf(stderr, "mismatch at %zu (window %zu): %g vs %g\n", i, windowSize, fast[i], slow[i]);
+                return 1;
+            }
+        }
+        std::printf("%8zu %14.1f %14.1f %8.1fx\n", windowSize, fastTime, naiveTime, naiveTime / fastTime);
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Welch PSD and STFT spectrogram: FFT cost per segment, batch analysis on
+// one thread against all of them, and streamed blocks appended to a running
+// analysis against recomputing it from the whole signal.
+//
+// Usage: spectrum_bench [samples]
+
+#include "filter/SpectrumAnalyzer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t samples = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1 << 20;
+
+    // Two tones in white noise
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, 0.5);
+    std::vector<double> input(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        input[i] = std::sin(i * 0.3) + 0.1 * std::sin(i * 1.7) + noise(random);
+    }
+
+    std::printf("%8s %14s\n", "size", "us/transform");
+    for (size_t size : {256, 1024, 4096, 16384}) {
+        auto plan = filter::RealFft::plan(size);
+        std::vector<std::complex<double>> spectrum(plan->bins());
+        const size_t transforms = std::max<size_t>(1, samples / size);
+        auto start = Clock::now();
+        for (size_t i = 0; i < transforms; ++i) {
+            plan->forward(&input[i * size], spectrum.data());
+        }
+        std::printf("%8zu %14.2f\n", size, 1000.0 * millisecondsSince(start) / static_cast<double>(transforms));
+    }
+
+    filter::SpectrumOptions options;
+    options.segmentLength = 1024;
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("\n%8s %14s\n", "threads", "batch ms");
+    for (size_t threads : {size_t(1), hardwareThreads}) {
+        options.threadCount = threads;
+        filter::SpectrumAnalyzer analyzer(options);
+        auto start = Clock::now();
+        analyzer.append(input);
+        std::printf("%8zu %14.2f\n", threads, millisecondsSince(start));
+    }
+
+    // Streaming in 20 ms blocks at 1 kHz; recomputing is timed on a sample of blocks
+    const size_t blockSize = 20;
+    filter::SpectrumAnalyzer running(options);
+    auto start = Clock::now();
+    for (size_t i = 0; i + blockSize <= samples; i += blockSize) {
+        running.append(&input[i], blockSize);
+    }
+    const double incremental = 1000.0 * millisecondsSince(start) / static_cast<double>(samples / blockSize);
+
+    const size_t recomputed = 20;
+    start = Clock::now();
+    for (size_t block = 1; block <= recomputed; ++block) {
+        filter::SpectrumAnalyzer full(options);
+        full.append(input.data(), samples * block / recomputed);
+    }
+    const double recompute = 1000.0 * millisecondsSince(start) / static_cast<double>(recomputed);
+    std::printf("\n%20s %14.2f\n%20s %14.2f\n", "append us/block", incremental, "recompute us/block", recompute);
+    return 0;
+}
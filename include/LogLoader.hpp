@@ -3,44 +3,83 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
-#include <fstream>
-#include <wpigui/DataLogReader.h>
-#include <wpi/DataLog.h>
-#include <wpi/DataLogRecord.h>
-#include <wpi/DataLogRecordType.h>
+#include <functional>
+#include "data/WpiLogReader.hpp"
+#include "data/WpiLogColumns.hpp"
+#include "data/MinMaxPyramid.hpp"
 
 struct LogEntry {
     double timestamp;
     std::map<std::string, double> values;
 };
 
+// One logged field as a (timestamp[], value[]) column pair, sorted by timestamp
+struct LogColumn {
+    std::string name;
+    std::string type;
+    std::vector<int64_t> timestamps;
+    std::vector<double> values;
+    data::MinMaxPyramid pyramid;  // Summary of values for plotting at any zoom level
+};
+
 class LogLoader {
 public:
-    LogLoader() = default;
-    ~LogLoader() = default;
+    // Receives a bounded chunk of samples for one field; return false to stop streaming
+    using ChunkCallback = std::function<bool(const std::string& field,
+                                             const std::vector<double>& timestamps,
+                                             const std::vector<double>& values)>;
+
+    LogLoader();
+    ~LogLoader();
 
-    // Load a WPILib log file from the given path
+    // Load a WPILib log file from the given path. Array and struct entries are
+    // expanded into one field per element or member, e.g. "/arm/angles[2]" or
+    // "/drive/pose/translation/x".
     bool LoadFile(const std::string& filename);
 
-    // Get all log entries
-    const std::vector<LogEntry>& GetEntries() const { return entries; }
+    // Stream a WPILib log file without materializing it. Samples are buffered per
+    // field and handed to the callback whenever the total buffered size reaches
+    // memoryBudgetBytes, and once more at the end of the file. With fields, only
+    // those are buffered; records of other entries are skipped undecoded.
+    bool StreamFile(const std::string& filename, size_t memoryBudgetBytes, const ChunkCallback& callback,
+                    const std::vector<std::string>& fields = {});
+
+    // Bytes of the log streamed so far and its total size; valid inside the
+    // StreamFile callback. Compressed logs count decompressed bytes.
+    uint64_t GetStreamPosition() const { return m_reader.getPosition(); }
+    uint64_t GetStreamSize() const { return m_reader.size(); }
+
+    // Get all columns, in field order
+    const std::vector<LogColumn>& GetColumns() const { return m_columns; }
+
+    // Get the column for a field, or nullptr if there is none
+    const LogColumn* GetColumn(const std::string& field) const;
+
+    // Get a timestamp-aligned row view. It is materialized on first use and
+    // costs one map per distinct timestamp, so prefer GetColumn for large logs.
+    const std::vector<LogEntry>& GetEntries() const;
 
     // Get available data fields/columns
-    const std::vector<std::string>& GetFields() const { return fields; }
+    const std::vector<std::string>& GetFields() const { return m_fields; }
 
     // Clear all loaded data
-    void Clear() { entries.clear(); fields.clear(); }
+    void Clear();
 
 private:
-    void ProcessRecord(const wpigui::DataLogReader::Record& record);
-    void ProcessControlRecord(const wpigui::DataLogReader::Record& record);
-    void ProcessDataRecord(const wpigui::DataLogReader::Record& record);
-    // void ProcessRecord(const wpi::log::DataLogRecord& record);
-    // void ProcessControlRecord(const wpi::log::StartRecordData& data);
-    // void ProcessDataRecord(const wpi::log::DataRecord& data);
-
-    std::vector<LogEntry> entries;
-    std::vector<std::string> fields;
-    std::map<int, std::string> entryNames;
-}; 
\ No newline at end of file
+    void ProcessControlRecord(const data::wpilog::RecordView& record);
+    bool DecodeScalar(const data::wpilog::RecordView& record, double& value) const;
+    size_t AddField(const std::string& name, const std::string& type);
+    size_t AddSlotField(const data::wpilog::EntryInfo& info, const data::wpilog::CompositeLayout& layout, size_t slot);
+    void MergeColumn(size_t index, data::ScalarColumn& column);
+
+    std::vector<LogColumn> m_columns;
+    std::vector<std::string> m_fields;
+    std::unordered_map<std::string, size_t> m_fieldIndex;  // Field name -> column index
+    std::unordered_map<uint32_t, size_t> m_entryColumns;   // Entry id -> column index
+    std::unordered_map<uint64_t, std::vector<size_t>> m_slotColumns;  // Composite definition (start offset) -> column per slot
+    mutable std::vector<LogEntry> m_entries;
+    mutable bool m_entriesBuilt = false;
+    data::WpiLogReader m_reader;
+};
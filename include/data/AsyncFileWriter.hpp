@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace data {
+
+// Writes a file from a background thread. The caller fills large aligned
+// buffers; full buffers are queued for the writer thread and come back once
+// written. When every buffer is in flight the caller waits for the disk
+// (backpressure), so memory stays bounded however fast output is produced.
+class AsyncFileWriter {
+public:
+    static constexpr size_t kBufferAlignment = 4096;
+
+    explicit AsyncFileWriter(size_t bufferSize = 1 << 20, size_t bufferCount = 4);
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // Create or truncate the file and start the writer thread; a file that
+    // cannot be created sets hasFailed()
+    bool open(const std::string& filename);
+
+    // Contiguous space for at least size bytes (size <= buffer size), valid
+    // until commit(); returns nullptr after a write error
+    char* reserve(size_t size);
+    void commit(size_t size);
+
+    // Copy bytes into the buffers; returns false after a write error
+    bool write(const void* data, size_t size);
+
+    // Hand the partly filled buffer to the writer thread now instead of
+    // when it is full, bounding how much is lost if the process dies
+    bool flush();
+
+    // Write everything queued so far and close the file
+    bool close();
+
+    bool isOpen() const { return file_ != nullptr; }
+    bool hasFailed() const { return failed_.load(); }
+    uint64_t getBytesWritten() const { return bytesWritten_.load(); }
+    size_t getBufferSize() const { return bufferSize_; }
+
+private:
+    struct Buffer {
+        char* data = nullptr;
+        size_t size = 0;
+    };
+
+    void submitCurrent();
+    void writerLoop();
+
+    const size_t bufferSize_;
+    std::vector<char*> allocations_;
+    Buffer current_;
+
+    std::FILE* file_ = nullptr;
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable queued_;    // Writer waits for full buffers
+    std::condition_variable released_;  // Caller waits for empty buffers
+    std::deque<Buffer> full_;
+    std::vector<char*> free_;
+    bool closing_ = false;
+
+    std::atomic<bool> failed_{false};
+    std::atomic<uint64_t> bytesWritten_{0};
+};
+
+} // namespace data
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <istream>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace data {
+
+enum class Compression {
+    None,
+    Gzip,
+    Zstd
+};
+
+// Detect the compression format of a file from its magic bytes
+Compression detectCompression(const std::string& filename);
+
+// Stream buffer that decompresses a file on a background thread.
+// Decompressed chunks are handed over through a small bounded queue, so
+// decompression of the next chunk overlaps with parsing of the current one.
+// A corrupt or truncated file makes underflow throw once the data decoded
+// before the error is used up, which sets badbit on the reading stream.
+class DecompressingStreamBuf : public std::streambuf {
+public:
+    DecompressingStreamBuf(const std::string& filename, Compression compression);
+    ~DecompressingStreamBuf() override;
+
+    DecompressingStreamBuf(const DecompressingStreamBuf&) = delete;
+    DecompressingStreamBuf& operator=(const DecompressingStreamBuf&) = delete;
+
+    // Check if the file was opened and decompression has not failed
+    bool isValid() const { return !failed_; }
+
+    // Bytes of the compressed file consumed so far (runs slightly ahead of the reader)
+    uint64_t getCompressedBytesRead() const { return compressedRead_; }
+
+protected:
+    int_type underflow() override;
+
+private:
+    void decompressLoop();
+    bool decompressGzip();
+    bool decompressZstd();
+    bool pushChunk(std::vector<char> chunk);
+
+    std::ifstream file_;
+    Compression compression_;
+    std::thread worker_;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::deque<std::vector<char>> chunks_;
+    bool finished_ = false;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<uint64_t> compressedRead_{0};
+
+    std::vector<char> current_;
+};
+
+// Input stream over a compressed file; owns its DecompressingStreamBuf
+class DecompressingStream : public std::istream {
+public:
+    DecompressingStream(const std::string& filename, Compression compression);
+
+    bool isValid() const { return buffer_.isValid(); }
+    uint64_t getCompressedBytesRead() const { return buffer_.getCompressedBytesRead(); }
+
+private:
+    DecompressingStreamBuf buffer_;
+};
+
+// Open a log file for reading. Gzip and zstd files are detected by their
+// magic bytes and decompressed transparently; anything else is opened as-is.
+// Returns nullptr if the file cannot be opened.
+std::unique_ptr<std::istream> openLogStream(const std::string& filename,
+                                            std::ios::openmode mode = std::ios::in);
+
+// Bytes of the underlying file consumed by a stream from openLogStream, for
+// progress reporting against the file size
+uint64_t logStreamBytesRead(std::istream& stream);
+
+} // namespace data
@@ -5,13 +5,26 @@
 #include <functional>
 #include <memory>
 #include <chrono>
+#include <map>
+#include <cstdint>
+#include "FieldRegistry.hpp"
+#include "SampleBatch.hpp"
 
 namespace data {
 
+// One sample. Samples carry no name; fieldId resolves to one through the
+// source's FieldRegistry (getFieldRegistry().name(fieldId)).
 struct DataPoint {
     std::chrono::system_clock::time_point timestamp;
     double value;
-    std::string field;
+    FieldId fieldId = kInvalidFieldId;
+};
+
+// All samples of one field, as parallel columns
+struct FieldColumn {
+    std::string type;                    // Source type name, e.g. "double" or "int64"
+    std::vector<int64_t> timestampsUs;   // Microseconds since the epoch
+    std::vector<double> values;
 };
 
 class DataSource {
@@ -36,14 +49,81 @@ public:
     // Unsubscribe from a field
     virtual void unsubscribe(const std::string& field) = 0;
     
-    // Set callback for new data
-    virtual void setDataCallback(std::function<void(const DataPoint&)> callback) = 0;
+    // Set callback for new data, called once per sample. This is an adapter
+    // over the batch callback; prefer setBatchCallback for high-rate sources.
+    virtual void setDataCallback(std::function<void(const DataPoint&)> callback) {
+        if (!callback) {
+            setBatchCallback(nullptr);
+            return;
+        }
+        setBatchCallback([this, callback = std::move(callback)](const std::vector<DataBatch>& batches) {
+            DataPoint point;
+            for (const auto& batch : batches) {
+                point.fieldId = batch.field;
+                for (size_t i = 0; i < batch.count; ++i) {
+                    point.timestamp = std::chrono::system_clock::time_point(
+                        std::chrono::microseconds(batch.timestampsUs[i]));
+                    point.value = batch.values[i];
+                    callback(point);
+                }
+            }
+        });
+    }
+
+    // Set callback for new data, called once per flush with one contiguous
+    // (timestamp[], value[]) span per field
+    virtual void setBatchCallback(BatchCallback callback) {
+        batchCallback_ = std::move(callback);
+    }
+
+    // Get the interned id of a field name; ids are stable for the source's lifetime
+    FieldId getFieldId(const std::string& field) const { return fieldRegistry_.intern(field); }
+
+    // Get the name registry used to resolve DataBatch::field
+    const FieldRegistry& getFieldRegistry() const { return fieldRegistry_; }
     
     // Get historical data for a field
     virtual std::vector<DataPoint> getHistoricalData(
         const std::string& field,
         std::chrono::system_clock::time_point start,
         std::chrono::system_clock::time_point end) const = 0;
+
+    // Get historical data for several fields at once. The default makes one
+    // getHistoricalData call per field; sources that can do better override it.
+    virtual std::map<std::string, FieldColumn> getHistoricalColumns(
+        const std::vector<std::string>& fields,
+        std::chrono::system_clock::time_point start,
+        std::chrono::system_clock::time_point end) const {
+        std::map<std::string, FieldColumn> columns;
+        for (const auto& field : fields) {
+            auto points = getHistoricalData(field, start, end);
+            if (points.empty()) {
+                continue;
+            }
+            auto& column = columns[field];
+            column.timestampsUs.reserve(points.size());
+            column.values.reserve(points.size());
+            for (const auto& point : points) {
+                column.timestampsUs.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                    point.timestamp.time_since_epoch()).count());
+                column.values.push_back(point.value);
+            }
+        }
+        return columns;
+    }
+
+    // Get the whole history of several fields at once
+    std::map<std::string, FieldColumn> getHistoricalColumns(const std::vector<std::string>& fields) const {
+        return getHistoricalColumns(fields, std::chrono::system_clock::time_point::min(),
+                                    std::chrono::system_clock::time_point::max());
+    }
+
+protected:
+    // Hand the buffered samples to the batch callback
+    void publish(SampleBatcher& batcher) { batcher.flush(batchCallback_); }
+
+    mutable FieldRegistry fieldRegistry_;  // Interning does not change the source's state
+    BatchCallback batchCallback_;
 };
 
 } // namespace data 
\ No newline at end of file
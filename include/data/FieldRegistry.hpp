@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+#include <limits>
+
+namespace data {
+
+// Integer handle of an interned field name
+using FieldId = uint32_t;
+constexpr FieldId kInvalidFieldId = std::numeric_limits<FieldId>::max();
+
+// Interns field names into dense integer ids, so per-sample paths carry an id
+// instead of a string. Ids are never reused and names stay valid for the
+// registry's lifetime. Safe to use from several threads.
+class FieldRegistry {
+public:
+    // Get the id of a name, assigning the next free id on first use
+    FieldId intern(const std::string& name);
+
+    // Get the id of a name, or kInvalidFieldId if it was never interned
+    FieldId find(const std::string& name) const;
+
+    // Get the name of an id; empty for unknown ids
+    const std::string& name(FieldId id) const;
+
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, FieldId> ids_;
+    std::deque<std::string> names_;  // Deque keeps references stable while growing
+};
+
+} // namespace data
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace data {
+
+// Multi-resolution min/max/mean summary of a time series, used to draw huge
+// columns at screen resolution. Level k summarizes buckets of 8 << k samples;
+// each level is half the size of the one below, so the pyramid costs about
+// 6 bytes per sample on top of the samples themselves.
+//
+// The pyramid does not own the samples: every call takes the series it was
+// built from, which may only grow between calls (see update).
+class MinMaxPyramid {
+public:
+    // Summary of the samples [begin, begin + count)
+    struct Bucket {
+        size_t begin = 0;
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        bool minFirst = true;  // The minimum occurs before the maximum
+    };
+
+    // Summarize a whole series, replacing any previous state
+    void build(const std::vector<double>& values);
+
+    // Summarize samples appended since the last build/update; only the
+    // trailing bucket of every level is recomputed
+    void update(const std::vector<double>& values);
+
+    void clear();
+
+    // Number of samples summarized so far
+    size_t size() const { return summarized_; }
+
+    // Summaries covering [begin, end) with at most about maxBuckets buckets.
+    // Zoomed in far enough, every bucket is a single raw sample.
+    void query(const std::vector<double>& values, size_t begin, size_t end, size_t maxBuckets,
+               std::vector<Bucket>& out) const;
+
+    // Line vertices for plotting the sample index range [xBegin, xEnd) across
+    // pixels columns: the min and max of every bucket in the order they
+    // occurred, so at most about two points per pixel
+    void queryLine(const std::vector<double>& values, double xBegin, double xEnd, size_t pixels,
+                   std::vector<double>& xs, std::vector<double>& ys) const;
+
+private:
+    struct Level {
+        std::vector<double> min;
+        std::vector<double> max;
+        std::vector<double> sum;
+        std::vector<uint8_t> minFirst;
+
+        void resize(size_t buckets);
+    };
+
+    static constexpr size_t kBaseShift = 3;  // Finest level summarizes 8 samples
+
+    void summarizeBase(const std::vector<double>& values, size_t firstBucket);
+    void summarizeLevel(size_t level, size_t firstBucket);
+
+    std::vector<Level> levels_;
+    size_t summarized_ = 0;
+};
+
+} // namespace data
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace data {
+
+// Threads to use for a requested count; 0 means one per hardware thread
+inline size_t workerThreadCount(size_t requested = 0) {
+    return requested > 0 ? requested : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Call fn(task, worker) for every task in [0, taskCount) on up to threadCount
+// threads and return once all are done. The calling thread is worker 0, so a
+// count of one spawns nothing. Workers take the next task as they finish one,
+// so tasks may differ in cost; worker < threadCount can index per-thread state.
+template <typename Fn>
+void parallelFor(size_t taskCount, size_t threadCount, Fn&& fn) {
+    threadCount = std::min(threadCount, taskCount);
+    if (threadCount <= 1) {
+        for (size_t task = 0; task < taskCount; ++task) {
+            fn(task, size_t{0});
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextTask{0};
+    auto work = [&](size_t worker) {
+        for (size_t task = nextTask++; task < taskCount; task = nextTask++) {
+            fn(task, worker);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (size_t worker = 1; worker < threadCount; ++worker) {
+        workers.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+} // namespace data
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "FieldRegistry.hpp"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace data {
+
+// Contiguous samples of one field. The pointers are only valid during the
+// callback that receives the batch.
+struct DataBatch {
+    FieldId field = kInvalidFieldId;
+    const int64_t* timestampsUs = nullptr;  // Microseconds since the epoch
+    const double* values = nullptr;
+    size_t count = 0;
+};
+
+// Receives one span per field for every flush
+using BatchCallback = std::function<void(const std::vector<DataBatch>& batches)>;
+
+// Buffers samples per field id and hands them out as spans. Buffers keep
+// their capacity between flushes, so steady-state batching does not allocate.
+class SampleBatcher {
+public:
+    void add(FieldId field, int64_t timestampUs, double value) {
+        Column& column = columnFor(field);
+        column.timestamps.push_back(timestampUs);
+        column.values.push_back(value);
+        ++pending_;
+    }
+
+    void add(FieldId field, const int64_t* timestampsUs, const double* values, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        Column& column = columnFor(field);
+        column.timestamps.insert(column.timestamps.end(), timestampsUs, timestampsUs + count);
+        column.values.insert(column.values.end(), values, values + count);
+        pending_ += count;
+    }
+
+    // Number of samples buffered since the last flush
+    size_t pending() const { return pending_; }
+
+    // Deliver the buffered samples, one span per field in first-seen order,
+    // and clear the buffers. Samples are dropped if the callback is empty.
+    void flush(const BatchCallback& callback) {
+        if (pending_ == 0) {
+            return;
+        }
+        if (callback) {
+            batches_.clear();
+            for (FieldId field : active_) {
+                const Column& column = columns_[field];
+                batches_.push_back({field, column.timestamps.data(), column.values.data(), column.values.size()});
+            }
+            callback(batches_);
+        }
+        clear();
+    }
+
+    void clear() {
+        for (FieldId field : active_) {
+            columns_[field].timestamps.clear();
+            columns_[field].values.clear();
+        }
+        active_.clear();
+        pending_ = 0;
+    }
+
+private:
+    struct Column {
+        std::vector<int64_t> timestamps;
+        std::vector<double> values;
+    };
+
+    Column& columnFor(FieldId field) {
+        if (field >= columns_.size()) {
+            columns_.resize(field + 1);
+        }
+        Column& column = columns_[field];
+        if (column.values.empty()) {
+            active_.push_back(field);
+        }
+        return column;
+    }
+
+    std::vector<Column> columns_;  // Indexed by field id
+    std::vector<FieldId> active_;  // Fields with pending samples
+    std::vector<DataBatch> batches_;
+    size_t pending_ = 0;
+};
+
+} // namespace data
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+namespace data {
+
+// Fixed-capacity single-producer/single-consumer ring buffer. push and pop
+// never lock or allocate; each side caches the other side's index so it only
+// touches the shared cache line when the buffer looks full or empty.
+template <typename T>
+class SpscRingBuffer {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRingBuffer(size_t capacity)
+        : slots_(roundUpPowerOfTwo(capacity)), mask_(slots_.size() - 1) {}
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side; returns false if the buffer is full, leaving value untouched
+    template <typename U>
+    bool tryPush(U&& value) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == slots_.size()) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == slots_.size()) {
+                return false;
+            }
+        }
+        slots_[head & mask_] = std::forward<U>(value);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side; pushes as many values as fit and returns how many
+    size_t push(const T* values, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t space = slots_.size() - (head - cachedTail_);
+        if (space < count) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            space = slots_.size() - (head - cachedTail_);
+        }
+        const size_t pushed = count < space ? count : space;
+        for (size_t i = 0; i < pushed; ++i) {
+            slots_[(head + i) & mask_] = values[i];
+        }
+        head_.store(head + pushed, std::memory_order_release);
+        return pushed;
+    }
+
+    // Consumer side; returns false if the buffer is empty
+    bool tryPop(T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (cachedHead_ == tail) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (cachedHead_ == tail) {
+                return false;
+            }
+        }
+        value = std::move(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; pops up to maxCount values into out and returns how many
+    size_t pop(T* out, size_t maxCount) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t available = cachedHead_ - tail;
+        if (available < maxCount) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            available = cachedHead_ - tail;
+        }
+        const size_t popped = maxCount < available ? maxCount : available;
+        for (size_t i = 0; i < popped; ++i) {
+            out[i] = std::move(slots_[(tail + i) & mask_]);
+        }
+        tail_.store(tail + popped, std::memory_order_release);
+        return popped;
+    }
+
+    // Consumer side; drops up to maxCount values without reading them and returns how many
+    size_t discard(size_t maxCount) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        const size_t available = cachedHead_ - tail;
+        const size_t dropped = maxCount < available ? maxCount : available;
+        tail_.store(tail + dropped, std::memory_order_release);
+        return dropped;
+    }
+
+    // Approximate when called concurrently with the other side
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::vector<T> slots_;
+    const size_t mask_;
+
+    // Producer and consumer state live on separate cache lines
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
+
+} // namespace data
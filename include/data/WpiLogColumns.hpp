@@ -0,0 +1,70 @@
+#pragma once
+
+#include "WpiLogReader.hpp"
+#include "ParallelFor.hpp"
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <limits>
+
+namespace data {
+
+// One scalar entry decoded to columns, sorted by timestamp
+struct ScalarColumn {
+    std::vector<int64_t> timestamps;
+    std::vector<double> values;
+};
+
+// Decoded columns are keyed by the entry definition their records were
+// written under (EntryInfo::startOffset, see WpiLogReader::getEntryAt), so an
+// entry id that was restarted with another name or type gives one column per
+// definition
+using ScalarColumns = std::unordered_map<uint64_t, ScalarColumn>;
+
+// Array and struct entries decoded to one column per slot (element or member),
+// see wpilog::compositeSlotName for the slot naming
+using CompositeColumns = std::unordered_map<uint64_t, std::vector<ScalarColumn>>;
+using CompositeLayouts = std::unordered_map<uint64_t, wpilog::CompositeLayout>;
+
+// Layouts of the array and struct definitions known to the reader, keyed like
+// the columns. Definitions whose struct schema is missing are left out.
+CompositeLayouts buildCompositeLayouts(const WpiLogReader& reader);
+
+// Number of decode threads worth using for a log of the given size
+unsigned decodeThreadCount(uint64_t bytes);
+
+// Run fn(segment, begin, end) for every segment produced by
+// WpiLogReader::splitSegments, one thread per segment
+template <typename Fn>
+void forEachSegmentParallel(const std::vector<uint64_t>& boundaries, Fn&& fn) {
+    if (boundaries.size() < 2) {
+        return;
+    }
+    const size_t segmentCount = boundaries.size() - 1;
+    parallelFor(segmentCount, segmentCount, [&](size_t i, size_t) { fn(i, boundaries[i], boundaries[i + 1]); });
+}
+
+// Restore timestamp order of a column whose segments were concatenated.
+// Order within equal timestamps is kept (stable).
+void sortColumnByTimestamp(ScalarColumn& column);
+
+// Decode the records between consecutive boundaries (record start offsets,
+// followed by the end offset) in parallel, keeping only the given entries
+// (all if empty) with timestamps in [startUs, endUs]. If composites is given,
+// array and struct entries are decoded into it in the same pass.
+ScalarColumns decodeScalarColumns(const WpiLogReader& reader,
+                                  const std::vector<uint64_t>& boundaries,
+                                  const std::unordered_set<uint32_t>& entries,
+                                  int64_t startUs, int64_t endUs,
+                                  CompositeColumns* composites = nullptr);
+
+// Decode scalar entries of the whole log in parallel. The record stream is
+// split on record boundaries, each segment is decoded into per-entry column
+// builders on its own thread, and the builders are merged in timestamp order.
+// If entries is non-empty only those entry ids are decoded.
+ScalarColumns decodeScalarColumns(WpiLogReader& reader,
+                                  const std::unordered_set<uint32_t>& entries = {},
+                                  CompositeColumns* composites = nullptr);
+
+} // namespace data
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace data {
+namespace wpilog {
+
+// Scalar kinds that can appear inside array and struct payloads
+enum class ElementKind {
+    Boolean,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double
+};
+
+// One scalar member of a flattened struct; path is empty for plain arrays
+struct CompositeMember {
+    std::string path;
+    uint32_t offset = 0;
+    ElementKind kind = ElementKind::Double;
+};
+
+// Layout of an array or struct entry, flattened to scalar members.
+// Payloads are a sequence of elements of elementSize bytes; a plain struct
+// has exactly one element, arrays have as many as fit in the payload.
+struct CompositeLayout {
+    bool isArray = false;
+    uint32_t elementSize = 0;
+    std::vector<CompositeMember> members;
+
+    bool isValid() const { return elementSize > 0 && !members.empty(); }
+};
+
+// Struct schemas keyed by type name, e.g. "struct:Pose2d" -> "Translation2d translation;Rotation2d rotation"
+using StructSchemas = std::unordered_map<std::string, std::string>;
+
+// Prefix of the entries that carry struct schemas
+constexpr const char* kStructSchemaPrefix = "/.schema/";
+
+// Build the layout for "boolean[]", "int64[]", "float[]", "double[]",
+// "struct:Name" or "struct:Name[]"; returns false for other types or if a
+// schema is missing or uses unsupported features (bit-fields)
+bool buildCompositeLayout(const std::string& type, const StructSchemas& schemas, CompositeLayout& layout);
+
+// Number of scalar slots in a payload of the given size
+size_t compositeSlotCount(const CompositeLayout& layout, size_t payloadSize);
+
+// Field name suffix of a slot: "[i]" for arrays, "/member" for structs and
+// "[i]/member" for arrays of structs
+std::string compositeSlotName(const CompositeLayout& layout, size_t slot);
+
+// Decode every slot of a payload into out, which is resized to the slot count.
+// Plain arrays are converted with memcpy and straight-line loops the compiler
+// can vectorize; struct members are gathered with a fixed stride.
+size_t decodeComposite(const CompositeLayout& layout, const uint8_t* payload, size_t size, std::vector<double>& out);
+
+// Decode a single slot; returns false if the payload is too short
+bool decodeCompositeSlot(const CompositeLayout& layout, const uint8_t* payload, size_t size, size_t slot, double& value);
+
+} // namespace wpilog
+} // namespace data
@@ -1,18 +1,33 @@
 #pragma once
 
-#include "DataSource.h"
+#include "DataSource.hpp"
+#include "WpiLogReader.hpp"
 #include <memory>
 #include <string>
 #include <map>
-#include <set>
+#include <unordered_map>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <limits>
 
 namespace data {
 
+// Replay settings for WpiLogDataSource::startReplay
+struct ReplayOptions {
+    double speed = 1.0;      // 1 = real time, N = N times faster, <= 0 = as fast as possible
+    int64_t sliceUs = 20000; // Samples are delivered in batches covering this much log time
+    bool loop = false;       // Restart at the beginning when the end of the log is reached
+    int64_t startUs = std::numeric_limits<int64_t>::min();  // Log time to start at, clamped to the log
+};
+
 class WpiLogDataSource : public DataSource {
 public:
     explicit WpiLogDataSource(const std::string& filename);
-    
+    ~WpiLogDataSource() override;
+
     // DataSource interface implementation
     bool connect() override;
     void disconnect() override;
@@ -20,19 +35,93 @@ public:
     std::vector<std::string> getAvailableFields() const override;
     bool subscribe(const std::string& field) override;
     void unsubscribe(const std::string& field) override;
-    void setDataCallback(std::function<void(const DataPoint&)> callback) override;
     std::vector<DataPoint> getHistoricalData(
         const std::string& field,
         std::chrono::system_clock::time_point start,
         std::chrono::system_clock::time_point end) const override;
 
+    // Extracts all requested fields in one pass over the covering byte range
+    std::map<std::string, FieldColumn> getHistoricalColumns(
+        const std::vector<std::string>& fields,
+        std::chrono::system_clock::time_point start,
+        std::chrono::system_clock::time_point end) const override;
+    using DataSource::getHistoricalColumns;
+
+    // Play the subscribed fields in timestamp order to the batch callback on a
+    // background thread, one batch per time slice. Set the callbacks before
+    // starting; subscriptions may change while playing.
+    bool startReplay(const ReplayOptions& options = ReplayOptions());
+    void stopReplay();
+    bool isReplaying() const { return replayRunning_; }
+
+    // Continue the replay from the given log time (microseconds)
+    void seekReplay(int64_t timestampUs);
+
+    // Log time up to which samples have been delivered
+    int64_t getReplayPosition() const { return replayPosition_; }
+
+    // Time range covered by the log, in microseconds
+    int64_t getStartTime() const { return startTimeUs_; }
+    int64_t getEndTime() const { return endTimeUs_; }
+
 private:
+    // Per-field record index built by connect(); timestamps are sorted. The
+    // int keys used below are index ids, one per field name and type, not
+    // wpilog entry ids.
+    struct EntryIndex {
+        std::string type;
+        wpilog::ScalarType scalarType = wpilog::ScalarType::Unknown;
+        wpilog::CompositeLayout layout;  // Valid for array and struct entries
+        std::vector<int64_t> timestamps;
+        std::vector<uint64_t> offsets;  // Record offsets in the file
+        std::vector<uint32_t> logEntries;  // wpilog entry ids with a definition filed here
+    };
+
+    // Element of an array entry or member of a struct entry, exposed as a field
+    struct SlotField {
+        int entry = -1;
+        size_t slot = 0;
+    };
+
+    // Subscribed field being replayed, with its read position in the index
+    struct ReplayTrack {
+        const EntryIndex* entry = nullptr;
+        bool isSlot = false;
+        size_t slot = 0;
+        FieldId field = kInvalidFieldId;
+        size_t cursor = 0;
+    };
+
+    bool buildIndex();
+    void replayLoop(ReplayOptions options);
+    std::vector<ReplayTrack> snapshotTracks(int64_t positionUs);
+    void addSlotFields(int entryId, EntryIndex& entry);
+    int findEntry(const std::string& field) const;
+    const SlotField* findSlotField(const std::string& field) const;
+
     std::string filename_;
     bool connected_;
-    std::unique_ptr<wpigui::DataLogReader> reader_;
+    WpiLogReader reader_;
     std::map<int, std::string> entries_;
-    std::set<int> subscribedEntries_;
-    std::function<void(const DataPoint&)> dataCallback_;
+    std::unordered_map<std::string, int> entryIds_;
+    std::unordered_map<int, EntryIndex> index_;
+    std::unordered_map<uint64_t, int> definitionIds_;  // Entry definition (start offset) -> index id
+    std::vector<std::string> slotFieldNames_;  // In entry and slot order
+    std::unordered_map<std::string, SlotField> slotFields_;
+    std::map<int, FieldId> subscribedEntries_;
+    std::map<std::pair<int, size_t>, FieldId> subscribedSlots_;
+    int64_t startTimeUs_ = 0;
+    int64_t endTimeUs_ = 0;
+
+    // Replay state; subscriptions are guarded by replayMutex_ while playing
+    std::thread replayThread_;
+    mutable std::mutex replayMutex_;
+    std::condition_variable replayWake_;
+    std::atomic<bool> replayRunning_{false};
+    std::atomic<int64_t> replayPosition_{0};
+    int64_t seekRequest_ = 0;
+    bool seekPending_ = false;
+    bool subscriptionsChanged_ = false;
 };
 
-} // namespace data 
\ No newline at end of file
+} // namespace data
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace data {
+namespace wpilog {
+
+// Entry id 0 carries control records (start, finish, set metadata)
+constexpr uint32_t kControlEntry = 0;
+
+// File header: "WPILOG", uint16 version, uint32 extra header length, extra header
+constexpr size_t kFileHeaderSize = 12;
+
+// Largest possible record header: 1 byte lengths, 4 byte entry, 4 byte size, 8 byte timestamp
+constexpr size_t kMaxRecordHeaderSize = 17;
+
+enum class ControlType : uint8_t {
+    Start = 0,
+    Finish = 1,
+    SetMetadata = 2
+};
+
+// Scalar payload types that can be decoded to double
+enum class ScalarType {
+    Unknown,
+    Boolean,
+    Int64,
+    Float,
+    Double
+};
+
+struct RecordHeader {
+    uint32_t entry = 0;
+    uint32_t payloadSize = 0;
+    int64_t timestamp = 0;
+    size_t headerSize = 0;  // Bytes before the payload
+};
+
+struct StartRecord {
+    uint32_t entry = 0;
+    std::string name;
+    std::string type;
+    std::string metadata;
+};
+
+// Read an unsigned little-endian integer of 1-8 bytes
+inline uint64_t readLittleEndian(const uint8_t* data, size_t length) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < length; ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Write an unsigned integer as length little-endian bytes
+inline void writeLittleEndian(uint8_t* out, uint64_t value, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Size of the record header given its first byte
+inline size_t recordHeaderSize(uint8_t lengthBits) {
+    return 1 + ((lengthBits & 0x3) + 1) + (((lengthBits >> 2) & 0x3) + 1) + (((lengthBits >> 4) & 0x7) + 1);
+}
+
+// Validate the file header; on success sets the offset of the first record
+bool parseFileHeader(const uint8_t* data, size_t size, size_t& firstRecordOffset);
+
+// Parse the variable-length record header; returns false if it is truncated
+bool parseRecordHeader(const uint8_t* data, size_t available, RecordHeader& header);
+
+// Parse the payload of a control record of type Start
+bool parseStartRecord(const uint8_t* payload, size_t size, StartRecord& record);
+
+// Parse the entry id of a Finish or SetMetadata control record
+bool parseControlEntry(const uint8_t* payload, size_t size, uint32_t& entry);
+
+// Map a wpilog type string to the scalar type it decodes to
+ScalarType scalarTypeFromString(const std::string& type);
+
+// Decode a scalar payload to double; returns false if the size does not match
+bool decodeScalar(ScalarType type, const uint8_t* payload, size_t size, double& value);
+
+// Encode the file header (version 1.0) with the given extra header
+std::string encodeFileHeader(const std::string& extraHeader = std::string());
+
+// Encode a record header into out (at least kMaxRecordHeaderSize bytes),
+// using the fewest bytes per field; returns the header size
+size_t encodeRecordHeader(uint8_t* out, uint32_t entry, uint32_t payloadSize, int64_t timestamp);
+
+// Encode a complete Start control record
+std::string encodeStartRecord(const StartRecord& record, int64_t timestamp);
+
+// Encode a complete record with a double payload into out
+// (at least kMaxRecordHeaderSize + 8 bytes); returns the record size
+size_t encodeDoubleRecord(uint8_t* out, uint32_t entry, int64_t timestamp, double value);
+
+} // namespace wpilog
+} // namespace data
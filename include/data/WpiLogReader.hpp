@@ -0,0 +1,131 @@
+#pragma once
+
+#include "WpiLogFormat.hpp"
+#include "WpiLogComposite.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace data {
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return opened_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool opened_ = false;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+namespace wpilog {
+
+// Lightweight view of one record; the payload points into the mapping
+struct RecordView {
+    uint32_t entry = 0;
+    int64_t timestamp = 0;
+    const uint8_t* payload = nullptr;
+    uint32_t size = 0;
+    uint64_t offset = 0;  // Offset of the record header in the file
+
+    bool isControl() const { return entry == kControlEntry; }
+};
+
+// Entry description collected from start and metadata control records. An
+// entry id may be finished and started again; each start record begins a new
+// definition, identified by startOffset.
+struct EntryInfo {
+    uint32_t entry = 0;
+    std::string name;
+    std::string type;
+    std::string metadata;
+    ScalarType scalarType = ScalarType::Unknown;
+    bool active = true;  // False once a finish record was seen
+    uint64_t startOffset = 0;  // Offset of the start record
+};
+
+} // namespace wpilog
+
+// Native wpilog reader. The file is memory-mapped and records are iterated as
+// views without copying; control records are applied to the entry table as
+// they are read. Compressed logs are decompressed into memory instead.
+class WpiLogReader {
+public:
+    WpiLogReader() = default;
+
+    bool open(const std::string& filename);
+    void close();
+    bool isValid() const { return valid_; }
+
+    // Restart iteration at the first record
+    void reset() { cursor_ = firstRecordOffset_; }
+
+    // Read the next record; control records update the entry table and are
+    // returned too. Returns false at the end of the file or on a truncated record.
+    bool next(wpilog::RecordView& record);
+
+    // Decode the record whose header starts at offset (from RecordView::offset)
+    bool recordAt(uint64_t offset, wpilog::RecordView& record) const;
+
+    // Walk all record headers once, applying control records, and split the
+    // record stream into at most segmentCount byte ranges on record boundaries.
+    // Returns the segment start offsets followed by the end offset.
+    std::vector<uint64_t> splitSegments(size_t segmentCount);
+
+    // Entries seen so far, keyed by entry id
+    const std::unordered_map<uint32_t, wpilog::EntryInfo>& getEntries() const { return entries_; }
+    const wpilog::EntryInfo* getEntry(uint32_t entry) const;
+
+    // Definition in effect for the record at offset. An entry id may be
+    // finished and started again with another name or type; the earlier
+    // definitions are kept so that parallel segments decode every record with
+    // its own. Returns null for records before the entry's first start.
+    const wpilog::EntryInfo* getEntryAt(uint32_t entry, uint64_t offset) const;
+
+    // Every definition seen so far, superseded ones included, in file order
+    std::vector<const wpilog::EntryInfo*> getDefinitions() const;
+
+    // Struct schemas published in the log so far, keyed by type name ("struct:Name")
+    const wpilog::StructSchemas& getStructSchemas() const { return structSchemas_; }
+
+    // Raw bytes, for callers that split the record stream themselves
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    uint64_t getFirstRecordOffset() const { return firstRecordOffset_; }
+    uint64_t getPosition() const { return cursor_; }  // Offset of the record next() reads
+
+private:
+    void applyControlRecord(const wpilog::RecordView& record);
+    void captureStructSchema(const wpilog::RecordView& record);
+
+    MappedFile mapping_;
+    std::vector<uint8_t> decompressed_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    uint64_t firstRecordOffset_ = 0;
+    uint64_t cursor_ = 0;
+    bool valid_ = false;
+    std::unordered_map<uint32_t, wpilog::EntryInfo> entries_;
+    std::unordered_map<uint32_t, std::vector<wpilog::EntryInfo>> earlierEntries_;  // Superseded definitions, in file order
+    std::unordered_map<uint32_t, std::string> schemaEntries_;  // Entry id -> schema type name
+    wpilog::StructSchemas structSchemas_;
+};
+
+} // namespace data
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AsyncFileWriter.hpp"
+#include "SpscRingBuffer.hpp"
+
+namespace data {
+
+// Records live double streams to a wpilog file. Producers push into
+// per-channel bounded rings and never wait: when a ring is full the record
+// is dropped and counted. A dedicated I/O thread drains the rings in
+// batches, encodes the records and flushes the file periodically.
+class WpiLogRecorder {
+public:
+    // Microsecond timestamps; records from different channels should share a clock
+    using Clock = std::function<int64_t()>;
+
+    struct Record {
+        int64_t timestampUs = 0;
+        double value = 0.0;
+    };
+
+    // One wpilog entry. Each channel accepts records from a single producer thread.
+    class Channel {
+    public:
+        Channel(const std::string& name, uint32_t entry, size_t capacity, Clock clock);
+
+        // Returns false if the record was dropped (full, or not recording)
+        bool record(int64_t timestampUs, double value);
+
+        // Record a block of samples stamped with the current clock time
+        size_t recordBlock(const double* values, size_t count);
+
+        const std::string& getName() const { return name_; }
+        uint32_t getEntry() const { return entry_; }
+        uint64_t getDroppedRecords() const { return dropped_.load(std::memory_order_relaxed); }
+        uint64_t getWrittenRecords() const { return written_.load(std::memory_order_relaxed); }
+
+    private:
+        friend class WpiLogRecorder;
+
+        const std::string name_;
+        const uint32_t entry_;
+        const Clock clock_;
+        SpscRingBuffer<Record> records_;
+        std::atomic<bool> active_{false};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> written_{0};
+        bool started_ = false;  // I/O thread only; Start record written
+    };
+
+    // Without a clock, steady_clock time since the epoch is used
+    explicit WpiLogRecorder(Clock clock = Clock(), size_t channelCapacity = 1 << 14,
+                            std::chrono::milliseconds flushPeriod = std::chrono::milliseconds(250));
+    ~WpiLogRecorder();
+
+    WpiLogRecorder(const WpiLogRecorder&) = delete;
+    WpiLogRecorder& operator=(const WpiLogRecorder&) = delete;
+
+    // Create the file and start the I/O thread
+    bool open(const std::string& filename);
+
+    // Write everything still queued and close the file
+    bool close();
+
+    // Add an entry of type double; may be called before or while recording
+    std::shared_ptr<Channel> addChannel(const std::string& name);
+
+    // Check if an entry of this name was added to the file
+    bool hasChannel(const std::string& name) const;
+
+    bool isRecording() const { return recording_.load(); }
+    int64_t now() const { return clock_(); }
+
+    uint64_t getDroppedRecords() const;
+    uint64_t getWrittenRecords() const;
+    uint64_t getBytesWritten() const { return writer_.getBytesWritten(); }
+    bool hasFailed() const { return writer_.hasFailed(); }
+
+private:
+    void ioLoop();
+    size_t drainChannels(std::vector<std::shared_ptr<Channel>>& channels);
+
+    const Clock clock_;
+    const size_t channelCapacity_;
+    const std::chrono::milliseconds flushPeriod_;
+
+    AsyncFileWriter writer_;  // I/O thread while recording
+    std::thread ioThread_;
+    std::atomic<bool> recording_{false};
+
+    mutable std::mutex channelsMutex_;
+    std::vector<std::shared_ptr<Channel>> channels_;
+    uint64_t channelsVersion_ = 0;  // Bumped on every addChannel
+    std::condition_variable stopCondition_;
+    bool stopping_ = false;
+};
+
+} // namespace data
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "LogFileParser.hpp"
+
+namespace filter {
+
+// Loads log files on a background thread so the UI never blocks on I/O.
+// Requests for a file that is already queued or loading share one task, and
+// a task is only cancelled once every requester has cancelled it.
+class AsyncLogLoader {
+public:
+    enum class State {
+        Pending,
+        Loading,
+        Done,
+        Failed,
+        Cancelled
+    };
+
+    class Task {
+    public:
+        explicit Task(const std::string& filename) : filename_(filename) {}
+
+        const std::string& getFilename() const { return filename_; }
+        State getState() const { return state_; }
+        double getProgress() const { return progress_; }
+        bool isFinished() const;
+
+        // The loaded file once the state is Done, shared by every requester
+        std::shared_ptr<const LogFileParser> getResult() const;
+
+    private:
+        friend class AsyncLogLoader;
+
+        std::string filename_;
+        std::atomic<State> state_{State::Pending};
+        std::atomic<double> progress_{0.0};
+        std::atomic<int> requesters_{0};
+        std::atomic<bool> cancelled_{false};
+        mutable std::mutex resultMutex_;
+        std::shared_ptr<const LogFileParser> result_;
+    };
+
+    AsyncLogLoader();
+    ~AsyncLogLoader();
+
+    AsyncLogLoader(const AsyncLogLoader&) = delete;
+    AsyncLogLoader& operator=(const AsyncLogLoader&) = delete;
+
+    // Queue a file for loading, or join the pending request for it
+    std::shared_ptr<Task> load(const std::string& filename);
+
+    // Withdraw one request; the load stops once no requester is left
+    void cancel(const std::shared_ptr<Task>& task);
+
+    // Loader shared by all log file inputs
+    static AsyncLogLoader& shared();
+
+private:
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::shared_ptr<Task>> queue_;
+    std::unordered_map<std::string, std::weak_ptr<Task>> inFlight_;
+    std::thread worker_;
+    bool stopping_ = false;
+};
+
+} // namespace filter
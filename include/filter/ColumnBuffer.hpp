@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+namespace filter {
+
+// Reference-counted, immutable column of samples.
+// Copies share one allocation; mutableValues() clones only when the buffer is
+// shared with another owner (copy-on-write). A single ColumnBuffer object must
+// not be mutated concurrently from several threads.
+class ColumnBuffer {
+public:
+    ColumnBuffer() = default;
+    explicit ColumnBuffer(std::vector<double> values)
+        : data_(std::make_shared<std::vector<double>>(std::move(values))) {}
+
+    // Read-only access
+    const std::vector<double>& values() const { return data_ ? *data_ : emptyValues(); }
+    const double* data() const { return values().data(); }
+    size_t size() const { return data_ ? data_->size() : 0; }
+    bool empty() const { return size() == 0; }
+    double operator[](size_t index) const { return (*data_)[index]; }
+    std::vector<double>::const_iterator begin() const { return values().begin(); }
+    std::vector<double>::const_iterator end() const { return values().end(); }
+
+    // Writable access; detaches from other owners first
+    std::vector<double>& mutableValues() {
+        if (!data_) {
+            data_ = std::make_shared<std::vector<double>>();
+        } else if (data_.use_count() > 1) {
+            data_ = std::make_shared<std::vector<double>>(*data_);
+        }
+        return *data_;
+    }
+
+    // Number of owners sharing the allocation
+    long useCount() const { return data_.use_count(); }
+
+    // Check if two buffers share one allocation
+    bool sharesWith(const ColumnBuffer& other) const { return data_ && data_ == other.data_; }
+
+private:
+    static const std::vector<double>& emptyValues() {
+        static const std::vector<double> empty;
+        return empty;
+    }
+
+    std::shared_ptr<std::vector<double>> data_;
+};
+
+} // namespace filter
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Fft.hpp"
+
+namespace filter {
+
+// Best alignment of a signal against a reference. A positive lag means the
+// signal trails the reference: signal[t] ~ reference[t - lag].
+struct CorrelationPeak {
+    double time = 0.0;         // Seconds, middle of the correlated span
+    double lagSamples = 0.0;   // Interpolated between samples
+    double lagSeconds = 0.0;
+    double coefficient = 0.0;  // Normalized, -1 to 1
+    bool valid = false;
+};
+
+// Correlate two equal-length signals via FFT in O(n log n), searching lags
+// within +-maxLag samples (at most a quarter of the span). The signal
+// without maxLag samples at each end is matched against the reference, so
+// every lag compares the same samples. Means are removed first; NaN samples
+// count as the mean. If function is given it receives the normalized
+// correlation for lags -maxLag..maxLag.
+CorrelationPeak correlate(const double* reference, const double* signal, size_t count, size_t maxLag,
+                          double sampleRate, std::vector<double>* function = nullptr);
+
+struct CorrelationOptions {
+    double sampleRate = 50.0;
+    size_t maxLag = 250;         // Samples searched each way
+    size_t windowLength = 0;     // Sliding window in samples; 0 correlates everything
+    size_t hop = 0;              // Samples between windows or refreshes; 0 picks a default
+    size_t maxHistory = 4096;    // Sliding-window results kept
+    size_t threadCount = 0;      // 0 = one per hardware thread
+
+    size_t step() const;
+};
+
+// Lag between two streams fed in blocks, which may arrive at different
+// times. With no window, the whole signals are correlated again every hop
+// of new samples. With a window, every hop produces one lag for the last
+// windowLength samples, so lag can be tracked over time; large batches of
+// windows are split across threads.
+//
+// The append and reset methods are for one producer thread; the getters
+// may be called from any thread.
+class CrossCorrelator {
+public:
+    explicit CrossCorrelator(const CorrelationOptions& options = CorrelationOptions());
+
+    CrossCorrelator(const CrossCorrelator&) = delete;
+    CrossCorrelator& operator=(const CrossCorrelator&) = delete;
+
+    const CorrelationOptions& getOptions() const { return options_; }
+    bool isSliding() const { return options_.windowLength > 0; }
+
+    void appendReference(const double* data, size_t count);
+    void appendSignal(const double* data, size_t count);
+    void reset();
+
+    // Latest result: the whole signals, or the newest window
+    CorrelationPeak getPeak() const;
+
+    // Correlation for lags -maxLag..maxLag behind the latest result
+    void getFunction(std::vector<double>& lagsSeconds, std::vector<double>& values) const;
+
+    // Sliding-window results, oldest first
+    void getHistory(std::vector<double>& times, std::vector<double>& lagsSeconds, std::vector<double>& coefficients) const;
+
+    // Changes whenever a new result is available or the correlator is reset
+    uint64_t getRevision() const;
+
+private:
+    void update();
+    void updateWhole();
+    void updateSliding();
+    void publish(const CorrelationPeak& peak, std::vector<double>&& function);
+
+    CorrelationOptions options_;
+
+    // Producer side. Both streams are indexed from the first sample; the
+    // vectors start at consumed_.
+    std::vector<double> reference_;
+    std::vector<double> signal_;
+    uint64_t consumed_ = 0;
+    uint64_t nextWindow_ = 0;      // Start of the next sliding window
+    size_t correlatedLength_ = 0;  // Length of the last whole correlation
+
+    mutable std::mutex mutex_;  // Guards the state below
+    CorrelationPeak peak_;
+    std::vector<double> function_;
+    std::deque<CorrelationPeak> history_;
+    uint64_t revision_ = 0;
+};
+
+} // namespace filter
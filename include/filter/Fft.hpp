@@ -0,0 +1,57 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace filter {
+
+// FFT of real samples for one power-of-two size. A plan holds the twiddle
+// and bit-reversal tables and is immutable once built, so one plan can be
+// shared by any number of threads.
+class RealFft {
+public:
+    explicit RealFft(size_t size);
+
+    size_t size() const { return size_; }
+    size_t bins() const { return size_ / 2 + 1; }
+
+    // Transform size() samples into bins() values, DC through Nyquist.
+    // The output buffer doubles as the workspace, so no allocation happens.
+    void forward(const double* input, std::complex<double>* output) const;
+
+    // Transform bins() values back into size() samples, scaled so that
+    // inverse(forward(x)) == x. The spectrum is used as the workspace and
+    // does not survive the call.
+    void inverse(std::complex<double>* spectrum, double* output) const;
+
+    // Shared plan for a size, built on first use. Sizes are rounded up to a
+    // power of two of at least 4.
+    static std::shared_ptr<const RealFft> plan(size_t size);
+
+private:
+    // In-place complex FFT of size_ / 2 points
+    void transform(std::complex<double>* data) const;
+
+    size_t size_;
+    std::vector<std::complex<double>> twiddles_;      // Half-size complex FFT, by stage
+    std::vector<std::complex<double>> realTwiddles_;  // Splitting the packed result
+    std::vector<uint32_t> bitReverse_;
+};
+
+enum class WindowType {
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman
+};
+
+// Periodic window of a type and length, shared and built on first use
+std::shared_ptr<const std::vector<double>> makeWindow(WindowType type, size_t length);
+
+// Smallest power of two not below size
+size_t nextPowerOfTwo(size_t size);
+
+} // namespace filter
@@ -38,6 +38,12 @@ public:
     // Get filter type name
     virtual std::string getTypeName() const = 0;
 
+    // Independent copy, including the current filter state
+    virtual std::shared_ptr<Filter> clone() const = 0;
+
+    // Clear the state, as if no samples had been processed
+    virtual void reset() = 0;
+
     // Set filter parameters
     virtual void setParameter(const std::string& name, double value) = 0;
     virtual double getParameter(const std::string& name) const = 0;
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace filter {
+
+enum class DesignType {
+    FirstOrder,   // Single pole, like LowPassFilter; order is ignored
+    Butterworth,
+    Chebyshev     // Type I, with passband ripple
+};
+
+std::string designTypeName(DesignType type);
+
+// Parameters of one low-pass design
+struct DesignSpec {
+    DesignType type = DesignType::Butterworth;
+    int order = 2;
+    double cutoffFreq = 10.0;
+    double sampleRate = 100.0;
+    double ripple = 1.0;  // dB, Chebyshev only
+
+    bool operator<(const DesignSpec& other) const {
+        return std::tie(type, order, cutoffFreq, sampleRate, ripple) <
+               std::tie(other.type, other.order, other.cutoffFreq, other.sampleRate, other.ripple);
+    }
+};
+
+// Second-order section: H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+struct Biquad {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a1 = 0.0, a2 = 0.0;
+};
+
+// Bilinear-transform design as cascaded sections with unity DC gain
+// (Chebyshev of even order: the passband peak is unity). Sections are
+// numerically stable at high orders where one direct-form polynomial is not.
+std::vector<Biquad> designLowPass(const DesignSpec& spec);
+
+// Gain of the cascade at a frequency, as a ratio
+double magnitudeResponse(const std::vector<Biquad>& sections, double frequency, double sampleRate);
+
+// Runs a design over samples with state kept between calls
+class BiquadCascade {
+public:
+    BiquadCascade() = default;
+    explicit BiquadCascade(std::shared_ptr<const std::vector<Biquad>> sections);
+
+    // in and out may be the same buffer
+    void process(const double* in, double* out, size_t count);
+    void reset();
+
+    // Response to a unit step, for overshoot and settling checks
+    std::vector<double> stepResponse(size_t length) const;
+
+private:
+    struct State {
+        double z1 = 0.0, z2 = 0.0;
+    };
+
+    std::shared_ptr<const std::vector<Biquad>> sections_;
+    std::vector<State> state_;
+};
+
+// Designs keyed by their parameters, shared across sweeps and threads
+class DesignCache {
+public:
+    std::shared_ptr<const std::vector<Biquad>> get(const DesignSpec& spec);
+
+    size_t size() const;
+    size_t getHits() const;
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::map<DesignSpec, std::shared_ptr<const std::vector<Biquad>>> designs_;
+    size_t hits_ = 0;
+};
+
+} // namespace filter
@@ -7,77 +7,331 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
-#include <queue>
+#include <cstdint>
 #include <functional>
 #include <filesystem>
 #include "LogFileParser.hpp"
+#include "LogFileFollower.hpp"
+#include "AsyncLogLoader.hpp"
+#include "ColumnBuffer.hpp"
+#include "Resampler.hpp"
+#include "../data/WpiLogDataSource.hpp"
+#include "../data/SpscRingBuffer.hpp"
+#include "../data/WpiLogRecorder.hpp"
+#include <networktables/NetworkTableInstance.h>
+#include <networktables/GenericEntry.h>
+#include <condition_variable>
 #include <imgui.h>
 
 namespace filter {
 
+// One column of an input, as seen by the pipeline
+struct InputChannel {
+    std::string name;
+    ColumnBuffer data;
+};
+
 class InputNode {
 public:
     virtual ~InputNode() = default;
     virtual bool isConnected() const = 0;
     virtual std::vector<double> getData() const = 0;
+
+    // Shared, immutable view of the data; copies of the buffer share one allocation
+    virtual ColumnBuffer getBuffer() const { return ColumnBuffer(getData()); }
     virtual void start() = 0;
     virtual void stop() = 0;
+
+    // Drain samples that arrived since the last call (streaming mode).
+    // Appends at most maxSamples values to block and returns how many were added.
+    virtual size_t readBlock(std::vector<double>& block, size_t maxSamples) { return 0; }
+
+    // Sample times in microseconds matching getData(); empty if the source has none
+    virtual std::vector<int64_t> getTimestamps() const { return {}; }
+
+    // Whether samples carry times; decides between readTimestampedBlock and
+    // readBlock for the whole stream
+    virtual bool hasTimestamps() const { return false; }
+
+    // Same as readBlock, but also appends the time of each sample.
+    // Sources without timestamps return 0 and leave their samples to readBlock.
+    virtual size_t readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) { return 0; }
+
+    // Columns the pipeline processes separately; single-column inputs have one
+    virtual std::vector<InputChannel> getChannels() const { return {InputChannel{std::string(), getBuffer()}}; }
+
+    // Plot summary the source built when it loaded buffer, or null if buffer
+    // is not a column it handed out
+    virtual std::shared_ptr<data::MinMaxPyramid> getPyramid(const ColumnBuffer& buffer) const { return nullptr; }
 };
 
+// Input from a text log file. start() loads the file in the background through
+// an AsyncLogLoader; the data appears once loading has finished.
 class LogFileInput : public InputNode {
 public:
-    LogFileInput(const std::string& filename, const std::string& columnName);
-    ~LogFileInput() override = default;
+    LogFileInput(const std::string& filename, const std::string& columnName,
+                 AsyncLogLoader& loader = AsyncLogLoader::shared());
+    ~LogFileInput() override;
 
     bool isConnected() const override;
     std::vector<double> getData() const override;
+    ColumnBuffer getBuffer() const override;
     void start() override;
     void stop() override;
 
-    const std::vector<std::string>& getAvailableFields() const;
+    size_t readBlock(std::vector<double>& block, size_t maxSamples) override;
+    std::vector<int64_t> getTimestamps() const override;
+    bool hasTimestamps() const override { return true; }
+    size_t readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) override;
+    std::shared_ptr<data::MinMaxPyramid> getPyramid(const ColumnBuffer& buffer) const override;
+
+    std::vector<std::string> getAvailableFields() const;
     void setColumnName(const std::string& columnName);
 
+    // Keep the file open and stream rows as they are appended
+    void setFollow(bool follow);
+    bool isFollowing() const { return follow_; }
+
+    // Background load status
+    bool isLoading() const;
+    double getLoadProgress() const;
+    void cancelLoad();
+
 private:
+    void onRowsAppended(const std::vector<std::string>& fields, const std::vector<LogEntry>& rows, bool restarted);
+    void adoptLoadedFile() const;
+    size_t takePending(std::vector<int64_t>* timestampsUs, std::vector<double>& block, size_t maxSamples);
+
     std::string filename_;
     std::string columnName_;
-    std::unique_ptr<LogFileParser> parser_;
-    std::vector<double> data_;
-    bool connected_;
+    AsyncLogLoader* loader_;
+    mutable std::shared_ptr<AsyncLogLoader::Task> loadTask_;
+    mutable std::shared_ptr<const LogFileParser> parser_;
+    std::unique_ptr<LogFileFollower> follower_;
+    mutable ColumnBuffer data_;
+    mutable std::shared_ptr<data::MinMaxPyramid> pyramid_;  // Summary of data_ from the parser; null when followed
+    std::vector<std::string> fields_;
+    std::vector<int64_t> timestamps_;  // Followed rows only; loaded files read them from the parser
+    std::vector<double> pending_;
+    std::vector<int64_t> pendingTimestamps_;
+    mutable std::mutex dataMutex_;  // Guards the members above except follower_, which only the owning thread touches
+    mutable std::atomic<bool> connected_{false};
+    std::atomic<bool> follow_{false};
 };
 
+// Several columns of one text log, loaded once. Columns are picked by name
+// and/or by a glob pattern (* and ?); each one becomes a channel that the
+// pipeline runs through its own copy of the downstream filters.
+class MultiColumnInput : public InputNode {
+public:
+    explicit MultiColumnInput(const std::string& filename, AsyncLogLoader& loader = AsyncLogLoader::shared());
+    ~MultiColumnInput() override;
+
+    bool isConnected() const override;
+    std::vector<double> getData() const override;  // First channel
+    ColumnBuffer getBuffer() const override;
+    void start() override;
+    void stop() override;
+
+    std::vector<InputChannel> getChannels() const override;
+
+    std::vector<std::string> getAvailableFields() const;
+    void setColumns(const std::vector<std::string>& columns);
+    void setPattern(const std::string& pattern);
+
+    // Background load status
+    bool isLoading() const;
+    double getLoadProgress() const;
+    void cancelLoad();
+
+private:
+    void adoptLoadedFile() const;
+    void selectChannels() const;
+
+    std::string filename_;
+    AsyncLogLoader* loader_;
+    mutable std::shared_ptr<AsyncLogLoader::Task> loadTask_;
+    mutable std::shared_ptr<const LogFileParser> parser_;
+    std::vector<std::string> columns_;
+    std::string pattern_;
+    mutable std::vector<InputChannel> channels_;
+    mutable std::mutex dataMutex_;
+};
+
+// Replays one field of a wpilog through the streaming path, paced like the
+// original recording (or faster). Replayed samples are buffered for readBlock;
+// when the buffer is full the replay waits for the pipeline to catch up.
+class LogReplayInput : public InputNode {
+public:
+    LogReplayInput(const std::string& filename, const std::string& field);
+    ~LogReplayInput() override;
+
+    bool isConnected() const override;
+    std::vector<double> getData() const override;
+    ColumnBuffer getBuffer() const override;
+    void start() override;
+    void stop() override;
+
+    size_t readBlock(std::vector<double>& block, size_t maxSamples) override;
+    std::vector<int64_t> getTimestamps() const override;
+    bool hasTimestamps() const override { return true; }
+    size_t readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) override;
+
+    std::vector<std::string> getAvailableFields() const;
+    void setField(const std::string& field);
+
+    // Whether the log is still being indexed in the background; once it is
+    // done, this starts the replay on the calling (owning) thread
+    bool isLoading();
+
+    // Replay speed: 1 = real time, N = N times faster, <= 0 = as fast as possible
+    void setSpeed(double speed);
+    void setLoop(bool loop);
+    void seek(double seconds);
+
+    // Replay position and log length, in seconds from the start of the log
+    double getPosition() const;
+    double getDuration() const;
+
+private:
+    void onBatch(const std::vector<data::DataBatch>& batches);
+    void finishConnect();
+    void restartReplay(int64_t positionUs);
+    void clearHistory();
+    size_t takePending(std::vector<int64_t>* timestampsUs, std::vector<double>& block, size_t maxSamples);
+
+    std::string filename_;
+    std::string field_;
+    data::WpiLogDataSource source_;
+    data::ReplayOptions options_;
+    std::vector<double> history_;  // Current pass through the log only; cleared on loop and seek
+    std::vector<int64_t> timestamps_;
+    mutable ColumnBuffer snapshot_;  // history_ as last handed out by getBuffer
+    mutable bool snapshotStale_ = false;
+    std::vector<double> pending_;
+    std::vector<int64_t> pendingTimestamps_;
+    size_t maxPending_ = 1 << 20;
+    mutable std::mutex dataMutex_;
+    std::condition_variable drained_;
+    bool stopping_ = false;
+    std::atomic<bool> connected_{false};
+    std::thread connectThread_;  // Maps and indexes the log; owning thread only
+    std::atomic<bool> connecting_{false};
+    std::atomic<bool> subscribed_{false};  // Result of the last connect
+};
+
+// One NetworkTables value and the local time it was received at
+struct TimestampedSample {
+    int64_t timestampUs = 0;
+    double value = 0.0;
+};
+
+// Input from a NetworkTables topic (NT4). Each update is written by the ntcore
+// listener thread into a fixed-capacity single-producer/single-consumer ring,
+// which the streaming path drains in blocks; neither side locks or allocates
+// per sample. Updates that arrive while the ring is full are counted and dropped.
 class NetworkTableInput : public InputNode {
 public:
     NetworkTableInput(const std::string& tableName, const std::string& key);
-    ~NetworkTableInput() override = default;
+
+    // Subscribe through an existing instance (e.g. an in-process server)
+    // instead of starting a client with its own connection settings
+    NetworkTableInput(const std::string& tableName, const std::string& key, nt::NetworkTableInstance instance);
+    ~NetworkTableInput() override;
 
     bool isConnected() const override;
     std::vector<double> getData() const override;
     void start() override;
     void stop() override;
 
+    size_t readBlock(std::vector<double>& block, size_t maxSamples) override;
+    std::vector<int64_t> getTimestamps() const override;
+    bool hasTimestamps() const override { return true; }
+    size_t readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) override;
+
+    // Drain the ring directly into samples. Only one thread may read.
+    size_t readSamples(TimestampedSample* samples, size_t maxSamples);
+
     void setUseUSB(bool useUSB);
     void setTeamNumber(int teamNumber);
     void setIPAddress(const std::string& ipAddress);
 
+    // Also record every raw update, with its NT timestamp, to the channel;
+    // null stops recording. Recording never holds up the ring.
+    void setRecorder(std::shared_ptr<data::WpiLogRecorder::Channel> channel);
+
+    // Keep the most recent maxSamples updates for batch runs. 0, the default,
+    // keeps none: the input is then read only through the streaming path,
+    // and draining the ring takes no lock.
+    void setHistoryLimit(size_t maxSamples);
+
+    // Updates lost because the ring was full
+    uint64_t getDroppedSamples() const { return droppedSamples_.load(std::memory_order_relaxed); }
+
+    static constexpr size_t kRingCapacity = 1 << 16;
+
 private:
-    void updateLoop();
-    void onValueChanged(double value);
+    void onValueChanged(double value, int64_t timestampUs);
     std::string getServerAddress() const;
 
     std::string tableName_;
     std::string key_;
-    std::queue<double> dataBuffer_;
-    std::mutex bufferMutex_;
-    std::thread updateThread_;
-    std::atomic<bool> running_;
-    bool connected_;
-    std::function<void(double)> valueCallback_;
+    nt::NetworkTableInstance instance_;
+    bool ownsInstance_;
+    nt::GenericSubscriber subscriber_;
+    NT_Listener valueListener_ = 0;
+    NT_Listener connectionListener_ = 0;
+
+    data::SpscRingBuffer<TimestampedSample> samples_;
+    std::vector<TimestampedSample> scratch_;  // Consumer side, sized once
+    std::atomic<uint64_t> pushedSamples_{0};  // Producer side
+    uint64_t poppedSamples_ = 0;              // Consumer side
+    std::atomic<uint64_t> discardUntil_{0};   // Set by stop(); samples pushed before it are stale
+    std::atomic<uint64_t> droppedSamples_{0};
+    std::atomic<bool> connected_{false};
+    std::shared_ptr<data::WpiLogRecorder::Channel> recordChannel_;  // Atomic access only
 
     // Connection settings
     int teamNumber_ = 0;
     bool useUSB_ = true;
     std::string ipAddress_;
+
+    // The last historyLimit_ updates read, for batch processing; may run up
+    // to twice that before the oldest are dropped
+    std::atomic<size_t> historyLimit_{0};
+    mutable std::mutex dataMutex_;
     std::vector<double> data_;
+    std::vector<int64_t> timestamps_;
+};
+
+// Presents a timestamped input on a uniform time grid, so downstream filters
+// see the sample rate they were designed for. Sources without timestamps
+// pass through unchanged.
+class ResamplingInput : public InputNode {
+public:
+    ResamplingInput(std::shared_ptr<InputNode> source, double outputRate,
+                    Interpolation method = Interpolation::Linear, double maxGapSeconds = 0.0);
+
+    bool isConnected() const override;
+    std::vector<double> getData() const override;
+    void start() override;
+    void stop() override;
+
+    size_t readBlock(std::vector<double>& block, size_t maxSamples) override;
+
+    std::shared_ptr<InputNode> getSource() const { return source_; }
+
+private:
+    std::shared_ptr<InputNode> source_;
+    double outputRate_;
+    Interpolation method_;
+    double maxGapSeconds_;
+
+    // Streaming state; only the pipeline's reading thread touches it
+    Resampler resampler_;
+    std::vector<int64_t> blockTimes_;
+    std::vector<double> blockValues_;
+    std::vector<double> resampled_;  // Grid points not handed out yet
 };
 
 } // namespace filter 
\ No newline at end of file
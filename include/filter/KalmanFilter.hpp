@@ -0,0 +1,193 @@
+#pragma once
+
+#include "Filter.hpp"
+#include <Eigen/Cholesky>
+#include <frc/EigenCore.h>
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace filter {
+
+// Discrete linear model x[k+1] = A x[k] + w, y[k] = C x[k] + v, where w and
+// v are white noise with covariances Q and R
+template <int States, int Outputs>
+struct KalmanModel {
+    frc::Matrixd<States, States> A;
+    frc::Matrixd<States, States> Q;
+    frc::Matrixd<Outputs, States> C;
+    frc::Matrixd<Outputs, Outputs> R;
+};
+
+// Kalman filter with its dimensions fixed at compile time. Every matrix is
+// stored inline, so update() never allocates. The steady-state form uses
+// the gain the full filter converges to and skips the covariance update,
+// which makes it a fixed IIR filter; the full form also widens its
+// covariance across gaps, so it trusts the first samples after one more.
+template <int States, int Outputs>
+class KalmanEstimator {
+public:
+    using StateVector = frc::Vectord<States>;
+    using OutputVector = frc::Vectord<Outputs>;
+    using StateMatrix = frc::Matrixd<States, States>;
+    using GainMatrix = frc::Matrixd<States, Outputs>;
+
+    KalmanEstimator(const KalmanModel<States, Outputs>& model, bool steadyState)
+        : model_(model)
+        , steadyState_(steadyState) {
+        // Riccati recursion, run until the gain stops changing
+        StateMatrix covariance = model_.Q;
+        steadyGain_.setZero();
+        for (int i = 0; i < kMaxIterations; ++i) {
+            covariance = model_.A * covariance * model_.A.transpose() + model_.Q;
+            const GainMatrix next = gain(covariance);
+            covariance = correct(covariance, next);
+            const bool settled = (next - steadyGain_).norm() <= kTolerance * next.norm();
+            steadyGain_ = next;
+            if (settled) {
+                break;
+            }
+        }
+
+        steadyTransition_ = (StateMatrix::Identity() - steadyGain_ * model_.C) * model_.A;
+
+        // The first measurement sets the measured states; the rest start
+        // out unknown
+        const frc::Matrixd<Outputs, Outputs> outer = model_.C * model_.C.transpose();
+        measurementToState_ = outer.ldlt().solve(model_.C).transpose();
+        initialCovariance_ = covariance +
+            kUnknownVariance * (StateMatrix::Identity() - measurementToState_ * model_.C);
+        reset();
+    }
+
+    // Predict one step, then correct with the measurement. Measurements
+    // with NaN only predict.
+    void update(const OutputVector& y) {
+        if (!initialized_) {
+            if (!y.hasNaN()) {
+                x_ = measurementToState_ * y;
+                P_ = initialCovariance_;
+                initialized_ = true;
+            }
+            return;
+        }
+
+        if (y.hasNaN()) {
+            x_ = model_.A * x_;
+            if (!steadyState_) {
+                P_ = model_.A * P_ * model_.A.transpose() + model_.Q;
+            }
+        } else if (steadyState_) {
+            // Prediction and correction folded into one step
+            x_ = steadyTransition_ * x_ + steadyGain_ * y;
+        } else {
+            x_ = model_.A * x_;
+            P_ = model_.A * P_ * model_.A.transpose() + model_.Q;
+            const GainMatrix K = gain(P_);
+            x_ += K * (y - model_.C * x_);
+            P_ = correct(P_, K);
+        }
+    }
+
+    void reset() {
+        x_.setZero();
+        P_ = initialCovariance_;
+        initialized_ = false;
+    }
+
+    bool isInitialized() const { return initialized_; }
+    bool isSteadyState() const { return steadyState_; }
+    const StateVector& getState() const { return x_; }
+    const StateMatrix& getCovariance() const { return P_; }
+    const GainMatrix& getSteadyStateGain() const { return steadyGain_; }
+    const KalmanModel<States, Outputs>& getModel() const { return model_; }
+
+private:
+    static constexpr int kMaxIterations = 100000;
+    static constexpr double kTolerance = 1e-12;
+    static constexpr double kUnknownVariance = 1e6;
+
+    GainMatrix gain(const StateMatrix& P) const {
+        const frc::Matrixd<Outputs, Outputs> S = model_.C * P * model_.C.transpose() + model_.R;
+        return S.transpose().ldlt().solve(model_.C * P.transpose()).transpose();
+    }
+
+    // Joseph form, which keeps P symmetric and positive definite
+    StateMatrix correct(const StateMatrix& P, const GainMatrix& K) const {
+        const StateMatrix residual = StateMatrix::Identity() - K * model_.C;
+        return residual * P * residual.transpose() + K * model_.R * K.transpose();
+    }
+
+    KalmanModel<States, Outputs> model_;
+    bool steadyState_;
+    GainMatrix steadyGain_;
+    StateMatrix steadyTransition_;  // (I - K C) A
+    frc::Matrixd<States, Outputs> measurementToState_;
+    StateMatrix initialCovariance_;
+
+    StateVector x_;
+    StateMatrix P_;
+    bool initialized_ = false;
+};
+
+enum class KinematicModel {
+    ConstantVelocity,     // Position and velocity
+    ConstantAcceleration  // Position, velocity and acceleration
+};
+
+struct KinematicSettings {
+    double sampleRate = 50.0;
+    double processNoise = 1.0;      // Std dev the highest derivative drifts by in one second
+    double measurementNoise = 0.1;  // Std dev of one measurement
+    bool steadyState = true;
+    int output = 0;                 // State sent on: 0 position, 1 velocity, 2 acceleration
+};
+
+// Tracks a measured position and its derivatives; the highest derivative
+// is modeled as a random walk. States is 2 for constant velocity and 3 for
+// constant acceleration. Coefficients, poles, zeros and the frequency
+// response are those of the steady-state filter, which the full filter
+// converges to.
+template <int States>
+class KinematicKalmanFilter : public Filter {
+public:
+    explicit KinematicKalmanFilter(const KinematicSettings& settings = KinematicSettings());
+
+    double processSample(double input) override;
+    std::vector<double> processBlock(const std::vector<double>& input) override;
+    std::vector<double> getNumeratorCoefficients() const override;
+    std::vector<double> getDenominatorCoefficients() const override;
+    std::vector<std::complex<double>> getPoles() const override;
+    std::vector<std::complex<double>> getZeros() const override;
+    std::vector<std::complex<double>> getFrequencyResponse(const std::vector<double>& frequencies) const override;
+    std::string getTypeName() const override;
+    std::shared_ptr<Filter> clone() const override;
+
+    // "sampleRate", "processNoise", "measurementNoise", "steadyState" (0 or 1)
+    // and "output"; changing one starts the estimate over
+    void setParameter(const std::string& name, double value) override;
+    double getParameter(const std::string& name) const override;
+
+    void reset() override { estimator_.reset(); }
+    const KalmanEstimator<States, 1>& getEstimator() const { return estimator_; }
+
+protected:
+    std::complex<double> evaluateTransferFunction(const std::complex<double>& z) const override;
+
+private:
+    double output() const;
+
+    KinematicSettings settings_;
+    KalmanEstimator<States, 1> estimator_;
+};
+
+extern template class KinematicKalmanFilter<2>;
+extern template class KinematicKalmanFilter<3>;
+
+using ConstantVelocityKalmanFilter = KinematicKalmanFilter<2>;
+using ConstantAccelerationKalmanFilter = KinematicKalmanFilter<3>;
+
+std::shared_ptr<Filter> makeKinematicKalmanFilter(KinematicModel model, const KinematicSettings& settings);
+
+} // namespace filter
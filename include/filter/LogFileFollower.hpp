@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include "LogFileParser.hpp"
+
+namespace filter {
+
+// Follows a growing log file and parses only the bytes appended to it. A
+// file that is truncated, rewritten or replaced is parsed again from the
+// start. Uses inotify on Linux and falls back to polling the file size elsewhere.
+class LogFileFollower {
+public:
+    // Called from the watcher thread with the fields and the newly parsed
+    // rows; restarted means the file started over and earlier rows are gone
+    using RowsCallback = std::function<void(const std::vector<std::string>& fields,
+                                            const std::vector<LogEntry>& rows, bool restarted)>;
+
+    LogFileFollower(const std::string& filename, RowsCallback callback);
+    ~LogFileFollower();
+
+    LogFileFollower(const LogFileFollower&) = delete;
+    LogFileFollower& operator=(const LogFileFollower&) = delete;
+
+    // Start following the file. The rows already in it are parsed on the
+    // watcher thread and delivered as the first block; returns false if the
+    // file cannot be opened.
+    bool start();
+
+    // Stop the watcher thread and close the file
+    void stop();
+
+    // Check if the watcher thread is running
+    bool isRunning() const { return running_; }
+
+    // Check if the rows already in the file are still being parsed, and how far along that is
+    bool isLoading() const { return loading_; }
+    double getLoadProgress() const { return loadProgress_; }
+
+    // Interval used for polling, and as the inotify wake-up timeout
+    void setPollInterval(std::chrono::milliseconds interval) { pollInterval_ = interval; }
+
+private:
+    void watchLoop();
+    void waitForChange();
+    void publishNewRows();
+    bool openWatch();
+    void closeWatch();
+
+    std::string filename_;
+    RowsCallback callback_;
+    LogFileParser parser_;
+    std::thread watchThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> loading_{false};
+    std::atomic<double> loadProgress_{0.0};
+    std::chrono::milliseconds pollInterval_{100};
+    size_t publishedCount_ = 0;
+    uint64_t publishedRestarts_ = 0;
+
+    // inotify descriptors (Linux only)
+    int inotifyFd_ = -1;
+    int watchFd_ = -1;
+};
+
+} // namespace filter
@@ -5,6 +5,11 @@
 #include <map>
 #include <fstream>
 #include <memory>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+#include "ColumnBuffer.hpp"
+#include "../data/MinMaxPyramid.hpp"
 
 namespace filter {
 
@@ -15,11 +20,30 @@ struct LogEntry {
 
 class LogFileParser {
 public:
+    // Receives the fraction of the file read so far; return false to cancel
+    using ProgressCallback = std::function<bool(double fraction)>;
+
     LogFileParser() = default;
     ~LogFileParser() = default;
 
-    // Load a log file from the given path
-    bool loadFile(const std::string& filename);
+    // Load a log file from the given path. Returns false if the file has no
+    // entries or the progress callback cancelled the load.
+    bool loadFile(const std::string& filename, const ProgressCallback& progress = nullptr);
+
+    // Load a log file and keep it open so appended rows can be read later.
+    // Returns false if the file cannot be opened or progress cancelled the load.
+    bool openFollow(const std::string& filename, const ProgressCallback& progress = nullptr);
+
+    // Parse bytes appended since the last read; returns the number of new
+    // entries. A file that was truncated, rewritten or replaced since the
+    // last read is parsed again from the start, which bumps getRestartCount().
+    size_t readAppended() { return readAppended(nullptr); }
+
+    // Number of times a followed file has been parsed again from the start
+    uint64_t getRestartCount() const { return restartCount_; }
+
+    // Check if the file is being followed
+    bool isFollowing() const { return following_; }
 
     // Get all log entries
     const std::vector<LogEntry>& getEntries() const { return entries_; }
@@ -30,18 +54,42 @@ public:
     // Get data for a specific field
     std::vector<double> getFieldData(const std::string& fieldName) const;
 
+    // Get a shared buffer for a field; repeated requests return the same
+    // allocation until rows are appended, after which only the new rows are read.
+    // With pyramid, also returns the plot summary kept alongside the column.
+    ColumnBuffer getFieldBuffer(const std::string& fieldName,
+                                std::shared_ptr<data::MinMaxPyramid>* pyramid = nullptr) const;
+
     // Clear all loaded data
     void clear();
 
 private:
+    size_t readAppended(const ProgressCallback& progress);
     void processLine(const std::string& line);
     bool parseHeader(const std::string& line);
     bool parseData(const std::string& line);
+    bool matchesLastBytes();
 
     std::vector<LogEntry> entries_;
     std::vector<std::string> fields_;
     std::map<std::string, size_t> fieldIndices_;
     std::ifstream file_;
+    struct CachedColumn {
+        ColumnBuffer buffer;
+        std::shared_ptr<data::MinMaxPyramid> pyramid;  // Summary of buffer; copied before updating if shared
+        size_t rows = 0;  // Entries the buffer was built from
+    };
+    mutable std::map<std::string, CachedColumn> columnCache_;
+    mutable std::mutex cacheMutex_;
+
+    // Follow mode state
+    std::string filename_;
+    std::string partialLine_;
+    std::streamoff readOffset_ = 0;
+    std::string lastBytes_;  // Tail of what was read, to tell an append from a rewrite
+    uint64_t restartCount_ = 0;
+    bool headerParsed_ = false;
+    bool following_ = false;
 };
 
-} // namespace filter 
\ No newline at end of file
+} // namespace filter
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <memory>
+#include <map>
+#include <cstdint>
+
+namespace filter {
+
+// Reads one column of a text log in bounded windows of rows instead of
+// materializing the whole file. Parsing rules match LogFileParser.
+class LogFileWindowReader {
+public:
+    LogFileWindowReader() = default;
+    ~LogFileWindowReader() = default;
+
+    // Open a log file and parse its header
+    bool open(const std::string& filename);
+
+    // Select the column returned by readWindow
+    bool selectColumn(const std::string& columnName);
+
+    // Read up to maxRows rows; returns the number of rows read (0 at end of file)
+    size_t readWindow(size_t maxRows, std::vector<double>& timestamps, std::vector<double>& values);
+
+    // Check if reading stopped on a corrupt or truncated file rather than at its end
+    bool hasFailed() const { return stream_ && stream_->bad(); }
+
+    // Get available data fields/columns
+    const std::vector<std::string>& getFields() const { return fields_; }
+
+    // Bytes consumed so far and total file size (0 if unknown), for progress reporting
+    uint64_t getBytesRead() const { return bytesRead_; }
+    uint64_t getFileSize() const { return fileSize_; }
+
+    void close();
+
+private:
+    std::unique_ptr<std::istream> stream_;
+    std::vector<std::string> fields_;
+    std::map<std::string, size_t> fieldIndices_;
+    std::vector<double> lastValues_;
+    size_t columnIndex_ = 0;
+    uint64_t bytesRead_ = 0;
+    uint64_t fileSize_ = 0;
+};
+
+} // namespace filter
@@ -18,6 +18,8 @@ public:
     std::vector<std::complex<double>> getZeros() const override;
     std::vector<std::complex<double>> getFrequencyResponse(const std::vector<double>& frequencies) const override;
     std::string getTypeName() const override;
+    std::shared_ptr<Filter> clone() const override;
+    void reset() override;
     void setParameter(const std::string& name, double value) override;
     double getParameter(const std::string& name) const override;
     std::vector<double> processBlock(const std::vector<double>& input) override;
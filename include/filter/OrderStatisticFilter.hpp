@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Filter.hpp"
+#include "SlidingOrderStatistics.hpp"
+#include <vector>
+#include <complex>
+
+namespace filter {
+
+// Nonlinear filters over a sliding window of samples. Unlike linear filters
+// they remove isolated spikes (encoder glitches, vision outliers) instead of
+// smearing them. They have no transfer function, so coefficients, poles,
+// zeros and the frequency response are empty.
+class OrderStatisticFilter : public Filter {
+public:
+    double processSample(double input) override;
+    std::vector<double> processBlock(const std::vector<double>& input) override;
+    std::vector<double> getNumeratorCoefficients() const override;
+    std::vector<double> getDenominatorCoefficients() const override;
+    std::vector<std::complex<double>> getPoles() const override;
+    std::vector<std::complex<double>> getZeros() const override;
+    std::vector<std::complex<double>> getFrequencyResponse(const std::vector<double>& frequencies) const override;
+
+    // "windowSize" in samples; subclasses add their own parameter
+    void setParameter(const std::string& name, double value) override;
+    double getParameter(const std::string& name) const override;
+
+    void reset() override { window_.reset(); }
+
+protected:
+    OrderStatisticFilter(size_t windowSize, SlidingOrderStatistics::Statistic statistic, double parameter);
+
+    std::complex<double> evaluateTransferFunction(const std::complex<double>& z) const override;
+
+    SlidingOrderStatistics window_;
+};
+
+class MedianFilter : public OrderStatisticFilter {
+public:
+    explicit MedianFilter(size_t windowSize = 5);
+
+    std::string getTypeName() const override;
+    std::shared_ptr<Filter> clone() const override;
+};
+
+class PercentileFilter : public OrderStatisticFilter {
+public:
+    explicit PercentileFilter(size_t windowSize = 5, double percentile = 50.0);
+
+    std::string getTypeName() const override;
+    std::shared_ptr<Filter> clone() const override;
+
+    // Adds "percentile" (0-100)
+    void setParameter(const std::string& name, double value) override;
+    double getParameter(const std::string& name) const override;
+};
+
+// Mean of the window after dropping a fraction of samples from each end
+class TrimmedMeanFilter : public OrderStatisticFilter {
+public:
+    explicit TrimmedMeanFilter(size_t windowSize = 5, double trimFraction = 0.25);
+
+    std::string getTypeName() const override;
+    std::shared_ptr<Filter> clone() const override;
+
+    // Adds "trimFraction" (0-0.5, per side)
+    void setParameter(const std::string& name, double value) override;
+    double getParameter(const std::string& name) const override;
+};
+
+} // namespace filter
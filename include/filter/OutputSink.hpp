@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../data/AsyncFileWriter.hpp"
+
+namespace filter {
+
+// Writes filtered columns to a CSV file or a new wpilog. Rows are formatted
+// on the calling thread and handed to a background writer, so processing
+// overlaps with disk I/O; a slow disk slows the caller down instead of
+// growing memory.
+class OutputSink {
+public:
+    enum class Format {
+        Csv,
+        WpiLog
+    };
+
+    OutputSink(const std::string& filename, Format format, double sampleRate = 100.0);
+    ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    // Start a new file with one column per name, replacing any earlier one
+    bool open(const std::vector<std::string>& columnNames);
+
+    // Append rows; columns[i] points at rows values of column i. Sample
+    // times continue from the previous call at the configured rate.
+    bool write(const std::vector<const double*>& columns, size_t rows);
+
+    // Flush everything written so far and close the file
+    bool close();
+
+    const std::string& getFilename() const { return filename_; }
+    Format getFormat() const { return format_; }
+    bool isOpen() const { return writer_.isOpen(); }
+
+    // Safe to call from any thread
+    uint64_t getRowsWritten() const { return rowsWritten_.load(); }
+    uint64_t getBytesWritten() const { return writer_.getBytesWritten(); }
+    bool hasFailed() const { return writer_.hasFailed(); }
+
+private:
+    bool writeCsv(const std::vector<const double*>& columns, size_t rows);
+    bool writeWpiLog(const std::vector<const double*>& columns, size_t rows);
+
+    const std::string filename_;
+    const Format format_;
+    const double sampleRate_;
+
+    data::AsyncFileWriter writer_;
+    size_t columnCount_ = 0;
+    uint64_t nextRow_ = 0;
+    std::atomic<uint64_t> rowsWritten_{0};
+};
+
+} // namespace filter
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace filter {
+
+enum class Interpolation {
+    ZeroOrderHold,
+    Linear,
+    Cubic  // Catmull-Rom through the neighbouring samples
+};
+
+// Maps irregularly timestamped samples onto a uniform time grid, so filters
+// that assume a fixed sample rate see one. Works incrementally: process()
+// emits every grid point the samples so far determine, flush() the rest.
+class Resampler {
+public:
+    // A stretch of input longer than the maximum gap; the grid restarts after it
+    struct Gap {
+        int64_t startUs;
+        int64_t endUs;
+        size_t outputIndex;  // First output sample after the gap
+    };
+
+    explicit Resampler(double outputRate = 100.0, Interpolation method = Interpolation::Linear,
+                       double maxGapSeconds = 0.0);
+
+    void setOutputRate(double outputRate);
+    double getOutputRate() const { return 1e6 / periodUs_; }
+    void setInterpolation(Interpolation method) { method_ = method; }
+    Interpolation getInterpolation() const { return method_; }
+
+    // Input spacing above this is treated as a gap instead of being
+    // interpolated across; <= 0 disables gap detection
+    void setMaxGap(double seconds);
+
+    // Feed samples in time order; appends new grid points to output and
+    // returns how many were added. Samples that do not move time forward are dropped.
+    size_t process(const int64_t* timestampsUs, const double* values, size_t count, std::vector<double>& output);
+
+    // Emit the grid points up to the last sample
+    size_t flush(std::vector<double>& output);
+
+    void reset();
+
+    // Resample a whole series in one call
+    std::vector<double> resample(const std::vector<int64_t>& timestampsUs, const std::vector<double>& values);
+
+    const std::vector<Gap>& getGaps() const { return gaps_; }
+    size_t getDroppedSamples() const { return droppedSamples_; }
+    size_t getOutputCount() const { return outputCount_; }
+
+private:
+    size_t emit(std::vector<double>& output, bool final);
+
+    double periodUs_;
+    Interpolation method_;
+    int64_t maxGapUs_ = 0;
+
+    // Samples still needed for interpolation, kept contiguous for the kernels
+    std::vector<int64_t> times_;
+    std::vector<double> values_;
+    size_t cursor_ = 0;  // Segment of times_ holding the next grid point
+
+    // Next grid point is gridOriginUs_ + gridIndex_ * periodUs_
+    int64_t gridOriginUs_ = 0;
+    size_t gridIndex_ = 0;
+
+    // Scratch for one chunk: source segment and position inside it for each grid point
+    std::vector<size_t> segments_;
+    std::vector<double> fractions_;
+
+    std::vector<Gap> gaps_;
+    size_t droppedSamples_ = 0;
+    size_t outputCount_ = 0;
+};
+
+} // namespace filter
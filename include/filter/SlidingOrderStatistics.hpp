@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <set>
+
+namespace filter {
+
+// Order statistics over the last w samples in O(log w) per sample. The
+// window is kept sorted as three partitions (below, selected, above): a
+// quantile selects one or two middle samples, a trimmed mean everything
+// but the tails. Each new sample moves at most a few elements across the
+// partition boundaries. NaN samples take a window slot but are ignored.
+class SlidingOrderStatistics {
+public:
+    enum class Statistic {
+        Quantile,     // parameter: 0..1, linear interpolation between ranks
+        TrimmedMean   // parameter: fraction dropped from each tail, 0..0.5
+    };
+
+    SlidingOrderStatistics(size_t windowSize, Statistic statistic, double parameter);
+
+    // Add a sample (dropping the oldest once the window is full) and return
+    // the statistic of the window, or NaN if it holds no valid samples
+    double push(double sample);
+
+    // Statistic of the current window without adding a sample
+    double value() const;
+
+    void reset();
+
+    // Changing the window or parameter restarts the window
+    void setWindowSize(size_t windowSize);
+    void setParameter(double parameter);
+    size_t getWindowSize() const { return windowSize_; }
+    double getParameter() const { return parameter_; }
+    size_t getCount() const { return below_.size() + selected_.size() + above_.size(); }
+
+private:
+    using Partition = std::multiset<double>;
+
+    // Erase returns the freed tree node so insert can reuse it without allocating
+    Partition::node_type erase(double sample);
+    void insert(double sample, Partition::node_type spare);
+    void rebalance();
+    void moveNode(Partition& from, Partition::iterator it, Partition& to);
+
+    size_t windowSize_;
+    Statistic statistic_;
+    double parameter_;
+
+    std::deque<double> history_;  // Window in arrival order
+    Partition below_;
+    Partition selected_;
+    Partition above_;
+    double selectedSum_ = 0.0;  // Trimmed mean only
+    size_t sinceResum_ = 0;     // Updates since selectedSum_ was recomputed
+};
+
+} // namespace filter
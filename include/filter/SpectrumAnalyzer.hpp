@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Fft.hpp"
+
+namespace filter {
+
+struct SpectrumOptions {
+    size_t segmentLength = 1024;  // Rounded up to a power of two
+    double overlap = 0.5;         // Fraction of a segment shared with the next
+    WindowType window = WindowType::Hann;
+    double sampleRate = 1.0;
+    size_t maxColumns = 512;      // Spectrogram history kept
+    size_t threadCount = 0;       // 0 = one per hardware thread
+
+    size_t hop() const;
+};
+
+// Welch power spectral density and STFT spectrogram of a signal fed in
+// blocks. Each complete segment is detrended, windowed and transformed
+// once; its periodogram joins the running Welch average and becomes one
+// spectrogram column, so streamed input costs only the new segments.
+// Large blocks are split across threads by segment.
+//
+// append() and reset() are for one producer thread; the getters may be
+// called from any thread.
+class SpectrumAnalyzer {
+public:
+    explicit SpectrumAnalyzer(const SpectrumOptions& options = SpectrumOptions());
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    const SpectrumOptions& getOptions() const { return options_; }
+    size_t getBinCount() const { return plan_->bins(); }
+
+    void append(const double* data, size_t count);
+    void append(const std::vector<double>& data) { append(data.data(), data.size()); }
+    void reset();
+
+    // One-sided PSD in units^2/Hz, one value per bin; false before the
+    // first complete segment. Segments with gaps (NaN) are left out.
+    bool getPsd(std::vector<double>& frequencies, std::vector<double>& power) const;
+
+    // Spectrogram in dB as a row-major image: one row per bin, highest
+    // frequency first, one column per segment, oldest first. Columns of
+    // segments with gaps get the image minimum. Returns the column count.
+    size_t getSpectrogram(std::vector<double>& image, double& startTime, double& endTime) const;
+
+    // Changes whenever new segments arrive or the analyzer is reset
+    uint64_t getRevision() const;
+    uint64_t getSegmentCount() const;
+
+private:
+    // Periodogram of one segment into out; false if it has a gap
+    bool periodogram(const double* segment, std::vector<std::complex<double>>& spectrum,
+                     std::vector<double>& windowed, double* out) const;
+
+    SpectrumOptions options_;
+    std::shared_ptr<const RealFft> plan_;
+    std::shared_ptr<const std::vector<double>> window_;
+    double scale_ = 1.0;  // Density scaling of |X|^2
+
+    // Producer side
+    std::vector<double> pending_;  // Samples not yet covered by a complete segment
+    uint64_t consumed_ = 0;        // Input samples before pending_
+
+    mutable std::mutex mutex_;     // Guards the state below
+    std::vector<double> psdSum_;
+    uint64_t psdSegments_ = 0;
+    std::vector<double> columns_;  // Ring of maxColumns columns, bins values each, dB
+    size_t columnCount_ = 0;
+    size_t nextColumn_ = 0;
+    uint64_t lastColumnStart_ = 0;  // Input sample index where the newest column starts
+    uint64_t segments_ = 0;
+    uint64_t revision_ = 0;
+};
+
+} // namespace filter
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include "../filter/ColumnBuffer.hpp"
 
 namespace filter {
     class Filter;
@@ -22,6 +23,13 @@ public:
         std::vector<std::string> outputIds;
         std::shared_ptr<filter::Filter> filter;
         std::shared_ptr<filter::InputNode> inputNode;
+        filter::ColumnBuffer output;  // Last result; shared with downstream pass-through nodes
+    };
+
+    // Result of one channel of a multi-channel input
+    struct ChannelOutput {
+        std::string name;
+        filter::ColumnBuffer output;
     };
 
     FilterPipeline() = default;
@@ -29,6 +37,7 @@ public:
 
     // Node management
     std::string addNode(const std::string& type, const std::map<std::string, double>& params);
+    void addNode(const std::string& nodeId, const std::string& type, const std::map<std::string, double>& params);
     void removeNode(const std::string& nodeId);
     bool connectNodes(const std::string& sourceId, const std::string& targetId);
     void disconnectNodes(const std::string& sourceId, const std::string& targetId);
@@ -41,6 +50,23 @@ public:
 
     // Data processing
     std::vector<double> processData(const std::vector<double>& input);
+
+    // Same as processData, but passes columns around as shared buffers
+    filter::ColumnBuffer processColumns(const filter::ColumnBuffer& input);
+
+    // Run every channel of a source's input through its own reset copy of
+    // the downstream filters, in parallel. Outputs are in channel order.
+    std::vector<ChannelOutput> processChannels(const std::string& sourceId) const;
+
+    // Get the last output produced by a node
+    filter::ColumnBuffer getNodeOutput(const std::string& nodeId) const;
+
+    // Streaming: push one block from a source node through its downstream chain.
+    // Filter state carries over between calls.
+    std::vector<double> processBlock(const std::string& sourceId, const std::vector<double>& block);
+
+    // Drain newly arrived samples from every streaming input node and process them
+    std::vector<double> processStream(size_t maxBlockSize = 4096);
     std::vector<double> getLinearFilterCoefficients() const;
 
     // Code generation
@@ -49,7 +75,16 @@ public:
     // Node access
     std::vector<PipelineNode> getPipelineNodes() const;
 
+    // Copy of the graph with its own reset copy of every filter and no
+    // input nodes, to be fed through processBlock on another thread while
+    // this one carries on
+    FilterPipeline detachedCopy() const;
+
 private:
+    filter::ColumnBuffer propagate(const std::string& sourceId, filter::ColumnBuffer data);
+    std::vector<size_t> downstreamOrder(const std::string& sourceId) const;
+    static void combineOutputs(filter::ColumnBuffer& output, const filter::ColumnBuffer& nodeOutput);
+
     std::vector<PipelineNode> nodes_;
 };
 
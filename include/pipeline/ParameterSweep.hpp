@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../filter/ColumnBuffer.hpp"
+#include "../filter/FilterDesign.hpp"
+
+namespace pipeline {
+
+// Grid of low-pass designs; every combination of type, order and cutoff
+struct SweepGrid {
+    std::vector<filter::DesignType> types{filter::DesignType::Butterworth};
+    std::vector<int> orders{1, 2, 3, 4};
+    std::vector<double> cutoffs;
+    double sampleRate = 100.0;
+    double ripple = 1.0;
+
+    std::vector<filter::DesignSpec> specs() const;
+
+    // count cutoffs spaced evenly on a log scale from minimum to maximum
+    static std::vector<double> logSpace(double minimum, double maximum, size_t count);
+};
+
+struct SweepOptions {
+    size_t blockSize = 8192;       // Samples per streamed block
+    size_t lagWindow = 16384;      // Samples around the middle used for the lag estimate
+    size_t maxLag = 256;           // Largest lag searched, in samples
+    size_t stepLength = 4096;      // Step response length for overshoot
+    size_t threadCount = 0;        // 0: one per hardware thread
+};
+
+// How one design does on the signal. Smaller is better for every metric.
+struct SweepResult {
+    filter::DesignSpec spec;
+    double rmsResidual = 0.0;  // RMS of output minus input
+    double lagSamples = 0.0;   // Cross-correlation peak, sub-sample interpolated
+    double lagSeconds = 0.0;
+    double noisePower = 0.0;   // Mean square first difference of the output, a high-pass proxy
+    double overshoot = 0.0;    // Step response peak above 1, in percent
+    bool pareto = false;       // Not beaten on both lag and noise by any other design
+};
+
+// Evaluates a grid of designs against one signal on a pool of threads.
+// Each design streams the signal through its own cascade in blocks, so
+// memory per thread stays small however long the log is. Designs come from
+// a coefficient cache shared across sweeps.
+class ParameterSweep {
+public:
+    ParameterSweep();
+    ~ParameterSweep();
+
+    ParameterSweep(const ParameterSweep&) = delete;
+    ParameterSweep& operator=(const ParameterSweep&) = delete;
+
+    // Start a sweep in the background, replacing any running one
+    void start(filter::ColumnBuffer signal, const SweepGrid& grid, const SweepOptions& options = SweepOptions());
+    void cancel();
+
+    bool isRunning() const { return running_.load(); }
+    double getProgress() const;
+
+    // Results of the last finished sweep, in grid order
+    std::shared_ptr<const std::vector<SweepResult>> getResults() const;
+
+    // Run synchronously on the calling thread plus workers; empty if cancelled
+    std::vector<SweepResult> run(const filter::ColumnBuffer& signal, const std::vector<filter::DesignSpec>& specs,
+                                 const SweepOptions& options);
+
+    filter::DesignCache& getDesignCache() { return cache_; }
+
+    // Flag the designs on the lag/noise Pareto front
+    static void markParetoFront(std::vector<SweepResult>& results);
+
+private:
+    // Designs evaluated together in one pass over the signal
+    static constexpr size_t kLanes = 4;
+
+    // One section index across the designs of a group
+    struct LaneSection {
+        double b0[kLanes], b1[kLanes], b2[kLanes], a1[kLanes], a2[kLanes];
+    };
+
+    // Scratch buffers of one pool thread
+    struct Scratch {
+        std::vector<LaneSection> sections;
+        std::vector<double> block;     // Lane outputs, interleaved
+        std::vector<double> excerpts;  // Output over the lag window, one run per lane
+        std::vector<double> correlation;
+    };
+
+    // Evaluate up to kLanes designs with the same number of sections. Each
+    // section's recursion is latency bound; interleaving independent designs
+    // keeps the FPU busy, which roughly divides the filtering time by the lanes.
+    // inputExcerpt: the mean-removed input over the lag window at excerptStart.
+    void evaluateGroup(const std::vector<double>& signal, const std::vector<double>& inputExcerpt, size_t excerptStart,
+                       const filter::DesignSpec* specs, size_t count, const SweepOptions& options,
+                       Scratch& scratch, SweepResult* results);
+    void join();
+
+    filter::DesignCache cache_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<size_t> completed_{0};
+    std::atomic<size_t> total_{0};
+
+    mutable std::mutex resultsMutex_;
+    std::shared_ptr<const std::vector<SweepResult>> results_;
+};
+
+} // namespace pipeline
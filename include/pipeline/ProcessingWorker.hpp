@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FilterPipeline.hpp"
+#include "TripleBuffer.hpp"
+#include "../data/SpscRingBuffer.hpp"
+#include "../data/MinMaxPyramid.hpp"
+#include "../data/WpiLogRecorder.hpp"
+
+namespace filter {
+    class OutputSink;
+    class SpectrumAnalyzer;
+    class CrossCorrelator;
+}
+
+namespace pipeline {
+
+class WindowedRun;
+
+// One channel of a multi-column input after its filter chain
+struct ChannelResult {
+    std::string name;
+    filter::ColumnBuffer output;
+    std::shared_ptr<data::MinMaxPyramid> pyramid;
+};
+
+// Immutable snapshot of one batch run, shared with the UI
+struct ProcessingResult {
+    uint64_t revision = 0;                               // Value returned by the matching requestProcess()
+    filter::ColumnBuffer output;  // Combined pipeline output
+    std::map<std::string, filter::ColumnBuffer> nodeOutputs;
+    std::map<std::string, std::shared_ptr<data::MinMaxPyramid>> nodePyramids;  // Plot summaries of nodeOutputs; do not modify while shared
+    std::map<std::string, std::vector<ChannelResult>> channelOutputs;  // By multi-column source node
+};
+
+// Runs a FilterPipeline on its own thread. The owning (UI) thread edits the
+// graph by queueing commands and reads results back without taking locks,
+// so a heavy graph never stalls a frame. All methods must be called from
+// one owning thread.
+class ProcessingWorker {
+public:
+    using Command = std::function<void(FilterPipeline&)>;
+
+    explicit ProcessingWorker(size_t queueCapacity = 1024);
+    ~ProcessingWorker();
+
+    ProcessingWorker(const ProcessingWorker&) = delete;
+    ProcessingWorker& operator=(const ProcessingWorker&) = delete;
+
+    // Queue an arbitrary edit; commands run on the worker in submission order
+    void submit(Command command);
+
+    // Graph edits. Node ids are assigned here, so they can be used right away.
+    std::string addNode(const std::string& type, const std::map<std::string, double>& params);
+    void removeNode(const std::string& nodeId);
+    void connectNodes(const std::string& sourceId, const std::string& targetId);
+    void disconnectNodes(const std::string& sourceId, const std::string& targetId);
+    void setNodeParameters(const std::string& nodeId, const std::map<std::string, double>& params);
+    void setInputNode(const std::string& nodeId, std::shared_ptr<filter::InputNode> inputNode);
+
+    // Write a node's output to the sink: the whole output after the next
+    // batch run, then each streamed block as it arrives. Later batch runs
+    // leave the file alone, so streamed rows are kept; attach a new sink to
+    // start the file over. The worker owns the writing; null closes and
+    // detaches the current sink.
+    void setOutputSink(const std::string& nodeId, std::shared_ptr<filter::OutputSink> sink);
+
+    // Record each streamed block of a node's output to a live recording;
+    // null detaches the channel
+    void setRecorder(const std::string& nodeId, std::shared_ptr<data::WpiLogRecorder::Channel> channel);
+
+    // Feed a node's output, or with nodeInput the signal on its first input,
+    // to a spectrum analyzer: the whole signal now and after every batch run,
+    // then each streamed block. Null detaches the analyzer on that side.
+    void setAnalyzer(const std::string& nodeId, std::shared_ptr<filter::SpectrumAnalyzer> analyzer, bool nodeInput = false);
+
+    // Correlate the outputs of two nodes: the whole outputs now and after
+    // every batch run, then each streamed block of either. Empty ids detach
+    // the correlator.
+    void setCorrelator(std::shared_ptr<filter::CrossCorrelator> correlator,
+                       const std::string& referenceId, const std::string& signalId);
+
+    // Start a whole-file run through a copy of the graph as it stands once
+    // all earlier edits are applied; see WindowedRun::start
+    void startWindowedRun(std::shared_ptr<WindowedRun> run, const std::string& inputFile, const std::string& field,
+                          bool wpilog, const std::string& sourceNodeId, const std::string& outputFile);
+
+    // Drop every node and start from an empty pipeline
+    void reset();
+
+    // Rerun the whole graph once all earlier edits are applied.
+    // Returns the revision the resulting snapshot will carry.
+    uint64_t requestProcess();
+
+    // Latest finished batch run, or null before the first one
+    std::shared_ptr<const ProcessingResult> getLatestResult();
+
+    // Append each node's streamed output produced since the last call, by
+    // node id; returns samples added
+    size_t takeStreamOutput(std::map<std::string, std::vector<double>>& outputs);
+
+    // Streamed blocks lost because the UI fell behind
+    uint64_t getDroppedBlocks() const { return droppedBlocks_.load(std::memory_order_relaxed); }
+
+private:
+    void workerLoop();
+    void flushOverflow();
+    bool applyCommands();
+    void runBatch();
+    void writeBatchToSinks(const ProcessingResult& result);
+    void writeStreamToSinks();
+    void recordStream();
+    void analyzeStream();
+    void correlateStream();
+    void publishStream();
+    void wake();
+
+    struct SinkState {
+        std::shared_ptr<filter::OutputSink> sink;
+        filter::ColumnBuffer lastWritten;  // Node output already in the file
+        bool channels = false;             // Writing every channel of a multi-column source
+        bool opened = false;               // The file has been started
+    };
+
+    FilterPipeline pipeline_;  // Worker thread only
+    struct RecorderState {
+        std::shared_ptr<data::WpiLogRecorder::Channel> channel;
+        filter::ColumnBuffer lastRecorded;
+    };
+
+    struct AnalyzerState {
+        std::shared_ptr<filter::SpectrumAnalyzer> analyzer;
+        std::string sourceId;  // Node whose output is analyzed
+        filter::ColumnBuffer lastAnalyzed;
+    };
+
+    struct CorrelatorState {
+        std::string referenceId;
+        std::string signalId;
+        filter::ColumnBuffer lastReference;
+        filter::ColumnBuffer lastSignal;
+    };
+    void fillCorrelator(filter::CrossCorrelator& correlator, CorrelatorState& state);
+
+    std::map<std::string, SinkState> sinks_;  // Worker thread only, by node id
+    std::map<std::string, RecorderState> recorders_;  // Worker thread only, by node id
+    std::map<std::pair<std::string, bool>, AnalyzerState> analyzers_;  // Worker thread only, by node id and side
+    std::map<std::shared_ptr<filter::CrossCorrelator>, CorrelatorState> correlators_;  // Worker thread only
+    std::map<std::string, filter::ColumnBuffer> lastPublished_;  // Worker thread only; node outputs the UI has
+
+    data::SpscRingBuffer<Command> commands_;
+    std::deque<Command> overflow_;  // Owner side; commands that did not fit in the queue yet
+    using StreamBlock = std::map<std::string, filter::ColumnBuffer>;  // New output of each node that streamed
+    data::SpscRingBuffer<StreamBlock> streamBlocks_;
+    TripleBuffer<std::shared_ptr<const ProcessingResult>> results_;
+    std::shared_ptr<const ProcessingResult> latestResult_;  // Owner side
+
+    uint64_t nextNodeId_ = 0;    // Owner side
+    uint64_t nextRevision_ = 0;  // Owner side
+    uint64_t requestedRevision_ = 0;  // Worker side
+    uint64_t processedRevision_ = 0;  // Worker side
+    std::atomic<uint64_t> droppedBlocks_{0};
+    std::atomic<bool> running_{true};
+
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    std::thread worker_;
+};
+
+} // namespace pipeline
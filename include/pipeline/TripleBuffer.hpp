@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace pipeline {
+
+// Lock-free hand-over of the latest value from one writer thread to one
+// reader thread. Double buffering with a spare slot: the writer fills the back
+// slot and swaps it with the spare, the reader swaps the spare in as its front
+// slot when it is newer, so neither side ever waits for the other.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side: fill back(), then publish() it
+    T& back() { return slots_[backIndex_]; }
+
+    void publish() {
+        const uint8_t previous = spare_.exchange(static_cast<uint8_t>(backIndex_ | kFresh), std::memory_order_acq_rel);
+        backIndex_ = previous & kIndexMask;
+    }
+
+    // Reader side: take the newest published value if there is one.
+    // Returns true if front() changed.
+    bool update() {
+        if ((spare_.load(std::memory_order_acquire) & kFresh) == 0) {
+            return false;
+        }
+        const uint8_t previous = spare_.exchange(frontIndex_, std::memory_order_acq_rel);
+        frontIndex_ = previous & kIndexMask;
+        return true;
+    }
+
+    const T& front() const { return slots_[frontIndex_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;  // Set when the spare slot holds an unread value
+
+    std::array<T, 3> slots_{};
+    std::atomic<uint8_t> spare_{1};
+    uint8_t frontIndex_ = 0;  // Reader only
+    uint8_t backIndex_ = 2;   // Writer only
+};
+
+} // namespace pipeline
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <cstdint>
+
+namespace pipeline {
+
+class FilterPipeline;
+
+// Out-of-core processing: streams bounded windows of a log from disk through
+// the pipeline's streaming path and appends the filtered output to a CSV file,
+// so memory use is set by the budget rather than by the size of the log.
+class WindowedProcessor {
+public:
+    // Called after every window with bytes read and total bytes (0 if
+    // unknown); return false to cancel
+    using ProgressCallback = std::function<bool(uint64_t bytesRead, uint64_t totalBytes)>;
+
+    explicit WindowedProcessor(FilterPipeline& pipeline, size_t memoryBudgetBytes = 64 * 1024 * 1024);
+
+    // Set the memory budget for buffered samples (input, output and timestamps)
+    void setMemoryBudget(size_t bytes) { memoryBudgetBytes_ = bytes; }
+    size_t getMemoryBudget() const { return memoryBudgetBytes_; }
+
+    void setProgressCallback(ProgressCallback callback) { progressCallback_ = std::move(callback); }
+
+    // Filter one column of a text log, feeding it in at sourceNodeId
+    bool processLogFile(const std::string& inputFile, const std::string& columnName,
+                        const std::string& sourceNodeId, const std::string& outputFile);
+
+    // Filter one field of a WPILib log, feeding it in at sourceNodeId
+    bool processWpiLog(const std::string& inputFile, const std::string& fieldName,
+                       const std::string& sourceNodeId, const std::string& outputFile);
+
+    // Number of samples written by the last run
+    size_t getProcessedSamples() const { return processedSamples_; }
+
+private:
+    size_t windowRows() const;
+    bool writeWindow(const std::string& sourceNodeId, const std::vector<double>& timestamps,
+                     const std::vector<double>& values, double timestampScale = 1.0);
+
+    FilterPipeline& pipeline_;
+    size_t memoryBudgetBytes_;
+    ProgressCallback progressCallback_;
+    std::ofstream output_;
+    size_t processedSamples_ = 0;
+};
+
+// A WindowedProcessor run over a whole log on a thread of its own, through a
+// detached copy of the graph, so the live pipeline keeps its state and goes
+// on streaming meanwhile
+class WindowedRun {
+public:
+    enum class State {
+        Queued,
+        Running,
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    WindowedRun() = default;
+    ~WindowedRun();
+
+    WindowedRun(const WindowedRun&) = delete;
+    WindowedRun& operator=(const WindowedRun&) = delete;
+
+    // Filter field (a column of a text log, or a field of a wpilog) of
+    // inputFile, fed in at sourceNodeId, into a CSV file. Call once.
+    void start(const FilterPipeline& pipeline, const std::string& inputFile, const std::string& field,
+               bool wpilog, const std::string& sourceNodeId, const std::string& outputFile);
+    void cancel();
+
+    // Safe to call from any thread
+    State getState() const { return state_.load(); }
+    double getProgress() const;
+    size_t getProcessedSamples() const { return processedSamples_.load(); }
+
+private:
+    std::unique_ptr<FilterPipeline> pipeline_;
+    std::thread thread_;
+    std::atomic<State> state_{State::Queued};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<uint64_t> bytesRead_{0};
+    std::atomic<uint64_t> totalBytes_{0};
+    std::atomic<size_t> processedSamples_{0};
+};
+
+} // namespace pipeline
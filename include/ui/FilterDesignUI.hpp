@@ -13,7 +13,15 @@
 #include "../../implot/implot.h"
 #include "../filter/Filter.hpp"
 #include "../filter/InputNodes.hpp"
+#include "../filter/OutputSink.hpp"
+#include "../filter/SpectrumAnalyzer.hpp"
+#include "../filter/CrossCorrelation.hpp"
 #include "../pipeline/FilterPipeline.hpp"
+#include "../pipeline/ProcessingWorker.hpp"
+#include "../pipeline/ParameterSweep.hpp"
+#include "../pipeline/WindowedProcessor.hpp"
+#include "../data/MinMaxPyramid.hpp"
+#include "../data/WpiLogRecorder.hpp"
 
 namespace pipeline {
     class FilterPipeline;
@@ -44,11 +52,20 @@ private:
             Input,
             Output,
             LogFileInput,
+            LogReplayInput,
             NetworkTableInput,
+            MultiColumnInput,
             Butterworth,
             Chebyshev,
             Notch,
-            BandPass
+            BandPass,
+            Median,
+            Percentile,
+            TrimmedMean,
+            Kalman,
+            PowerSpectrum,
+            Spectrogram,
+            CrossCorrelation
         };
 
         int id;
@@ -65,7 +82,26 @@ private:
         std::string networkTableName;
         std::string networkTableKey;
         std::string networkTableIP;
-        std::unique_ptr<filter::InputNode> inputNode;
+        int networkTableHistory = 0;  // Samples kept for batch runs; 0 streams only
+        bool followLog = false;
+        bool loading = false;  // The input was loading in the background at the last check
+        float replaySpeed = 1.0f;
+        bool replayAsFast = false;
+        bool replayLoop = false;
+        bool resample = false;
+        float resampleRate = 50.0f;
+        int resampleMethod = static_cast<int>(filter::Interpolation::Linear);
+        float resampleMaxGap = 0.5f;
+        std::string columnPattern;
+        std::vector<std::string> selectedColumns;
+        std::shared_ptr<filter::InputNode> inputNode;  // Shared with the pipeline worker
+
+        // Output node parameters
+        std::string outputFilename;
+        int outputFormat = static_cast<int>(filter::OutputSink::Format::Csv);
+        float outputRate = 50.0f;
+        std::shared_ptr<filter::OutputSink> outputSink;  // Written by the pipeline worker
+        std::shared_ptr<pipeline::WindowedRun> fileRun;  // Whole-file run of the log feeding this output
         
         // Filter parameters
         int order = 2;
@@ -73,6 +109,46 @@ private:
         double sampleRate = 44100.0;
         double ripple = 1.0;
         double bandwidth = 100.0;
+
+        // Order-statistic filter parameters
+        int windowSize = 5;
+        float percentile = 50.0f;
+        float trimFraction = 0.25f;
+
+        // Kalman filter parameters
+        int kalmanModel = 0;  // filter::KinematicModel
+        int kalmanOutput = 0; // Position, velocity, acceleration
+        bool kalmanSteadyState = true;
+        float kalmanRate = 50.0f;
+        float kalmanProcessNoise = 1.0f;
+        float kalmanMeasurementNoise = 0.1f;
+
+        // Spectral analysis parameters
+        int spectrumSegment = 1024;
+        float spectrumOverlap = 0.5f;
+        int spectrumWindow = static_cast<int>(filter::WindowType::Hann);
+        float spectrumRate = 50.0f;  // Linear filters use their design rate instead
+        std::shared_ptr<filter::SpectrumAnalyzer> analyzer;       // Node output, fed by the pipeline worker
+        std::shared_ptr<filter::SpectrumAnalyzer> inputAnalyzer;  // Node input, filter nodes only
+
+        // Spectrogram image, copied only when the analyzer has new columns
+        struct SpectrogramView {
+            std::vector<double> image;
+            uint64_t revision = 0;
+            size_t columns = 0;
+            double startTime = 0.0;
+            double endTime = 0.0;
+            double minDb = 0.0;
+            double maxDb = 0.0;
+        };
+        SpectrogramView spectrogram;
+
+        // Cross-correlation parameters
+        float correlationRate = 50.0f;
+        float correlationMaxLag = 0.5f;   // Seconds searched each way
+        bool correlationSliding = false;
+        float correlationWindow = 5.0f;   // Seconds
+        std::shared_ptr<filter::CrossCorrelator> correlator;  // Fed by the pipeline worker
         
         // UI parameters
         float ui_cutoffFreq = static_cast<float>(cutoffFreq);
@@ -85,10 +161,32 @@ private:
         std::vector<double> a;  // Denominator coefficients
         std::vector<std::complex<double>> poles;
         std::vector<std::complex<double>> zeros;
+        std::vector<double> responseFrequencies;  // Designed magnitude response
+        std::vector<double> responseDb;
         std::vector<double> xHistory;  // Input history
         std::vector<double> yHistory;  // Output history
         std::vector<double> inputData;
-        std::vector<double> outputData;
+        filter::ColumnBuffer outputData;                     // Shared with the worker's last result
+        std::shared_ptr<data::MinMaxPyramid> outputPyramid;  // Plot summary of outputData
+        std::vector<pipeline::ChannelResult> channelOutputs; // Multi-column inputs, one per column
+
+        bool isOrderStatistic() const {
+            return nodeType == NodeType::Median ||
+                   nodeType == NodeType::Percentile ||
+                   nodeType == NodeType::TrimmedMean;
+        }
+
+        bool isAnalysis() const {
+            return nodeType == NodeType::PowerSpectrum ||
+                   nodeType == NodeType::Spectrogram;
+        }
+
+        bool isInput() const {
+            return nodeType == NodeType::LogFileInput ||
+                   nodeType == NodeType::LogReplayInput ||
+                   nodeType == NodeType::NetworkTableInput ||
+                   nodeType == NodeType::MultiColumnInput;
+        }
 
         // Move constructor
         Node(Node&& other) noexcept
@@ -104,12 +202,50 @@ private:
             , networkTableName(std::move(other.networkTableName))
             , networkTableKey(std::move(other.networkTableKey))
             , networkTableIP(std::move(other.networkTableIP))
+            , networkTableHistory(other.networkTableHistory)
+            , followLog(other.followLog)
+            , loading(other.loading)
+            , replaySpeed(other.replaySpeed)
+            , replayAsFast(other.replayAsFast)
+            , replayLoop(other.replayLoop)
+            , resample(other.resample)
+            , resampleRate(other.resampleRate)
+            , resampleMethod(other.resampleMethod)
+            , resampleMaxGap(other.resampleMaxGap)
+            , columnPattern(std::move(other.columnPattern))
+            , selectedColumns(std::move(other.selectedColumns))
             , inputNode(std::move(other.inputNode))
+            , outputFilename(std::move(other.outputFilename))
+            , outputFormat(other.outputFormat)
+            , outputRate(other.outputRate)
+            , outputSink(std::move(other.outputSink))
+            , fileRun(std::move(other.fileRun))
             , order(other.order)
             , cutoffFreq(other.cutoffFreq)
             , sampleRate(other.sampleRate)
             , ripple(other.ripple)
             , bandwidth(other.bandwidth)
+            , windowSize(other.windowSize)
+            , percentile(other.percentile)
+            , trimFraction(other.trimFraction)
+            , kalmanModel(other.kalmanModel)
+            , kalmanOutput(other.kalmanOutput)
+            , kalmanSteadyState(other.kalmanSteadyState)
+            , kalmanRate(other.kalmanRate)
+            , kalmanProcessNoise(other.kalmanProcessNoise)
+            , kalmanMeasurementNoise(other.kalmanMeasurementNoise)
+            , spectrumSegment(other.spectrumSegment)
+            , spectrumOverlap(other.spectrumOverlap)
+            , spectrumWindow(other.spectrumWindow)
+            , spectrumRate(other.spectrumRate)
+            , analyzer(std::move(other.analyzer))
+            , inputAnalyzer(std::move(other.inputAnalyzer))
+            , spectrogram(std::move(other.spectrogram))
+            , correlationRate(other.correlationRate)
+            , correlationMaxLag(other.correlationMaxLag)
+            , correlationSliding(other.correlationSliding)
+            , correlationWindow(other.correlationWindow)
+            , correlator(std::move(other.correlator))
             , ui_cutoffFreq(other.ui_cutoffFreq)
             , ui_sampleRate(other.ui_sampleRate)
             , ui_ripple(other.ui_ripple)
@@ -118,10 +254,14 @@ private:
             , a(std::move(other.a))
             , poles(std::move(other.poles))
             , zeros(std::move(other.zeros))
+            , responseFrequencies(std::move(other.responseFrequencies))
+            , responseDb(std::move(other.responseDb))
             , xHistory(std::move(other.xHistory))
             , yHistory(std::move(other.yHistory))
             , inputData(std::move(other.inputData))
             , outputData(std::move(other.outputData))
+            , outputPyramid(std::move(other.outputPyramid))
+            , channelOutputs(std::move(other.channelOutputs))
         {}
 
         // Move assignment operator
@@ -139,12 +279,50 @@ private:
                 networkTableName = std::move(other.networkTableName);
                 networkTableKey = std::move(other.networkTableKey);
                 networkTableIP = std::move(other.networkTableIP);
+                networkTableHistory = other.networkTableHistory;
+                followLog = other.followLog;
+                loading = other.loading;
+                replaySpeed = other.replaySpeed;
+                replayAsFast = other.replayAsFast;
+                replayLoop = other.replayLoop;
+                resample = other.resample;
+                resampleRate = other.resampleRate;
+                resampleMethod = other.resampleMethod;
+                resampleMaxGap = other.resampleMaxGap;
+                columnPattern = std::move(other.columnPattern);
+                selectedColumns = std::move(other.selectedColumns);
                 inputNode = std::move(other.inputNode);
+                outputFilename = std::move(other.outputFilename);
+                outputFormat = other.outputFormat;
+                outputRate = other.outputRate;
+                outputSink = std::move(other.outputSink);
+                fileRun = std::move(other.fileRun);
                 order = other.order;
                 cutoffFreq = other.cutoffFreq;
                 sampleRate = other.sampleRate;
                 ripple = other.ripple;
                 bandwidth = other.bandwidth;
+                windowSize = other.windowSize;
+                percentile = other.percentile;
+                trimFraction = other.trimFraction;
+                kalmanModel = other.kalmanModel;
+                kalmanOutput = other.kalmanOutput;
+                kalmanSteadyState = other.kalmanSteadyState;
+                kalmanRate = other.kalmanRate;
+                kalmanProcessNoise = other.kalmanProcessNoise;
+                kalmanMeasurementNoise = other.kalmanMeasurementNoise;
+                spectrumSegment = other.spectrumSegment;
+                spectrumOverlap = other.spectrumOverlap;
+                spectrumWindow = other.spectrumWindow;
+                spectrumRate = other.spectrumRate;
+                analyzer = std::move(other.analyzer);
+                inputAnalyzer = std::move(other.inputAnalyzer);
+                spectrogram = std::move(other.spectrogram);
+                correlationRate = other.correlationRate;
+                correlationMaxLag = other.correlationMaxLag;
+                correlationSliding = other.correlationSliding;
+                correlationWindow = other.correlationWindow;
+                correlator = std::move(other.correlator);
                 ui_cutoffFreq = other.ui_cutoffFreq;
                 ui_sampleRate = other.ui_sampleRate;
                 ui_ripple = other.ui_ripple;
@@ -153,10 +331,14 @@ private:
                 a = std::move(other.a);
                 poles = std::move(other.poles);
                 zeros = std::move(other.zeros);
+                responseFrequencies = std::move(other.responseFrequencies);
+                responseDb = std::move(other.responseDb);
                 xHistory = std::move(other.xHistory);
                 yHistory = std::move(other.yHistory);
                 inputData = std::move(other.inputData);
                 outputData = std::move(other.outputData);
+                outputPyramid = std::move(other.outputPyramid);
+                channelOutputs = std::move(other.channelOutputs);
             }
             return *this;
         }
@@ -186,10 +368,35 @@ private:
     void renderNode(int nodeId, const std::string& title);
     void renderFilterParameters(int nodeId);
     void renderInputParameters(int nodeId);
+    void renderOutputParameters(int nodeId);
+    void renderFileRun(Node& node);
+    const Node* findSourceInput(int nodeId) const;
+    void renderOrderStatisticParameters(int nodeId);
+    void renderKalmanParameters(int nodeId);
     void renderFrequencyResponse(int nodeId);
+    void renderSpectrumParameters(int nodeId);
+    void renderPowerSpectrum(int nodeId);
+    void renderSpectrogram(int nodeId);
+    void attachAnalyzers(Node& node);
+    filter::SpectrumOptions spectrumOptions(const Node& node) const;
+    void renderCorrelation(int nodeId);
+    void updateCorrelator(Node& node, bool rebuild = false);
     void renderPoleZeroPlot(int nodeId);
+    void renderSignalPlot(int nodeId);
     void renderCodeExport(int nodeId);
     void processFilters();
+    void collectResults();
+    void appendOutput(Node& node, const std::vector<double>& samples);
+    void setNodeInput(Node& node, std::shared_ptr<filter::InputNode> inputNode);
+    void startRecording(const std::string& filename);
+    void stopRecording();
+    void attachRecorder(Node& node);
+    void detachRecorder(Node& node);
+    void renderRecordingMenu();
+    void renderSweepWindow();
+    void startSweep();
+    void updateNodeResampling(Node& node);
+    void renderResampleParameters(Node& node);
     void updatePipelineNode(Node& node) const;
     void updatePipelineConnections();
     void calculateFilterCoefficients(Node& node);
@@ -207,13 +414,59 @@ private:
 
     // Helper function for file dialogs
     bool openFileDialog(std::string& outPath);
+    bool saveFileDialog(std::string& outPath);
 
     GLFWwindow* window_ = nullptr;
     std::map<int, Node> nodes_;
     std::map<int, Link> links_;
     int nextNodeId_ = 1;
     int nextLinkId_ = 1;
-    std::unique_ptr<pipeline::FilterPipeline> pipeline_;
+    std::unique_ptr<pipeline::ProcessingWorker> worker_;
+    uint64_t shownRevision_ = 0;  // Revision of the batch result the nodes show
+
+    // Live recording of NT inputs and outputs; null when not recording
+    std::unique_ptr<data::WpiLogRecorder> recorder_;
+    std::map<int, std::shared_ptr<data::WpiLogRecorder::Channel>> recordChannels_;  // By node id
+
+    // Parameter sweep panel
+    struct SweepSettings {
+        int sourceNode = -1;
+        bool firstOrder = true;
+        bool butterworth = true;
+        bool chebyshev = false;
+        int minOrder = 1;
+        int maxOrder = 4;
+        float minCutoff = 0.5f;
+        float maxCutoff = 50.0f;
+        int cutoffCount = 40;
+        float sampleRate = 100.0f;
+        float ripple = 1.0f;
+        int heatmapType = 1;    // Index into the design types
+        int heatmapMetric = 0;
+    };
+    bool showSweep_ = false;
+    SweepSettings sweepSettings_;
+    pipeline::ParameterSweep sweep_;
+    std::vector<double> sweepHeatmap_;  // Scratch, rebuilt each frame
+
+    // Streamed output collected each frame by pipeline node id, reused across frames
+    std::map<std::string, std::vector<double>> streamOutputs_;
+
+    // Scratch buffers for decimated plot lines, reused across frames
+    std::vector<double> plotX_;
+    std::vector<double> plotY_;
+
+    // Scratch buffers for spectra, reused across frames
+    std::vector<double> spectrumFrequencies_;
+    std::vector<double> inputSpectrum_;
+    std::vector<double> outputSpectrum_;
+    std::vector<double> measuredResponse_;
+
+    // Scratch buffers for correlation plots, reused across frames
+    std::vector<double> correlationLags_;
+    std::vector<double> correlationValues_;
+    std::vector<double> correlationTimes_;
+    std::vector<double> correlationCoefficients_;
 };
 
 } // namespace ui 
\ No newline at end of file
@@ -1,108 +1,277 @@
 #include "../include/LogLoader.hpp"
-#include <iostream>
-#include <fstream>
-#include <wpigui/DataLogReader.h>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
 
 LogLoader::LogLoader() = default;
 LogLoader::~LogLoader() = default;
 
 void LogLoader::Clear() {
-    m_entries.clear();
+    m_columns.clear();
     m_fields.clear();
-    m_entryNames.clear();
+    m_fieldIndex.clear();
+    m_entryColumns.clear();
+    m_slotColumns.clear();
+    m_entries.clear();
+    m_entriesBuilt = false;
+    m_reader.close();
 }
 
 bool LogLoader::LoadFile(const std::string& filename) {
     Clear();
 
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
+    // The log is memory-mapped; compressed logs are decompressed into memory
+    if (!m_reader.open(filename)) {
         return false;
     }
 
-    wpigui::DataLogReader reader(file);
-    if (!reader.IsValid()) {
-        return false;
+    // Segments of the record stream are decoded on several threads
+    data::CompositeColumns composites;
+    data::ScalarColumns decoded = data::decodeScalarColumns(m_reader, {}, &composites);
+    const data::CompositeLayouts layouts = data::buildCompositeLayouts(m_reader);
+
+    // Fields in entry id order; the pre-scan has seen every start record. A
+    // restarted entry id has one definition per start record, and each one's
+    // records go to the field it was named when they were written.
+    std::vector<const data::wpilog::EntryInfo*> definitions = m_reader.getDefinitions();
+    std::stable_sort(definitions.begin(), definitions.end(),
+        [](const data::wpilog::EntryInfo* a, const data::wpilog::EntryInfo* b) { return a->entry < b->entry; });
+    for (const data::wpilog::EntryInfo* info : definitions) {
+        const size_t index = AddField(info->name, info->type);
+
+        // Hand the decoded columns over without copying
+        auto column = decoded.find(info->startOffset);
+        if (column != decoded.end()) {
+            MergeColumn(index, column->second);
+        }
+
+        // Array elements and struct members become fields of their own, in slot order
+        auto slots = composites.find(info->startOffset);
+        auto layout = layouts.find(info->startOffset);
+        if (slots == composites.end() || layout == layouts.end()) {
+            continue;
+        }
+        for (size_t slot = 0; slot < slots->second.size(); ++slot) {
+            MergeColumn(AddSlotField(*info, layout->second, slot), slots->second[slot]);
+        }
     }
 
-    while (auto record = reader.Next()) {
-        ProcessRecord(*record);
+    // Plot summaries, built once per column while the data is hot in cache
+    for (auto& column : m_columns) {
+        column.pyramid.build(column.values);
     }
 
+    m_reader.close();
     return true;
 }
 
-void LogLoader::ProcessRecord(const wpigui::DataLogReader::Record& record) {
-    switch (record.type) {
-        case wpigui::DataLogReader::RecordType::kStart:
-            ProcessControlRecord(record);
-            break;
-        case wpigui::DataLogReader::RecordType::kFinish:
-            // Handle finish record if needed
-            break;
-        case wpigui::DataLogReader::RecordType::kSetMetadata:
-            // Handle metadata if needed
-            break;
-        case wpigui::DataLogReader::RecordType::kData:
-            ProcessDataRecord(record);
-            break;
+size_t LogLoader::AddField(const std::string& name, const std::string& type) {
+    auto it = m_fieldIndex.find(name);
+    if (it != m_fieldIndex.end()) {
+        return it->second;
+    }
+
+    m_columns.push_back({name, type, {}, {}, {}});
+    m_fields.push_back(name);
+    m_fieldIndex[name] = m_columns.size() - 1;
+    return m_columns.size() - 1;
+}
+
+size_t LogLoader::AddSlotField(const data::wpilog::EntryInfo& info, const data::wpilog::CompositeLayout& layout,
+                               size_t slot) {
+    auto& slotColumns = m_slotColumns[info.startOffset];
+    while (slotColumns.size() <= slot) {
+        const std::string name = info.name + data::wpilog::compositeSlotName(layout, slotColumns.size());
+        // Slots are decoded to doubles regardless of the element type
+        slotColumns.push_back(AddField(name, "double"));
     }
+    return slotColumns[slot];
 }
 
-void LogLoader::ProcessControlRecord(const wpigui::DataLogReader::Record& record) {
-    if (record.type != wpigui::DataLogReader::RecordType::kStart) {
+void LogLoader::MergeColumn(size_t index, data::ScalarColumn& column) {
+    LogColumn& target = m_columns[index];
+    if (target.timestamps.empty()) {
+        target.timestamps = std::move(column.timestamps);
+        target.values = std::move(column.values);
         return;
     }
 
-    // Store the entry name mapping
-    m_entryNames[record.entry] = record.name;
-    
-    // Add to fields list if not already present
-    if (std::find(m_fields.begin(), m_fields.end(), record.name) == m_fields.end()) {
-        m_fields.push_back(record.name);
+    // Several entry ids logged under one name
+    target.timestamps.insert(target.timestamps.end(), column.timestamps.begin(), column.timestamps.end());
+    target.values.insert(target.values.end(), column.values.begin(), column.values.end());
+    data::ScalarColumn merged{std::move(target.timestamps), std::move(target.values)};
+    data::sortColumnByTimestamp(merged);
+    target.timestamps = std::move(merged.timestamps);
+    target.values = std::move(merged.values);
+}
+
+const LogColumn* LogLoader::GetColumn(const std::string& field) const {
+    auto it = m_fieldIndex.find(field);
+    return it != m_fieldIndex.end() ? &m_columns[it->second] : nullptr;
+}
+
+const std::vector<LogEntry>& LogLoader::GetEntries() const {
+    if (m_entriesBuilt) {
+        return m_entries;
+    }
+    m_entriesBuilt = true;
+
+    // Merge the columns into rows in timestamp order
+    using Cursor = std::pair<int64_t, size_t>;  // (timestamp, column)
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heads;
+    std::vector<size_t> positions(m_columns.size(), 0);
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        if (!m_columns[i].timestamps.empty()) {
+            heads.push({m_columns[i].timestamps.front(), i});
+        }
+    }
+    while (!heads.empty()) {
+        auto [timestamp, index] = heads.top();
+        heads.pop();
+
+        const LogColumn& column = m_columns[index];
+        size_t& position = positions[index];
+        if (m_entries.empty() || m_entries.back().timestamp != static_cast<double>(timestamp)) {
+            m_entries.push_back({static_cast<double>(timestamp), {}});
+        }
+        m_entries.back().values[column.name] = column.values[position];
+
+        if (++position < column.timestamps.size()) {
+            heads.push({column.timestamps[position], index});
+        }
     }
+
+    return m_entries;
 }
 
-void LogLoader::ProcessDataRecord(const wpigui::DataLogReader::Record& record) {
-    if (record.type != wpigui::DataLogReader::RecordType::kData) {
+void LogLoader::ProcessControlRecord(const data::wpilog::RecordView& record) {
+    uint32_t entryId = 0;
+    if (record.size < 1 || record.payload[0] != static_cast<uint8_t>(data::wpilog::ControlType::Start) ||
+        !data::wpilog::parseControlEntry(record.payload, record.size, entryId)) {
         return;
     }
 
-    // Find or create entry for this timestamp
-    LogEntry* entry = nullptr;
-    if (!m_entries.empty() && m_entries.back().timestamp == record.timestamp) {
-        entry = &m_entries.back();
-    } else {
-        m_entries.push_back({record.timestamp, {}});
-        entry = &m_entries.back();
+    const data::wpilog::EntryInfo* info = m_reader.getEntry(entryId);
+    if (!info) {
+        return;
     }
 
-    // Get the field name for this entry ID
-    auto it = m_entryNames.find(record.entry);
-    if (it == m_entryNames.end()) {
-        return;  // Skip if we don't know the field name
+    // Map the entry id to its field; names are deduplicated through the hash map
+    m_entryColumns[entryId] = AddField(info->name, info->type);
+}
+
+bool LogLoader::DecodeScalar(const data::wpilog::RecordView& record, double& value) const {
+    // Decoded straight out of the mapping
+    const data::wpilog::EntryInfo* info = m_reader.getEntry(record.entry);
+    return info && data::wpilog::decodeScalar(info->scalarType, record.payload, record.size, value);
+}
+
+bool LogLoader::StreamFile(const std::string& filename, size_t memoryBudgetBytes, const ChunkCallback& callback,
+                           const std::vector<std::string>& fields) {
+    Clear();
+
+    // The mapping is paged in on demand, so only the buffered chunks count against the budget
+    if (!m_reader.open(filename)) {
+        return false;
     }
 
-    // Convert the data to double based on type
-    double value = 0.0;
-    switch (record.dataType) {
-        case wpigui::DataLogReader::DataType::kBoolean:
-            value = record.GetBoolean() ? 1.0 : 0.0;
-            break;
-        case wpigui::DataLogReader::DataType::kInteger:
-            value = static_cast<double>(record.GetInteger());
-            break;
-        case wpigui::DataLogReader::DataType::kFloat:
-            value = static_cast<double>(record.GetFloat());
-            break;
-        case wpigui::DataLogReader::DataType::kDouble:
-            value = record.GetDouble();
-            break;
-        default:
-            return;  // Skip unsupported types
+    struct FieldChunk {
+        std::vector<double> timestamps;
+        std::vector<double> values;
+    };
+    std::map<size_t, FieldChunk> chunks;  // Column index -> buffered samples
+    std::unordered_map<uint64_t, data::wpilog::CompositeLayout> layouts;  // By definition (start offset)
+    std::vector<double> slots;
+    const size_t maxBufferedSamples = std::max<size_t>(1, memoryBudgetBytes / (2 * sizeof(double)));
+    size_t bufferedSamples = 0;
+
+    // Whether each column is requested, worked out once per column. An
+    // array or struct entry counts if any of its elements or members does.
+    const std::unordered_set<std::string> requested(fields.begin(), fields.end());
+    std::vector<char> columnRequested;
+    auto isRequested = [&](size_t index) {
+        while (columnRequested.size() <= index) {
+            const std::string& name = m_columns[columnRequested.size()].name;
+            bool wanted = requested.empty() || requested.count(name) != 0;
+            for (auto it = requested.begin(); !wanted && it != requested.end(); ++it) {
+                wanted = it->size() > name.size() && it->compare(0, name.size(), name) == 0 &&
+                         ((*it)[name.size()] == '[' || (*it)[name.size()] == '/');
+            }
+            columnRequested.push_back(wanted ? 1 : 0);
+        }
+        return columnRequested[index] != 0;
+    };
+
+    auto flush = [&]() {
+        for (auto& [index, chunk] : chunks) {
+            if (chunk.values.empty()) {
+                continue;
+            }
+            if (!callback(m_columns[index].name, chunk.timestamps, chunk.values)) {
+                return false;
+            }
+            chunk.timestamps.clear();
+            chunk.values.clear();
+        }
+        bufferedSamples = 0;
+        return true;
+    };
+
+    data::wpilog::RecordView record;
+    while (m_reader.next(record)) {
+        if (record.isControl()) {
+            ProcessControlRecord(record);
+            continue;
+        }
+        auto column = m_entryColumns.find(record.entry);
+        if (column == m_entryColumns.end() || !isRequested(column->second)) {
+            continue;
+        }
+
+        double value = 0.0;
+        if (DecodeScalar(record, value)) {
+            auto& chunk = chunks[column->second];
+            chunk.timestamps.push_back(static_cast<double>(record.timestamp));
+            chunk.values.push_back(value);
+            ++bufferedSamples;
+        } else {
+            // Array or struct entry; the layout is resolved once the schema has
+            // been seen. Records are read in order, so the entry table holds
+            // the definition this record was written under.
+            const auto* info = m_reader.getEntry(record.entry);
+            if (!info) {
+                continue;
+            }
+            auto layout = layouts.find(info->startOffset);
+            if (layout == layouts.end()) {
+                data::wpilog::CompositeLayout built;
+                if (!data::wpilog::buildCompositeLayout(info->type, m_reader.getStructSchemas(), built)) {
+                    continue;
+                }
+                layout = layouts.emplace(info->startOffset, std::move(built)).first;
+            }
+            data::wpilog::decodeComposite(layout->second, record.payload, record.size, slots);
+            for (size_t slot = 0; slot < slots.size(); ++slot) {
+                const size_t index = AddSlotField(*info, layout->second, slot);
+                if (!isRequested(index)) {
+                    continue;
+                }
+                auto& chunk = chunks[index];
+                chunk.timestamps.push_back(static_cast<double>(record.timestamp));
+                chunk.values.push_back(slots[slot]);
+                ++bufferedSamples;
+            }
+        }
+
+        if (bufferedSamples >= maxBufferedSamples && !flush()) {
+            m_reader.close();
+            return false;
+        }
     }
 
-    // Store the value
-    entry->values[it->second] = value;
-} 
-} 
\ No newline at end of file
+    bool ok = flush();
+    m_reader.close();
+    return ok;
+}
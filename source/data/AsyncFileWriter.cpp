@@ -0,0 +1,149 @@
+#include "../../include/data/AsyncFileWriter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace data {
+
+AsyncFileWriter::AsyncFileWriter(size_t bufferSize, size_t bufferCount)
+    : bufferSize_(std::max<size_t>(bufferSize, kBufferAlignment)) {
+    // At least two, so the caller can fill one while another is written
+    bufferCount = std::max<size_t>(bufferCount, 2);
+    for (size_t i = 0; i < bufferCount; ++i) {
+        allocations_.push_back(static_cast<char*>(::operator new(bufferSize_, std::align_val_t(kBufferAlignment))));
+    }
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+    for (char* allocation : allocations_) {
+        ::operator delete(allocation, std::align_val_t(kBufferAlignment));
+    }
+}
+
+bool AsyncFileWriter::open(const std::string& filename) {
+    close();
+
+    // A file that cannot be created counts as a write error, so callers
+    // that only poll hasFailed() still see it
+    file_ = std::fopen(filename.c_str(), "wb");
+    if (!file_) {
+        failed_ = true;
+        return false;
+    }
+    // The buffers are already large; skip stdio's own copy
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+
+    failed_ = false;
+    bytesWritten_ = 0;
+    closing_ = false;
+    full_.clear();
+    free_.assign(allocations_.begin() + 1, allocations_.end());
+    current_ = {allocations_.front(), 0};
+    writer_ = std::thread(&AsyncFileWriter::writerLoop, this);
+    return true;
+}
+
+char* AsyncFileWriter::reserve(size_t size) {
+    if (!file_ || failed_ || size > bufferSize_) {
+        return nullptr;
+    }
+    if (bufferSize_ - current_.size < size) {
+        submitCurrent();
+    }
+    return current_.data + current_.size;
+}
+
+void AsyncFileWriter::commit(size_t size) {
+    current_.size += size;
+}
+
+bool AsyncFileWriter::write(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        if (!file_ || failed_) {
+            return false;
+        }
+        if (current_.size == bufferSize_) {
+            submitCurrent();
+        }
+        const size_t chunk = std::min(size, bufferSize_ - current_.size);
+        std::memcpy(current_.data + current_.size, bytes, chunk);
+        current_.size += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+    return !failed_;
+}
+
+bool AsyncFileWriter::flush() {
+    if (!file_) {
+        return false;
+    }
+    if (current_.size > 0) {
+        submitCurrent();
+    }
+    return !failed_;
+}
+
+bool AsyncFileWriter::close() {
+    if (!file_) {
+        return !failed_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current_.size > 0) {
+            full_.push_back(current_);
+        }
+        current_ = {};
+        closing_ = true;
+    }
+    queued_.notify_one();
+    writer_.join();
+
+    if (std::fclose(file_) != 0) {
+        failed_ = true;
+    }
+    file_ = nullptr;
+    return !failed_;
+}
+
+void AsyncFileWriter::submitCurrent() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    full_.push_back(current_);
+    queued_.notify_one();
+
+    // Backpressure: wait until the writer hands a buffer back
+    released_.wait(lock, [this]() { return !free_.empty(); });
+    current_ = {free_.back(), 0};
+    free_.pop_back();
+}
+
+void AsyncFileWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        queued_.wait(lock, [this]() { return closing_ || !full_.empty(); });
+        if (full_.empty()) {
+            return;
+        }
+        Buffer buffer = full_.front();
+        full_.pop_front();
+
+        // The disk write happens without the lock so the caller keeps filling
+        lock.unlock();
+        if (!failed_) {
+            if (std::fwrite(buffer.data, 1, buffer.size, file_) == buffer.size) {
+                bytesWritten_ += buffer.size;
+            } else {
+                failed_ = true;
+            }
+        }
+        lock.lock();
+
+        free_.push_back(buffer.data);
+        released_.notify_one();
+    }
+}
+
+} // namespace data
@@ -0,0 +1,245 @@
+#include "../../include/data/CompressedStream.hpp"
+#include <zlib.h>
+#include <zstd.h>
+#include <cstring>
+
+namespace data {
+
+namespace {
+// Size of each decompressed chunk handed to the reader
+constexpr size_t kChunkSize = 1 << 20;
+// Number of decompressed chunks that may be queued ahead of the reader
+constexpr size_t kMaxQueuedChunks = 4;
+// Size of the compressed read buffer
+constexpr size_t kInputSize = 256 * 1024;
+}
+
+Compression detectCompression(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    unsigned char magic[4] = {0};
+    if (!file.read(reinterpret_cast<char*>(magic), sizeof(magic))) {
+        return Compression::None;
+    }
+
+    if (magic[0] == 0x1f && magic[1] == 0x8b) {
+        return Compression::Gzip;
+    }
+    if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+DecompressingStreamBuf::DecompressingStreamBuf(const std::string& filename, Compression compression)
+    : file_(filename, std::ios::binary), compression_(compression) {
+    if (!file_.is_open()) {
+        failed_ = true;
+        finished_ = true;
+        return;
+    }
+    worker_ = std::thread(&DecompressingStreamBuf::decompressLoop, this);
+}
+
+DecompressingStreamBuf::~DecompressingStreamBuf() {
+    stopping_ = true;
+    queueCondition_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+DecompressingStreamBuf::int_type DecompressingStreamBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    queueCondition_.wait(lock, [this] { return !chunks_.empty() || finished_; });
+    if (chunks_.empty()) {
+        // Not a clean end of file; the istream turns this into badbit
+        if (failed_) {
+            throw std::ios_base::failure("Decompression failed");
+        }
+        return traits_type::eof();
+    }
+
+    current_ = std::move(chunks_.front());
+    chunks_.pop_front();
+    lock.unlock();
+    queueCondition_.notify_all();
+
+    setg(current_.data(), current_.data(), current_.data() + current_.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+void DecompressingStreamBuf::decompressLoop() {
+    bool ok = compression_ == Compression::Zstd ? decompressZstd() : decompressGzip();
+    if (!ok) {
+        failed_ = true;
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    finished_ = true;
+    queueCondition_.notify_all();
+}
+
+bool DecompressingStreamBuf::pushChunk(std::vector<char> chunk) {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    queueCondition_.wait(lock, [this] { return chunks_.size() < kMaxQueuedChunks || stopping_; });
+    if (stopping_) {
+        return false;
+    }
+    chunks_.push_back(std::move(chunk));
+    lock.unlock();
+    queueCondition_.notify_all();
+    return true;
+}
+
+bool DecompressingStreamBuf::decompressGzip() {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    // 15 window bits + 32 enables gzip/zlib header auto-detection
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        return false;
+    }
+
+    std::vector<char> input(kInputSize);
+    std::vector<char> output(kChunkSize);
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    bool ok = true;
+    bool inputDone = false;
+    while (ok && !stopping_) {
+        if (stream.avail_in == 0 && !inputDone) {
+            file_.read(input.data(), input.size());
+            stream.next_in = reinterpret_cast<Bytef*>(input.data());
+            stream.avail_in = static_cast<uInt>(file_.gcount());
+            compressedRead_ += stream.avail_in;
+            inputDone = stream.avail_in == 0;
+        }
+
+        int result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            // Concatenated gzip members are valid; keep going if input remains
+            if (stream.avail_in > 0 || (!inputDone && file_.peek() != std::char_traits<char>::eof())) {
+                inflateReset(&stream);
+            } else {
+                inputDone = true;
+            }
+        } else if (result == Z_BUF_ERROR && inputDone) {
+            ok = false;  // Truncated stream
+        } else if (result != Z_OK && result != Z_BUF_ERROR) {
+            ok = false;
+        }
+
+        const size_t produced = output.size() - stream.avail_out;
+        const bool streamDone = result == Z_STREAM_END && inputDone;
+        if (produced > 0 && (stream.avail_out == 0 || streamDone || !ok)) {
+            output.resize(produced);
+            if (!pushChunk(std::move(output))) {
+                break;
+            }
+            output.assign(kChunkSize, 0);
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = static_cast<uInt>(output.size());
+        }
+        if (streamDone) {
+            break;
+        }
+    }
+
+    inflateEnd(&stream);
+    return ok;
+}
+
+bool DecompressingStreamBuf::decompressZstd() {
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (!stream) {
+        return false;
+    }
+    ZSTD_initDStream(stream);
+
+    std::vector<char> input(kInputSize);
+    std::vector<char> output(kChunkSize);
+    ZSTD_outBuffer out = {output.data(), output.size(), 0};
+
+    bool ok = true;
+    size_t lastResult = 0;
+    while (ok && !stopping_) {
+        file_.read(input.data(), input.size());
+        const size_t count = static_cast<size_t>(file_.gcount());
+        compressedRead_ += count;
+        if (count == 0) {
+            // A non-zero hint at end of input means the last frame was truncated
+            ok = lastResult == 0;
+            break;
+        }
+
+        // Keep calling while input remains or the decoder filled the output,
+        // since a full output buffer may leave decoded data pending
+        ZSTD_inBuffer in = {input.data(), count, 0};
+        while (true) {
+            lastResult = ZSTD_decompressStream(stream, &out, &in);
+            if (ZSTD_isError(lastResult)) {
+                ok = false;
+                break;
+            }
+            const bool full = out.pos == out.size;
+            if (full) {
+                if (!pushChunk(std::move(output))) {
+                    ZSTD_freeDStream(stream);
+                    return ok;
+                }
+                output.assign(kChunkSize, 0);
+                out = {output.data(), output.size(), 0};
+            }
+            if (in.pos == in.size && !full) {
+                break;
+            }
+        }
+    }
+
+    if (out.pos > 0) {
+        output.resize(out.pos);
+        pushChunk(std::move(output));
+    }
+
+    ZSTD_freeDStream(stream);
+    return ok;
+}
+
+DecompressingStream::DecompressingStream(const std::string& filename, Compression compression)
+    : std::istream(nullptr), buffer_(filename, compression) {
+    rdbuf(&buffer_);
+    if (!buffer_.isValid()) {
+        setstate(std::ios::failbit);
+    }
+}
+
+std::unique_ptr<std::istream> openLogStream(const std::string& filename, std::ios::openmode mode) {
+    Compression compression = detectCompression(filename);
+    if (compression == Compression::None) {
+        auto file = std::make_unique<std::ifstream>(filename, mode);
+        if (!file->is_open()) {
+            return nullptr;
+        }
+        return file;
+    }
+
+    auto stream = std::make_unique<DecompressingStream>(filename, compression);
+    if (!stream->isValid()) {
+        return nullptr;
+    }
+    return stream;
+}
+
+uint64_t logStreamBytesRead(std::istream& stream) {
+    if (auto* decompressing = dynamic_cast<DecompressingStream*>(&stream)) {
+        return decompressing->getCompressedBytesRead();
+    }
+    const auto position = stream.tellg();
+    return position < 0 ? 0 : static_cast<uint64_t>(position);
+}
+
+} // namespace data
@@ -0,0 +1,40 @@
+#include "../../include/data/FieldRegistry.hpp"
+#include <mutex>
+
+namespace data {
+
+FieldId FieldRegistry::intern(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto [it, inserted] = ids_.emplace(name, static_cast<FieldId>(names_.size()));
+    if (inserted) {
+        names_.push_back(name);
+    }
+    return it->second;
+}
+
+FieldId FieldRegistry::find(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : kInvalidFieldId;
+}
+
+const std::string& FieldRegistry::name(FieldId id) const {
+    static const std::string empty;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id < names_.size() ? names_[id] : empty;
+}
+
+size_t FieldRegistry::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
+
+} // namespace data
@@ -0,0 +1,180 @@
+#include "../../include/data/MinMaxPyramid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace data {
+
+void MinMaxPyramid::Level::resize(size_t buckets) {
+    min.resize(buckets);
+    max.resize(buckets);
+    sum.resize(buckets);
+    minFirst.resize(buckets);
+}
+
+void MinMaxPyramid::build(const std::vector<double>& values) {
+    clear();
+    update(values);
+}
+
+void MinMaxPyramid::clear() {
+    levels_.clear();
+    summarized_ = 0;
+}
+
+void MinMaxPyramid::update(const std::vector<double>& values) {
+    if (values.size() < summarized_) {
+        build(values);  // The series was replaced rather than appended to
+        return;
+    }
+    if (values.size() == summarized_) {
+        return;
+    }
+
+    // The trailing bucket of each level may have been partial; start there
+    size_t firstBucket = summarized_ >> kBaseShift;
+    summarized_ = values.size();
+    summarizeBase(values, firstBucket);
+
+    for (size_t level = 1; levels_[level - 1].min.size() > 1; ++level) {
+        firstBucket /= 2;
+        if (levels_.size() <= level) {
+            levels_.emplace_back();
+        }
+        summarizeLevel(level, firstBucket);
+    }
+}
+
+void MinMaxPyramid::summarizeBase(const std::vector<double>& values, size_t firstBucket) {
+    if (levels_.empty()) {
+        levels_.emplace_back();
+    }
+    Level& base = levels_[0];
+    const size_t bucketSize = size_t{1} << kBaseShift;
+    const size_t buckets = (values.size() + bucketSize - 1) >> kBaseShift;
+    base.resize(buckets);
+
+    for (size_t bucket = firstBucket; bucket < buckets; ++bucket) {
+        const size_t begin = bucket << kBaseShift;
+        const size_t end = std::min(begin + bucketSize, values.size());
+        size_t minIndex = begin;
+        size_t maxIndex = begin;
+        double sum = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const double value = values[i];
+            sum += value;
+            if (value < values[minIndex]) {
+                minIndex = i;
+            }
+            if (value > values[maxIndex]) {
+                maxIndex = i;
+            }
+        }
+        base.min[bucket] = values[minIndex];
+        base.max[bucket] = values[maxIndex];
+        base.sum[bucket] = sum;
+        base.minFirst[bucket] = minIndex <= maxIndex;
+    }
+}
+
+void MinMaxPyramid::summarizeLevel(size_t level, size_t firstBucket) {
+    const Level& children = levels_[level - 1];
+    Level& parent = levels_[level];
+    const size_t childCount = children.min.size();
+    const size_t buckets = (childCount + 1) / 2;
+    parent.resize(buckets);
+
+    for (size_t bucket = firstBucket; bucket < buckets; ++bucket) {
+        const size_t left = bucket * 2;
+        const size_t right = left + 1;
+        if (right >= childCount) {
+            parent.min[bucket] = children.min[left];
+            parent.max[bucket] = children.max[left];
+            parent.sum[bucket] = children.sum[left];
+            parent.minFirst[bucket] = children.minFirst[left];
+            continue;
+        }
+
+        // Ties go to the left child, matching the first-occurrence rule of the base level
+        const bool minLeft = children.min[left] <= children.min[right];
+        const bool maxLeft = children.max[left] >= children.max[right];
+        parent.min[bucket] = minLeft ? children.min[left] : children.min[right];
+        parent.max[bucket] = maxLeft ? children.max[left] : children.max[right];
+        parent.sum[bucket] = children.sum[left] + children.sum[right];
+        if (minLeft == maxLeft) {
+            parent.minFirst[bucket] = minLeft ? children.minFirst[left] : children.minFirst[right];
+        } else {
+            parent.minFirst[bucket] = minLeft;
+        }
+    }
+}
+
+void MinMaxPyramid::query(const std::vector<double>& values, size_t begin, size_t end, size_t maxBuckets,
+                          std::vector<Bucket>& out) const {
+    out.clear();
+    end = std::min(end, summarized_);
+    if (begin >= end) {
+        return;
+    }
+    maxBuckets = std::max<size_t>(1, maxBuckets);
+
+    // Few enough samples to show them all
+    if (end - begin <= maxBuckets) {
+        out.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            out.push_back({i, 1, values[i], values[i], values[i], true});
+        }
+        return;
+    }
+
+    // Finest level whose buckets over the range fit in maxBuckets
+    size_t level = 0;
+    while (level + 1 < levels_.size() &&
+           ((end - begin) >> (level + kBaseShift)) + 1 > maxBuckets) {
+        ++level;
+    }
+
+    const Level& summary = levels_[level];
+    const size_t shift = level + kBaseShift;
+    const size_t firstBucket = begin >> shift;
+    const size_t lastBucket = std::min((end - 1) >> shift, summary.min.size() - 1);
+    out.reserve(lastBucket - firstBucket + 1);
+    for (size_t bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+        const size_t bucketBegin = bucket << shift;
+        const size_t count = std::min(size_t{1} << shift, summarized_ - bucketBegin);
+        out.push_back({bucketBegin, count, summary.min[bucket], summary.max[bucket],
+                       summary.sum[bucket] / static_cast<double>(count), summary.minFirst[bucket] != 0});
+    }
+}
+
+void MinMaxPyramid::queryLine(const std::vector<double>& values, double xBegin, double xEnd, size_t pixels,
+                              std::vector<double>& xs, std::vector<double>& ys) const {
+    xs.clear();
+    ys.clear();
+    if (summarized_ == 0 || xEnd <= xBegin) {
+        return;
+    }
+
+    // One sample of margin on each side keeps the line continuous at the edges
+    const size_t begin = static_cast<size_t>(std::max(0.0, std::floor(xBegin) - 1.0));
+    const size_t end = static_cast<size_t>(std::min(static_cast<double>(summarized_), std::ceil(xEnd) + 2.0));
+
+    std::vector<Bucket> buckets;
+    query(values, begin, end, pixels, buckets);
+    xs.reserve(buckets.size() * 2);
+    ys.reserve(buckets.size() * 2);
+    for (const auto& bucket : buckets) {
+        if (bucket.count == 1) {
+            xs.push_back(static_cast<double>(bucket.begin));
+            ys.push_back(bucket.min);
+            continue;
+        }
+        const double first = bucket.begin + bucket.count * 0.25;
+        const double second = bucket.begin + bucket.count * 0.75;
+        xs.push_back(first);
+        ys.push_back(bucket.minFirst ? bucket.min : bucket.max);
+        xs.push_back(second);
+        ys.push_back(bucket.minFirst ? bucket.max : bucket.min);
+    }
+}
+
+} // namespace data
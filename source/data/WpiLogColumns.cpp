@@ -0,0 +1,173 @@
+#include "../../include/data/WpiLogColumns.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace data {
+
+namespace {
+// Below this many bytes per thread, thread start-up costs more than it saves
+constexpr uint64_t kMinBytesPerThread = 4 * 1024 * 1024;
+
+void appendColumn(ScalarColumn& column, ScalarColumn& part) {
+    if (column.timestamps.empty()) {
+        column = std::move(part);
+        return;
+    }
+    column.timestamps.insert(column.timestamps.end(), part.timestamps.begin(), part.timestamps.end());
+    column.values.insert(column.values.end(), part.values.begin(), part.values.end());
+}
+}
+
+CompositeLayouts buildCompositeLayouts(const WpiLogReader& reader) {
+    CompositeLayouts layouts;
+    for (const wpilog::EntryInfo* info : reader.getDefinitions()) {
+        if (info->scalarType != wpilog::ScalarType::Unknown) {
+            continue;
+        }
+        wpilog::CompositeLayout layout;
+        if (wpilog::buildCompositeLayout(info->type, reader.getStructSchemas(), layout)) {
+            layouts.emplace(info->startOffset, std::move(layout));
+        }
+    }
+    return layouts;
+}
+
+unsigned decodeThreadCount(uint64_t bytes) {
+    const uint64_t useful = std::max<uint64_t>(1, bytes / kMinBytesPerThread);
+    return static_cast<unsigned>(std::min<uint64_t>(workerThreadCount(), useful));
+}
+
+void sortColumnByTimestamp(ScalarColumn& column) {
+    if (std::is_sorted(column.timestamps.begin(), column.timestamps.end())) {
+        return;
+    }
+
+    std::vector<size_t> order(column.timestamps.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+        [&](size_t a, size_t b) { return column.timestamps[a] < column.timestamps[b]; });
+
+    ScalarColumn sorted;
+    sorted.timestamps.reserve(order.size());
+    sorted.values.reserve(order.size());
+    for (size_t i : order) {
+        sorted.timestamps.push_back(column.timestamps[i]);
+        sorted.values.push_back(column.values[i]);
+    }
+    column = std::move(sorted);
+}
+
+ScalarColumns decodeScalarColumns(const WpiLogReader& reader,
+                                  const std::vector<uint64_t>& boundaries,
+                                  const std::unordered_set<uint32_t>& entries,
+                                  int64_t startUs, int64_t endUs,
+                                  CompositeColumns* composites) {
+    ScalarColumns columns;
+    if (!reader.isValid() || boundaries.size() < 2) {
+        return columns;
+    }
+
+    const CompositeLayouts layouts = composites ? buildCompositeLayouts(reader) : CompositeLayouts();
+    std::vector<ScalarColumns> segmentColumns(boundaries.size() - 1);
+    std::vector<CompositeColumns> segmentComposites(boundaries.size() - 1);
+
+    forEachSegmentParallel(boundaries, [&](size_t segment, uint64_t begin, uint64_t end) {
+        ScalarColumns& builders = segmentColumns[segment];
+        CompositeColumns& compositeBuilders = segmentComposites[segment];
+        std::vector<double> slots;
+        wpilog::RecordView record;
+        uint64_t offset = begin;
+        while (offset < end && reader.recordAt(offset, record)) {
+            offset = (record.payload - reader.data()) + record.size;
+            if (record.isControl() || (!entries.empty() && entries.count(record.entry) == 0) ||
+                record.timestamp < startUs || record.timestamp > endUs) {
+                continue;
+            }
+
+            // Control records were all applied by the pre-scan; look up the
+            // definition that was in effect when this record was written
+            const wpilog::EntryInfo* info = reader.getEntryAt(record.entry, record.offset);
+            if (!info) {
+                continue;
+            }
+
+            if (info->scalarType == wpilog::ScalarType::Unknown) {
+                auto layout = layouts.find(info->startOffset);
+                if (layout == layouts.end() ||
+                    wpilog::decodeComposite(layout->second, record.payload, record.size, slots) == 0) {
+                    continue;
+                }
+                // Array lengths may vary between records; each slot column only
+                // receives samples from records that contain it
+                auto& slotColumns = compositeBuilders[info->startOffset];
+                if (slotColumns.size() < slots.size()) {
+                    slotColumns.resize(slots.size());
+                }
+                for (size_t i = 0; i < slots.size(); ++i) {
+                    slotColumns[i].timestamps.push_back(record.timestamp);
+                    slotColumns[i].values.push_back(slots[i]);
+                }
+                continue;
+            }
+
+            double value = 0.0;
+            if (!wpilog::decodeScalar(info->scalarType, record.payload, record.size, value)) {
+                continue;
+            }
+
+            auto& column = builders[info->startOffset];
+            column.timestamps.push_back(record.timestamp);
+            column.values.push_back(value);
+        }
+    });
+
+    // Segments are in file order, so concatenating them keeps each entry in
+    // file order; sorting then only has work to do for out-of-order writers
+    for (auto& builders : segmentColumns) {
+        for (auto& [entry, part] : builders) {
+            appendColumn(columns[entry], part);
+        }
+        builders.clear();
+    }
+    for (auto& [entry, column] : columns) {
+        sortColumnByTimestamp(column);
+    }
+
+    if (composites) {
+        composites->clear();
+        for (auto& builders : segmentComposites) {
+            for (auto& [entry, parts] : builders) {
+                auto& slotColumns = (*composites)[entry];
+                if (slotColumns.size() < parts.size()) {
+                    slotColumns.resize(parts.size());
+                }
+                for (size_t i = 0; i < parts.size(); ++i) {
+                    appendColumn(slotColumns[i], parts[i]);
+                }
+            }
+            builders.clear();
+        }
+        for (auto& [entry, slotColumns] : *composites) {
+            for (auto& column : slotColumns) {
+                sortColumnByTimestamp(column);
+            }
+        }
+    }
+
+    return columns;
+}
+
+ScalarColumns decodeScalarColumns(WpiLogReader& reader, const std::unordered_set<uint32_t>& entries,
+                                  CompositeColumns* composites) {
+    if (!reader.isValid()) {
+        return ScalarColumns();
+    }
+
+    // Boundary pre-scan; also completes the entry table used by every segment
+    const auto boundaries = reader.splitSegments(decodeThreadCount(reader.size()));
+    return decodeScalarColumns(reader, boundaries, entries,
+                               std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(),
+                               composites);
+}
+
+} // namespace data
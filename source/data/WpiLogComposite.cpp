@@ -0,0 +1,328 @@
+#include "../../include/data/WpiLogComposite.hpp"
+#include "../../include/data/WpiLogFormat.hpp"
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace data {
+namespace wpilog {
+
+namespace {
+
+inline bool isLittleEndianHost() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+}
+
+uint32_t elementKindSize(ElementKind kind) {
+    switch (kind) {
+        case ElementKind::Boolean:
+        case ElementKind::Int8:
+        case ElementKind::UInt8:
+            return 1;
+        case ElementKind::Int16:
+        case ElementKind::UInt16:
+            return 2;
+        case ElementKind::Int32:
+        case ElementKind::UInt32:
+        case ElementKind::Float:
+            return 4;
+        case ElementKind::Int64:
+        case ElementKind::UInt64:
+        case ElementKind::Double:
+            return 8;
+    }
+    return 0;
+}
+
+bool elementKindFromName(const std::string& name, ElementKind& kind) {
+    static const std::unordered_map<std::string, ElementKind> kinds = {
+        {"bool", ElementKind::Boolean}, {"char", ElementKind::Int8},
+        {"int8", ElementKind::Int8}, {"int16", ElementKind::Int16},
+        {"int32", ElementKind::Int32}, {"int64", ElementKind::Int64},
+        {"uint8", ElementKind::UInt8}, {"uint16", ElementKind::UInt16},
+        {"uint32", ElementKind::UInt32}, {"uint64", ElementKind::UInt64},
+        {"float", ElementKind::Float}, {"float32", ElementKind::Float},
+        {"double", ElementKind::Double}, {"float64", ElementKind::Double},
+    };
+    auto it = kinds.find(name);
+    if (it == kinds.end()) {
+        return false;
+    }
+    kind = it->second;
+    return true;
+}
+
+double decodeElement(ElementKind kind, const uint8_t* data) {
+    switch (kind) {
+        case ElementKind::Boolean:
+            return data[0] ? 1.0 : 0.0;
+        case ElementKind::Int8:
+            return static_cast<double>(static_cast<int8_t>(data[0]));
+        case ElementKind::UInt8:
+            return static_cast<double>(data[0]);
+        case ElementKind::Int16:
+            return static_cast<double>(static_cast<int16_t>(readLittleEndian(data, 2)));
+        case ElementKind::UInt16:
+            return static_cast<double>(static_cast<uint16_t>(readLittleEndian(data, 2)));
+        case ElementKind::Int32:
+            return static_cast<double>(static_cast<int32_t>(readLittleEndian(data, 4)));
+        case ElementKind::UInt32:
+            return static_cast<double>(static_cast<uint32_t>(readLittleEndian(data, 4)));
+        case ElementKind::Int64:
+            return static_cast<double>(static_cast<int64_t>(readLittleEndian(data, 8)));
+        case ElementKind::UInt64:
+            return static_cast<double>(readLittleEndian(data, 8));
+        case ElementKind::Float: {
+            uint32_t bits = static_cast<uint32_t>(readLittleEndian(data, 4));
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return static_cast<double>(value);
+        }
+        case ElementKind::Double: {
+            uint64_t bits = readLittleEndian(data, 8);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+    return 0.0;
+}
+
+std::string trim(const std::string& text) {
+    const auto begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const auto end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Flatten a struct schema into members, appending to layout at baseOffset.
+// depth guards against self-referencing schemas.
+bool flattenStruct(const std::string& structName, const StructSchemas& schemas, const std::string& prefix,
+                   uint32_t baseOffset, int depth, std::vector<CompositeMember>& members, uint32_t& size) {
+    if (depth > 16) {
+        return false;
+    }
+    auto schema = schemas.find("struct:" + structName);
+    if (schema == schemas.end()) {
+        return false;
+    }
+
+    uint32_t offset = baseOffset;
+    std::istringstream declarations(schema->second);
+    std::string declaration;
+    while (std::getline(declarations, declaration, ';')) {
+        declaration = trim(declaration);
+        if (declaration.empty()) {
+            continue;
+        }
+        if (declaration.find(':') != std::string::npos) {
+            return false;  // Bit-fields are not supported
+        }
+
+        // Enum specifications only constrain values; the member is still an integer
+        if (declaration.compare(0, 4, "enum") == 0) {
+            auto close = declaration.find('}');
+            if (close == std::string::npos) {
+                return false;
+            }
+            declaration = trim(declaration.substr(close + 1));
+        }
+
+        std::istringstream parts(declaration);
+        std::string typeName;
+        std::string memberName;
+        if (!(parts >> typeName >> memberName)) {
+            return false;
+        }
+
+        // Optional fixed-size array suffix: "double x[3]"
+        uint32_t count = 1;
+        bool fixedArray = false;
+        auto bracket = memberName.find('[');
+        if (bracket != std::string::npos) {
+            count = static_cast<uint32_t>(std::stoul(memberName.substr(bracket + 1)));
+            memberName = memberName.substr(0, bracket);
+            fixedArray = true;
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            std::string path = prefix + "/" + memberName;
+            if (fixedArray) {
+                path += "[" + std::to_string(i) + "]";
+            }
+
+            ElementKind kind;
+            if (elementKindFromName(typeName, kind)) {
+                members.push_back({path, offset, kind});
+                offset += elementKindSize(kind);
+            } else {
+                uint32_t nestedSize = 0;
+                if (!flattenStruct(typeName, schemas, path, offset, depth + 1, members, nestedSize)) {
+                    return false;
+                }
+                offset += nestedSize;
+            }
+        }
+    }
+
+    size = offset - baseOffset;
+    return true;
+}
+
+// Elements per aligned copy in convertArray; the scratch lives on the stack
+constexpr size_t kConvertChunk = 512;
+
+// Convert count little-endian values of type T to double
+template <typename T>
+void convertArray(const uint8_t* payload, size_t count, double* out) {
+    if (isLittleEndianHost()) {
+        // Aligned copy of a chunk first, then a straight-line conversion
+        // loop; the scratch is reused, so no record allocates
+        T values[kConvertChunk];
+        for (size_t start = 0; start < count; start += kConvertChunk) {
+            const size_t chunk = std::min(kConvertChunk, count - start);
+            std::memcpy(values, payload + start * sizeof(T), chunk * sizeof(T));
+            for (size_t i = 0; i < chunk; ++i) {
+                out[start + i] = static_cast<double>(values[i]);
+            }
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t bits = readLittleEndian(payload + i * sizeof(T), sizeof(T));
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        out[i] = static_cast<double>(value);
+    }
+}
+
+}
+
+bool buildCompositeLayout(const std::string& type, const StructSchemas& schemas, CompositeLayout& layout) {
+    layout = CompositeLayout();
+
+    std::string elementType = type;
+    if (elementType.size() > 2 && elementType.compare(elementType.size() - 2, 2, "[]") == 0) {
+        layout.isArray = true;
+        elementType.resize(elementType.size() - 2);
+    }
+
+    if (elementType.compare(0, 7, "struct:") == 0) {
+        uint32_t size = 0;
+        bool flattened = false;
+        try {
+            flattened = flattenStruct(elementType.substr(7), schemas, "", 0, 0, layout.members, size);
+        } catch (const std::exception&) {
+            flattened = false;  // Malformed array size in the schema
+        }
+        if (!flattened || size == 0) {
+            layout = CompositeLayout();
+            return false;
+        }
+        layout.elementSize = size;
+        return true;
+    }
+
+    // Plain arrays use the wpilog scalar type names
+    if (!layout.isArray) {
+        return false;
+    }
+    ElementKind kind;
+    if (elementType == "boolean") {
+        kind = ElementKind::Boolean;
+    } else if (elementType == "int64") {
+        kind = ElementKind::Int64;
+    } else if (elementType == "float") {
+        kind = ElementKind::Float;
+    } else if (elementType == "double") {
+        kind = ElementKind::Double;
+    } else {
+        layout = CompositeLayout();
+        return false;
+    }
+    layout.elementSize = elementKindSize(kind);
+    layout.members.push_back({"", 0, kind});
+    return true;
+}
+
+size_t compositeSlotCount(const CompositeLayout& layout, size_t payloadSize) {
+    if (!layout.isValid()) {
+        return 0;
+    }
+    const size_t elements = layout.isArray ? payloadSize / layout.elementSize
+                                           : (payloadSize >= layout.elementSize ? 1 : 0);
+    return elements * layout.members.size();
+}
+
+std::string compositeSlotName(const CompositeLayout& layout, size_t slot) {
+    const size_t memberCount = layout.members.size();
+    const CompositeMember& member = layout.members[slot % memberCount];
+    if (!layout.isArray) {
+        return member.path;
+    }
+    return "[" + std::to_string(slot / memberCount) + "]" + member.path;
+}
+
+size_t decodeComposite(const CompositeLayout& layout, const uint8_t* payload, size_t size, std::vector<double>& out) {
+    const size_t slots = compositeSlotCount(layout, size);
+    out.resize(slots);
+    if (slots == 0) {
+        return 0;
+    }
+
+    // Plain numeric arrays: bulk conversion
+    if (layout.isArray && layout.members.size() == 1 && layout.members[0].path.empty()) {
+        switch (layout.members[0].kind) {
+            case ElementKind::Double:
+                if (isLittleEndianHost()) {
+                    std::memcpy(out.data(), payload, slots * sizeof(double));
+                } else {
+                    convertArray<double>(payload, slots, out.data());
+                }
+                return slots;
+            case ElementKind::Float:
+                convertArray<float>(payload, slots, out.data());
+                return slots;
+            case ElementKind::Int64:
+                convertArray<int64_t>(payload, slots, out.data());
+                return slots;
+            case ElementKind::Boolean:
+                for (size_t i = 0; i < slots; ++i) {
+                    out[i] = payload[i] ? 1.0 : 0.0;
+                }
+                return slots;
+            default:
+                break;
+        }
+    }
+
+    // Structs: gather each member with the element stride
+    const size_t memberCount = layout.members.size();
+    const size_t elements = slots / memberCount;
+    for (size_t m = 0; m < memberCount; ++m) {
+        const CompositeMember& member = layout.members[m];
+        const uint8_t* source = payload + member.offset;
+        for (size_t e = 0; e < elements; ++e) {
+            out[e * memberCount + m] = decodeElement(member.kind, source + e * layout.elementSize);
+        }
+    }
+    return slots;
+}
+
+bool decodeCompositeSlot(const CompositeLayout& layout, const uint8_t* payload, size_t size, size_t slot, double& value) {
+    if (slot >= compositeSlotCount(layout, size)) {
+        return false;
+    }
+    const size_t memberCount = layout.members.size();
+    const CompositeMember& member = layout.members[slot % memberCount];
+    value = decodeElement(member.kind, payload + (slot / memberCount) * layout.elementSize + member.offset);
+    return true;
+}
+
+} // namespace wpilog
+} // namespace data
@@ -1,48 +1,188 @@
-#include "data/WpiLogDataSource.h"
-#include <fstream>
+#include "../../include/data/WpiLogDataSource.hpp"
+#include "../../include/data/WpiLogColumns.hpp"
+#include <algorithm>
 #include <chrono>
+#include <limits>
+#include <unordered_set>
 
 namespace data {
 
 WpiLogDataSource::WpiLogDataSource(const std::string& filename)
     : filename_(filename), connected_(false) {}
 
+WpiLogDataSource::~WpiLogDataSource() {
+    stopReplay();
+}
+
 bool WpiLogDataSource::connect() {
     if (connected_) {
         return true;
     }
 
     try {
-        // Open the log file
-        std::ifstream file(filename_, std::ios::binary);
-        if (!file.is_open()) {
+        // Map the log file; compressed logs are decompressed into memory
+        if (!reader_.open(filename_) || !buildIndex()) {
+            disconnect();
             return false;
         }
 
-        // Create DataLogReader
-        reader_ = std::make_unique<wpigui::DataLogReader>(file);
-        if (!reader_->IsValid()) {
-            return false;
+        connected_ = true;
+        return true;
+    } catch (const std::exception&) {
+        disconnect();
+        return false;
+    }
+}
+
+bool WpiLogDataSource::buildIndex() {
+    entries_.clear();
+    entryIds_.clear();
+    index_.clear();
+    definitionIds_.clear();
+    slotFieldNames_.clear();
+    slotFields_.clear();
+
+    // Boundary pre-scan; this also applies every control record, so every
+    // entry definition is known before the segments are indexed. Definitions
+    // with the same name and type share an index, so an entry id restarted
+    // unchanged continues its series; one restarted under another name or
+    // type becomes a field of its own.
+    const auto boundaries = reader_.splitSegments(decodeThreadCount(reader_.size()));
+    for (const wpilog::EntryInfo* info : reader_.getDefinitions()) {
+        auto existing = entryIds_.find(info->name);
+        int id = 0;
+        if (existing != entryIds_.end() && index_.at(existing->second).type == info->type) {
+            id = existing->second;
+        } else {
+            id = static_cast<int>(index_.size());
+            entries_[id] = info->name;
+            entryIds_[info->name] = id;
+            auto& entry = index_[id];
+            entry.type = info->type;
+            entry.scalarType = info->scalarType;
+            if (entry.scalarType == wpilog::ScalarType::Unknown) {
+                wpilog::buildCompositeLayout(entry.type, reader_.getStructSchemas(), entry.layout);
+            }
         }
+        definitionIds_[info->startOffset] = id;
+        auto& logEntries = index_.at(id).logEntries;
+        if (std::find(logEntries.begin(), logEntries.end(), info->entry) == logEntries.end()) {
+            logEntries.push_back(info->entry);
+        }
+    }
 
-        // Get all entries
-        entries_.clear();
-        while (reader_->Next()) {
-            if (reader_->IsStart()) {
-                entries_[reader_->GetStartEntry()] = reader_->GetStartName();
+    // Index the segments in parallel
+    struct PartialIndex {
+        std::vector<int64_t> timestamps;
+        std::vector<uint64_t> offsets;
+    };
+    std::vector<std::unordered_map<int, PartialIndex>> segmentIndexes(boundaries.size() - 1);
+    forEachSegmentParallel(boundaries, [&](size_t segment, uint64_t begin, uint64_t end) {
+        auto& partial = segmentIndexes[segment];
+        wpilog::RecordView record;
+        uint64_t offset = begin;
+        while (offset < end && reader_.recordAt(offset, record)) {
+            offset = (record.payload - reader_.data()) + record.size;
+            if (record.isControl()) {
+                continue;
             }
+            // Filed under the definition the record was written under
+            const wpilog::EntryInfo* info = reader_.getEntryAt(record.entry, record.offset);
+            if (!info) {
+                continue;
+            }
+            auto& part = partial[definitionIds_.at(info->startOffset)];
+            part.timestamps.push_back(record.timestamp);
+            part.offsets.push_back(record.offset);
         }
+    });
 
-        connected_ = true;
-        return true;
-    } catch (const std::exception&) {
-        return false;
+    // Concatenate the segments in file order
+    for (auto& partial : segmentIndexes) {
+        for (auto& [id, part] : partial) {
+            auto& entry = index_[id];
+            entry.timestamps.insert(entry.timestamps.end(), part.timestamps.begin(), part.timestamps.end());
+            entry.offsets.insert(entry.offsets.end(), part.offsets.begin(), part.offsets.end());
+        }
+    }
+
+    // Records are written in timestamp order per entry, but the format does
+    // not guarantee it; sort any entry that is out of order
+    for (auto& [id, entry] : index_) {
+        if (std::is_sorted(entry.timestamps.begin(), entry.timestamps.end())) {
+            continue;
+        }
+        std::vector<size_t> order(entry.timestamps.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return entry.timestamps[a] < entry.timestamps[b]; });
+        EntryIndex sorted;
+        sorted.type = entry.type;
+        sorted.scalarType = entry.scalarType;
+        sorted.layout = entry.layout;
+        sorted.logEntries = std::move(entry.logEntries);
+        for (size_t i : order) {
+            sorted.timestamps.push_back(entry.timestamps[i]);
+            sorted.offsets.push_back(entry.offsets[i]);
+        }
+        entry = std::move(sorted);
+    }
+
+    for (const auto& [id, name] : entries_) {
+        addSlotFields(id, index_.at(id));
+    }
+
+    startTimeUs_ = std::numeric_limits<int64_t>::max();
+    endTimeUs_ = std::numeric_limits<int64_t>::min();
+    for (const auto& [id, entry] : index_) {
+        if (!entry.timestamps.empty()) {
+            startTimeUs_ = std::min(startTimeUs_, entry.timestamps.front());
+            endTimeUs_ = std::max(endTimeUs_, entry.timestamps.back());
+        }
+    }
+    if (startTimeUs_ > endTimeUs_) {
+        startTimeUs_ = endTimeUs_ = 0;
+    }
+
+    return true;
+}
+
+void WpiLogDataSource::addSlotFields(int entryId, EntryIndex& entry) {
+    if (!entry.layout.isValid()) {
+        return;
+    }
+
+    // Array lengths may change between records; expose the longest one seen
+    size_t slotCount = 0;
+    wpilog::RecordView record;
+    for (uint64_t offset : entry.offsets) {
+        if (reader_.recordAt(offset, record)) {
+            slotCount = std::max(slotCount, wpilog::compositeSlotCount(entry.layout, record.size));
+        }
+    }
+
+    const std::string& name = entries_.at(entryId);
+    for (size_t slot = 0; slot < slotCount; ++slot) {
+        std::string field = name + wpilog::compositeSlotName(entry.layout, slot);
+        if (slotFields_.emplace(field, SlotField{entryId, slot}).second) {
+            slotFieldNames_.push_back(std::move(field));
+        }
     }
 }
 
 void WpiLogDataSource::disconnect() {
-    reader_.reset();
+    stopReplay();
+    reader_.close();
     entries_.clear();
+    entryIds_.clear();
+    index_.clear();
+    definitionIds_.clear();
+    slotFieldNames_.clear();
+    slotFields_.clear();
+    subscribedEntries_.clear();
+    subscribedSlots_.clear();
     connected_ = false;
 }
 
@@ -52,26 +192,42 @@ bool WpiLogDataSource::isConnected() const {
 
 std::vector<std::string> WpiLogDataSource::getAvailableFields() const {
     std::vector<std::string> fields;
-    fields.reserve(entries_.size());
+    fields.reserve(entries_.size() + slotFieldNames_.size());
     for (const auto& [id, name] : entries_) {
         fields.push_back(name);
     }
+    fields.insert(fields.end(), slotFieldNames_.begin(), slotFieldNames_.end());
     return fields;
 }
 
+int WpiLogDataSource::findEntry(const std::string& field) const {
+    auto it = entryIds_.find(field);
+    return it != entryIds_.end() ? it->second : -1;
+}
+
+const WpiLogDataSource::SlotField* WpiLogDataSource::findSlotField(const std::string& field) const {
+    auto it = slotFields_.find(field);
+    return it != slotFields_.end() ? &it->second : nullptr;
+}
+
 bool WpiLogDataSource::subscribe(const std::string& field) {
     if (!connected_) {
         return false;
     }
 
-    // Find the entry ID for this field
-    for (const auto& [id, name] : entries_) {
-        if (name == field) {
-            subscribedEntries_.insert(id);
-            return true;
-        }
+    std::lock_guard<std::mutex> lock(replayMutex_);
+    subscriptionsChanged_ = true;
+    if (const SlotField* slotField = findSlotField(field)) {
+        subscribedSlots_[{slotField->entry, slotField->slot}] = getFieldId(field);
+        return true;
     }
-    return false;
+
+    int entryId = findEntry(field);
+    if (entryId == -1) {
+        return false;
+    }
+    subscribedEntries_[entryId] = getFieldId(field);
+    return true;
 }
 
 void WpiLogDataSource::unsubscribe(const std::string& field) {
@@ -79,17 +235,17 @@ void WpiLogDataSource::unsubscribe(const std::string& field) {
         return;
     }
 
-    // Find and remove the entry ID for this field
-    for (const auto& [id, name] : entries_) {
-        if (name == field) {
-            subscribedEntries_.erase(id);
-            break;
-        }
+    std::lock_guard<std::mutex> lock(replayMutex_);
+    subscriptionsChanged_ = true;
+    if (const SlotField* slotField = findSlotField(field)) {
+        subscribedSlots_.erase({slotField->entry, slotField->slot});
+        return;
     }
-}
 
-void WpiLogDataSource::setDataCallback(std::function<void(const DataPoint&)> callback) {
-    dataCallback_ = std::move(callback);
+    int entryId = findEntry(field);
+    if (entryId != -1) {
+        subscribedEntries_.erase(entryId);
+    }
 }
 
 std::vector<DataPoint> WpiLogDataSource::getHistoricalData(
@@ -102,20 +258,17 @@ std::vector<DataPoint> WpiLogDataSource::getHistoricalData(
         return data;
     }
 
-    // Find the entry ID for this field
-    int entryId = -1;
-    for (const auto& [id, name] : entries_) {
-        if (name == field) {
-            entryId = id;
-            break;
-        }
-    }
+    // Find the entry ID for this field; array elements and struct members
+    // are read from their parent entry's records
+    const SlotField* slotField = findSlotField(field);
+    int entryId = slotField ? slotField->entry : findEntry(field);
     if (entryId == -1) {
         return data;
     }
-
-    // Reset reader to start
-    reader_->Reset();
+    const EntryIndex& entry = index_.at(entryId);
+    if (!slotField && entry.scalarType == wpilog::ScalarType::Unknown) {
+        return data;  // Skip unsupported types
+    }
     
     // Convert time points to microseconds
     auto startUs = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -123,40 +276,312 @@ std::vector<DataPoint> WpiLogDataSource::getHistoricalData(
     auto endUs = std::chrono::duration_cast<std::chrono::microseconds>(
         end.time_since_epoch()).count();
 
-    // Read data
-    while (reader_->Next()) {
-        if (reader_->IsData() && reader_->GetDataEntry() == entryId) {
-            auto timestamp = reader_->GetTimestamp();
-            if (timestamp >= startUs && timestamp <= endUs) {
-                DataPoint point;
-                point.timestamp = std::chrono::system_clock::time_point(
-                    std::chrono::microseconds(timestamp));
-                point.field = field;
-                
-                // Convert data to double based on type
-                switch (reader_->GetDataType()) {
-                    case wpigui::DataLogReader::kBoolean:
-                        point.value = reader_->GetBoolean() ? 1.0 : 0.0;
-                        break;
-                    case wpigui::DataLogReader::kInteger:
-                        point.value = static_cast<double>(reader_->GetInteger());
-                        break;
-                    case wpigui::DataLogReader::kFloat:
-                        point.value = static_cast<double>(reader_->GetFloat());
-                        break;
-                    case wpigui::DataLogReader::kDouble:
-                        point.value = reader_->GetDouble();
-                        break;
-                    default:
-                        continue;  // Skip unsupported types
+    // Binary-search the range and touch only this entry's records
+    auto first = std::lower_bound(entry.timestamps.begin(), entry.timestamps.end(), startUs);
+    auto last = std::upper_bound(first, entry.timestamps.end(), endUs);
+    const size_t begin = first - entry.timestamps.begin();
+    const size_t count = last - first;
+    data.reserve(count);
+    const FieldId fieldId = getFieldId(field);
+
+    // Payloads are decoded straight out of the mapping
+    wpilog::RecordView record;
+    for (size_t i = begin; i < begin + count; ++i) {
+        if (!reader_.recordAt(entry.offsets[i], record)) {
+            continue;
+        }
+
+        DataPoint point;
+        const bool decoded = slotField
+            ? wpilog::decodeCompositeSlot(entry.layout, record.payload, record.size, slotField->slot, point.value)
+            : wpilog::decodeScalar(entry.scalarType, record.payload, record.size, point.value);
+        if (!decoded) {
+            continue;
+        }
+        point.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::microseconds(entry.timestamps[i]));
+        point.fieldId = fieldId;
+        data.push_back(point);
+    }
+
+    return data;
+}
+
+std::map<std::string, FieldColumn> WpiLogDataSource::getHistoricalColumns(
+    const std::vector<std::string>& fields,
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end) const {
+
+    std::map<std::string, FieldColumn> columns;
+    if (!connected_) {
+        return columns;
+    }
+
+    auto startUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        start.time_since_epoch()).count();
+    auto endUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        end.time_since_epoch()).count();
+
+    // Use the index to find the byte range covering every requested field in
+    // the time range, and the field with the most records in it
+    std::unordered_set<uint32_t> wanted;  // wpilog entry ids to decode
+    std::unordered_set<int> wantedIds;    // Index ids they are filed under
+    uint64_t rangeBegin = std::numeric_limits<uint64_t>::max();
+    uint64_t rangeEnd = 0;
+    const EntryIndex* densest = nullptr;
+    size_t densestBegin = 0;
+    size_t densestCount = 0;
+    std::vector<std::pair<std::string, SlotField>> wantedSlots;
+    for (const auto& field : fields) {
+        const SlotField* slotField = findSlotField(field);
+        int entryId = slotField ? slotField->entry : findEntry(field);
+        if (entryId == -1) {
+            continue;
+        }
+        const EntryIndex& entry = index_.at(entryId);
+        if (slotField) {
+            wantedSlots.emplace_back(field, *slotField);
+        } else if (entry.scalarType == wpilog::ScalarType::Unknown) {
+            continue;
+        }
+
+        auto first = std::lower_bound(entry.timestamps.begin(), entry.timestamps.end(), startUs);
+        auto last = std::upper_bound(first, entry.timestamps.end(), endUs);
+        if (first == last) {
+            continue;
+        }
+
+        const size_t begin = first - entry.timestamps.begin();
+        const size_t count = last - first;
+        wanted.insert(entry.logEntries.begin(), entry.logEntries.end());
+        wantedIds.insert(entryId);
+
+        // Offsets are sorted unless the writer was out of order; take the extremes
+        auto [minOffset, maxOffset] = std::minmax_element(entry.offsets.begin() + begin,
+                                                          entry.offsets.begin() + begin + count);
+        rangeBegin = std::min(rangeBegin, *minOffset);
+        wpilog::RecordView lastRecord;
+        if (reader_.recordAt(*maxOffset, lastRecord)) {
+            rangeEnd = std::max<uint64_t>(rangeEnd, (lastRecord.payload - reader_.data()) + lastRecord.size);
+        }
+
+        if (count > densestCount) {
+            densest = &entry;
+            densestBegin = begin;
+            densestCount = count;
+        }
+    }
+    if (wanted.empty() || rangeBegin >= rangeEnd) {
+        return columns;
+    }
+
+    // Any indexed offset is a record boundary, so segment boundaries are taken
+    // from the densest field instead of re-walking the record headers
+    std::vector<uint64_t> boundaries{rangeBegin, rangeEnd};
+    const unsigned threads = decodeThreadCount(rangeEnd - rangeBegin);
+    for (unsigned i = 1; i < threads; ++i) {
+        uint64_t offset = densest->offsets[densestBegin + densestCount * i / threads];
+        if (offset > rangeBegin && offset < rangeEnd) {
+            boundaries.push_back(offset);
+        }
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    // One pass over the range decodes every requested field
+    CompositeColumns composites;
+    ScalarColumns decoded = decodeScalarColumns(reader_, boundaries, wanted, startUs, endUs,
+                                                wantedSlots.empty() ? nullptr : &composites);
+    // Columns come back per definition; several definitions may share a field
+    auto appendTo = [](FieldColumn& out, ScalarColumn& column) {
+        if (out.timestampsUs.empty()) {
+            out.timestampsUs = std::move(column.timestamps);
+            out.values = std::move(column.values);
+            return;
+        }
+        out.timestampsUs.insert(out.timestampsUs.end(), column.timestamps.begin(), column.timestamps.end());
+        out.values.insert(out.values.end(), column.values.begin(), column.values.end());
+        ScalarColumn merged{std::move(out.timestampsUs), std::move(out.values)};
+        sortColumnByTimestamp(merged);
+        out.timestampsUs = std::move(merged.timestamps);
+        out.values = std::move(merged.values);
+    };
+    for (auto& [definition, column] : decoded) {
+        const int entryId = definitionIds_.at(definition);
+        if (wantedIds.count(entryId) == 0) {
+            continue;
+        }
+        auto& out = columns[entries_.at(entryId)];
+        out.type = index_.at(entryId).type;
+        appendTo(out, column);
+    }
+    for (auto& [definition, slots] : composites) {
+        const int entryId = definitionIds_.at(definition);
+        for (const auto& [field, slotField] : wantedSlots) {
+            if (slotField.entry != entryId || slotField.slot >= slots.size()) {
+                continue;
+            }
+            auto& out = columns[field];
+            out.type = "double";
+            appendTo(out, slots[slotField.slot]);
+        }
+    }
+
+    return columns;
+}
+
+bool WpiLogDataSource::startReplay(const ReplayOptions& options) {
+    if (!connected_) {
+        return false;
+    }
+    stopReplay();
+
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        seekPending_ = false;
+    }
+    replayPosition_ = std::clamp(options.startUs, startTimeUs_, endTimeUs_);
+    replayRunning_ = true;
+    replayThread_ = std::thread(&WpiLogDataSource::replayLoop, this, options);
+    return true;
+}
+
+void WpiLogDataSource::stopReplay() {
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        replayRunning_ = false;
+    }
+    replayWake_.notify_all();
+    if (replayThread_.joinable()) {
+        replayThread_.join();
+    }
+}
+
+void WpiLogDataSource::seekReplay(int64_t timestampUs) {
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        seekRequest_ = std::clamp(timestampUs, startTimeUs_, endTimeUs_);
+        seekPending_ = true;
+    }
+    replayWake_.notify_all();
+}
+
+std::vector<WpiLogDataSource::ReplayTrack> WpiLogDataSource::snapshotTracks(int64_t positionUs) {
+    // Called with replayMutex_ held
+    std::vector<ReplayTrack> tracks;
+    for (const auto& [entryId, field] : subscribedEntries_) {
+        const EntryIndex& entry = index_.at(entryId);
+        if (entry.scalarType != wpilog::ScalarType::Unknown) {
+            tracks.push_back({&entry, false, 0, field, 0});
+        }
+    }
+    for (const auto& [slot, field] : subscribedSlots_) {
+        tracks.push_back({&index_.at(slot.first), true, slot.second, field, 0});
+    }
+    for (auto& track : tracks) {
+        const auto& timestamps = track.entry->timestamps;
+        track.cursor = std::lower_bound(timestamps.begin(), timestamps.end(), positionUs) - timestamps.begin();
+    }
+    subscriptionsChanged_ = false;
+    return tracks;
+}
+
+void WpiLogDataSource::replayLoop(ReplayOptions options) {
+    using Clock = std::chrono::steady_clock;
+    const int64_t sliceUs = std::max<int64_t>(1, options.sliceUs);
+    const bool paced = options.speed > 0.0;
+
+    SampleBatcher batcher;
+    std::vector<ReplayTrack> tracks;
+    int64_t position = std::clamp(options.startUs, startTimeUs_, endTimeUs_);
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        tracks = snapshotTracks(position);
+    }
+
+    // Wall-clock time at which log time anchorUs is due
+    Clock::time_point anchorWall = Clock::now();
+    int64_t anchorUs = position;
+
+    wpilog::RecordView record;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(replayMutex_);
+            if (!replayRunning_) {
+                break;
+            }
+            if (seekPending_ || subscriptionsChanged_) {
+                if (seekPending_) {
+                    position = seekRequest_;
+                    seekPending_ = false;
+                    anchorWall = Clock::now();
+                    anchorUs = position;
+                }
+                tracks = snapshotTracks(position);
+            }
+        }
+
+        // Without pacing, skip over stretches of the log that have no samples
+        if (!paced) {
+            int64_t next = std::numeric_limits<int64_t>::max();
+            for (const auto& track : tracks) {
+                if (track.cursor < track.entry->timestamps.size()) {
+                    next = std::min(next, track.entry->timestamps[track.cursor]);
+                }
+            }
+            position = std::max(position, next == std::numeric_limits<int64_t>::max() ? endTimeUs_ : next);
+        }
+
+        // Collect every sample in [position, sliceEnd)
+        const int64_t sliceEnd = position + sliceUs;
+        for (auto& track : tracks) {
+            const EntryIndex& entry = *track.entry;
+            for (; track.cursor < entry.timestamps.size() && entry.timestamps[track.cursor] < sliceEnd; ++track.cursor) {
+                if (!reader_.recordAt(entry.offsets[track.cursor], record)) {
+                    continue;
+                }
+                double value = 0.0;
+                const bool decoded = track.isSlot
+                    ? wpilog::decodeCompositeSlot(entry.layout, record.payload, record.size, track.slot, value)
+                    : wpilog::decodeScalar(entry.scalarType, record.payload, record.size, value);
+                if (decoded) {
+                    batcher.add(track.field, entry.timestamps[track.cursor], value);
                 }
-                
-                data.push_back(point);
             }
         }
+
+        // A slice is delivered once its end is due
+        if (paced) {
+            auto due = anchorWall + std::chrono::microseconds(
+                static_cast<int64_t>((sliceEnd - anchorUs) / options.speed));
+            std::unique_lock<std::mutex> lock(replayMutex_);
+            replayWake_.wait_until(lock, due, [this]() { return !replayRunning_ || seekPending_; });
+            if (!replayRunning_) {
+                break;
+            }
+            if (seekPending_) {
+                batcher.clear();  // Samples from before the seek are stale
+                continue;
+            }
+        }
+
+        publish(batcher);
+        position = sliceEnd;
+        replayPosition_ = std::min(position, endTimeUs_);
+
+        if (position > endTimeUs_) {
+            if (!options.loop) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(replayMutex_);
+            position = startTimeUs_;
+            anchorWall = Clock::now();
+            anchorUs = position;
+            tracks = snapshotTracks(position);
+        }
     }
 
-    return data;
+    replayRunning_ = false;
 }
 
-} // namespace data 
\ No newline at end of file
+} // namespace data
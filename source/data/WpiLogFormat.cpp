@@ -0,0 +1,210 @@
+#include "../../include/data/WpiLogFormat.hpp"
+#include <cstring>
+
+namespace data {
+namespace wpilog {
+
+namespace {
+
+bool readString(const uint8_t*& cursor, const uint8_t* end, std::string& out) {
+    if (end - cursor < 4) {
+        return false;
+    }
+    uint32_t length = static_cast<uint32_t>(readLittleEndian(cursor, 4));
+    cursor += 4;
+    if (static_cast<size_t>(end - cursor) < length) {
+        return false;
+    }
+    out.assign(reinterpret_cast<const char*>(cursor), length);
+    cursor += length;
+    return true;
+}
+
+// Bytes needed for value, at least 1 and at most maxBytes
+size_t byteLength(uint64_t value, size_t maxBytes) {
+    size_t length = 1;
+    while (length < maxBytes && (value >> (8 * length)) != 0) {
+        ++length;
+    }
+    return length;
+}
+
+void appendString(std::string& out, const std::string& value) {
+    uint8_t length[4];
+    writeLittleEndian(length, value.size(), 4);
+    out.append(reinterpret_cast<const char*>(length), 4);
+    out += value;
+}
+
+}
+
+bool parseFileHeader(const uint8_t* data, size_t size, size_t& firstRecordOffset) {
+    if (size < kFileHeaderSize || std::memcmp(data, "WPILOG", 6) != 0) {
+        return false;
+    }
+
+    // Only major version 1 is understood
+    uint16_t version = static_cast<uint16_t>(readLittleEndian(data + 6, 2));
+    if ((version >> 8) != 1) {
+        return false;
+    }
+
+    uint32_t extraHeaderSize = static_cast<uint32_t>(readLittleEndian(data + 8, 4));
+    if (size - kFileHeaderSize < extraHeaderSize) {
+        return false;
+    }
+
+    firstRecordOffset = kFileHeaderSize + extraHeaderSize;
+    return true;
+}
+
+bool parseRecordHeader(const uint8_t* data, size_t available, RecordHeader& header) {
+    if (available < 1) {
+        return false;
+    }
+
+    const uint8_t lengthBits = data[0];
+    const size_t entryLength = (lengthBits & 0x3) + 1;
+    const size_t sizeLength = ((lengthBits >> 2) & 0x3) + 1;
+    const size_t timestampLength = ((lengthBits >> 4) & 0x7) + 1;
+    const size_t headerSize = 1 + entryLength + sizeLength + timestampLength;
+    if (available < headerSize) {
+        return false;
+    }
+
+    const uint8_t* cursor = data + 1;
+    header.entry = static_cast<uint32_t>(readLittleEndian(cursor, entryLength));
+    cursor += entryLength;
+    header.payloadSize = static_cast<uint32_t>(readLittleEndian(cursor, sizeLength));
+    cursor += sizeLength;
+    header.timestamp = static_cast<int64_t>(readLittleEndian(cursor, timestampLength));
+    header.headerSize = headerSize;
+    return true;
+}
+
+bool parseStartRecord(const uint8_t* payload, size_t size, StartRecord& record) {
+    if (size < 5 || payload[0] != static_cast<uint8_t>(ControlType::Start)) {
+        return false;
+    }
+
+    const uint8_t* cursor = payload + 1;
+    const uint8_t* end = payload + size;
+    record.entry = static_cast<uint32_t>(readLittleEndian(cursor, 4));
+    cursor += 4;
+    return readString(cursor, end, record.name) &&
+           readString(cursor, end, record.type) &&
+           readString(cursor, end, record.metadata);
+}
+
+bool parseControlEntry(const uint8_t* payload, size_t size, uint32_t& entry) {
+    if (size < 5) {
+        return false;
+    }
+    entry = static_cast<uint32_t>(readLittleEndian(payload + 1, 4));
+    return true;
+}
+
+ScalarType scalarTypeFromString(const std::string& type) {
+    if (type == "double") {
+        return ScalarType::Double;
+    }
+    if (type == "float") {
+        return ScalarType::Float;
+    }
+    if (type == "int64") {
+        return ScalarType::Int64;
+    }
+    if (type == "boolean") {
+        return ScalarType::Boolean;
+    }
+    return ScalarType::Unknown;
+}
+
+bool decodeScalar(ScalarType type, const uint8_t* payload, size_t size, double& value) {
+    switch (type) {
+        case ScalarType::Boolean:
+            if (size != 1) {
+                return false;
+            }
+            value = payload[0] ? 1.0 : 0.0;
+            return true;
+        case ScalarType::Int64: {
+            if (size != 8) {
+                return false;
+            }
+            value = static_cast<double>(static_cast<int64_t>(readLittleEndian(payload, 8)));
+            return true;
+        }
+        case ScalarType::Float: {
+            if (size != 4) {
+                return false;
+            }
+            uint32_t bits = static_cast<uint32_t>(readLittleEndian(payload, 4));
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            value = static_cast<double>(f);
+            return true;
+        }
+        case ScalarType::Double: {
+            if (size != 8) {
+                return false;
+            }
+            uint64_t bits = readLittleEndian(payload, 8);
+            std::memcpy(&value, &bits, sizeof(value));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+std::string encodeFileHeader(const std::string& extraHeader) {
+    std::string header("WPILOG");
+    uint8_t fields[6];
+    writeLittleEndian(fields, 0x0100, 2);
+    writeLittleEndian(fields + 2, extraHeader.size(), 4);
+    header.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+    header += extraHeader;
+    return header;
+}
+
+size_t encodeRecordHeader(uint8_t* out, uint32_t entry, uint32_t payloadSize, int64_t timestamp) {
+    const uint64_t time = static_cast<uint64_t>(timestamp);
+    const size_t entryLength = byteLength(entry, 4);
+    const size_t sizeLength = byteLength(payloadSize, 4);
+    const size_t timeLength = byteLength(time, 8);
+
+    out[0] = static_cast<uint8_t>((entryLength - 1) | ((sizeLength - 1) << 2) | ((timeLength - 1) << 4));
+    size_t offset = 1;
+    writeLittleEndian(out + offset, entry, entryLength);
+    offset += entryLength;
+    writeLittleEndian(out + offset, payloadSize, sizeLength);
+    offset += sizeLength;
+    writeLittleEndian(out + offset, time, timeLength);
+    return offset + timeLength;
+}
+
+std::string encodeStartRecord(const StartRecord& record, int64_t timestamp) {
+    std::string payload(1, static_cast<char>(ControlType::Start));
+    uint8_t entry[4];
+    writeLittleEndian(entry, record.entry, 4);
+    payload.append(reinterpret_cast<const char*>(entry), 4);
+    appendString(payload, record.name);
+    appendString(payload, record.type);
+    appendString(payload, record.metadata);
+
+    uint8_t header[kMaxRecordHeaderSize];
+    const size_t headerSize = encodeRecordHeader(header, kControlEntry, static_cast<uint32_t>(payload.size()), timestamp);
+    return std::string(reinterpret_cast<const char*>(header), headerSize) + payload;
+}
+
+size_t encodeDoubleRecord(uint8_t* out, uint32_t entry, int64_t timestamp, double value) {
+    const size_t headerSize = encodeRecordHeader(out, entry, 8, timestamp);
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeLittleEndian(out + headerSize, bits, 8);
+    return headerSize + 8;
+}
+
+} // namespace wpilog
+} // namespace data
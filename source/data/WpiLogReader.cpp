@@ -0,0 +1,337 @@
+#include "../../include/data/WpiLogReader.hpp"
+#include "../../include/data/CompressedStream.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace data {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle_ = file;
+    opened_ = true;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    mappingHandle_ = mapping;
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        close();
+        return false;
+    }
+    return true;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    opened_ = true;
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        opened_ = false;
+        size_ = 0;
+        return false;
+    }
+    // Records are mostly read front to back
+    ::madvise(address, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(address);
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_) {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_) {
+        CloseHandle(fileHandle_);
+    }
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+}
+
+bool WpiLogReader::open(const std::string& filename) {
+    close();
+
+    if (detectCompression(filename) == Compression::None) {
+        if (!mapping_.open(filename)) {
+            return false;
+        }
+        data_ = mapping_.data();
+        size_ = mapping_.size();
+    } else {
+        // A compressed log cannot be mapped; decompress it into memory once
+        auto stream = openLogStream(filename, std::ios::binary);
+        if (!stream) {
+            return false;
+        }
+        char buffer[64 * 1024];
+        while (stream->read(buffer, sizeof(buffer)) || stream->gcount() > 0) {
+            decompressed_.insert(decompressed_.end(), buffer, buffer + stream->gcount());
+        }
+        if (stream->bad()) {
+            close();
+            return false;
+        }
+        data_ = decompressed_.data();
+        size_ = decompressed_.size();
+    }
+
+    size_t firstRecordOffset = 0;
+    if (!data_ || !wpilog::parseFileHeader(data_, size_, firstRecordOffset)) {
+        close();
+        return false;
+    }
+
+    firstRecordOffset_ = firstRecordOffset;
+    cursor_ = firstRecordOffset_;
+    valid_ = true;
+    return true;
+}
+
+void WpiLogReader::close() {
+    mapping_.close();
+    decompressed_.clear();
+    decompressed_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    firstRecordOffset_ = 0;
+    cursor_ = 0;
+    valid_ = false;
+    entries_.clear();
+    earlierEntries_.clear();
+    schemaEntries_.clear();
+    structSchemas_.clear();
+}
+
+bool WpiLogReader::recordAt(uint64_t offset, wpilog::RecordView& record) const {
+    if (offset >= size_) {
+        return false;
+    }
+
+    wpilog::RecordHeader header;
+    if (!wpilog::parseRecordHeader(data_ + offset, size_ - offset, header)) {
+        return false;
+    }
+    if (size_ - offset - header.headerSize < header.payloadSize) {
+        return false;
+    }
+
+    record.entry = header.entry;
+    record.timestamp = header.timestamp;
+    record.payload = data_ + offset + header.headerSize;
+    record.size = header.payloadSize;
+    record.offset = offset;
+    return true;
+}
+
+bool WpiLogReader::next(wpilog::RecordView& record) {
+    if (!valid_ || !recordAt(cursor_, record)) {
+        return false;
+    }
+    cursor_ = (record.payload - data_) + record.size;
+
+    if (record.isControl()) {
+        applyControlRecord(record);
+    } else if (!schemaEntries_.empty()) {
+        captureStructSchema(record);
+    }
+    return true;
+}
+
+std::vector<uint64_t> WpiLogReader::splitSegments(size_t segmentCount) {
+    std::vector<uint64_t> boundaries;
+    if (!valid_) {
+        return boundaries;
+    }
+
+    segmentCount = std::max<size_t>(1, segmentCount);
+    const uint64_t targetSize = std::max<uint64_t>(1, (size_ - firstRecordOffset_) / segmentCount);
+    boundaries.push_back(firstRecordOffset_);
+
+    // Only headers are touched here, plus the payloads of control and schema
+    // records so that every segment sees the complete entry table
+    uint64_t offset = firstRecordOffset_;
+    wpilog::RecordView record;
+    while (recordAt(offset, record)) {
+        if (record.isControl()) {
+            applyControlRecord(record);
+        } else if (!schemaEntries_.empty()) {
+            captureStructSchema(record);
+        }
+        offset = (record.payload - data_) + record.size;
+        if (offset - boundaries.back() >= targetSize && boundaries.size() < segmentCount) {
+            boundaries.push_back(offset);
+        }
+    }
+
+    if (boundaries.back() != offset) {
+        boundaries.push_back(offset);
+    }
+    if (boundaries.size() == 1) {
+        boundaries.push_back(offset);
+    }
+    cursor_ = offset;
+    return boundaries;
+}
+
+const wpilog::EntryInfo* WpiLogReader::getEntry(uint32_t entry) const {
+    auto it = entries_.find(entry);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+const wpilog::EntryInfo* WpiLogReader::getEntryAt(uint32_t entry, uint64_t offset) const {
+    const wpilog::EntryInfo* info = getEntry(entry);
+    if (!info || offset > info->startOffset) {
+        return info;
+    }
+
+    auto earlier = earlierEntries_.find(entry);
+    if (earlier == earlierEntries_.end()) {
+        return nullptr;
+    }
+    for (auto it = earlier->second.rbegin(); it != earlier->second.rend(); ++it) {
+        if (offset > it->startOffset) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<const wpilog::EntryInfo*> WpiLogReader::getDefinitions() const {
+    std::vector<const wpilog::EntryInfo*> definitions;
+    definitions.reserve(entries_.size());
+    for (const auto& [id, info] : entries_) {
+        definitions.push_back(&info);
+    }
+    for (const auto& [id, earlier] : earlierEntries_) {
+        for (const auto& info : earlier) {
+            definitions.push_back(&info);
+        }
+    }
+    std::sort(definitions.begin(), definitions.end(),
+        [](const wpilog::EntryInfo* a, const wpilog::EntryInfo* b) { return a->startOffset < b->startOffset; });
+    return definitions;
+}
+
+void WpiLogReader::applyControlRecord(const wpilog::RecordView& record) {
+    if (record.size < 1) {
+        return;
+    }
+
+    switch (static_cast<wpilog::ControlType>(record.payload[0])) {
+        case wpilog::ControlType::Start: {
+            wpilog::StartRecord start;
+            if (wpilog::parseStartRecord(record.payload, record.size, start)) {
+                auto existing = entries_.find(start.entry);
+                if (existing != entries_.end()) {
+                    // Start records at or before the current definition were
+                    // applied on an earlier pass over the file
+                    if (record.offset <= existing->second.startOffset) {
+                        break;
+                    }
+                    earlierEntries_[start.entry].push_back(std::move(existing->second));
+                }
+                auto& entry = entries_[start.entry];
+                entry = wpilog::EntryInfo();
+                entry.entry = start.entry;
+                entry.name = std::move(start.name);
+                entry.type = std::move(start.type);
+                entry.metadata = std::move(start.metadata);
+                entry.scalarType = wpilog::scalarTypeFromString(entry.type);
+                entry.startOffset = record.offset;
+                const std::string schemaPrefix = wpilog::kStructSchemaPrefix;
+                if (entry.type == "structschema" && entry.name.compare(0, schemaPrefix.size(), schemaPrefix) == 0) {
+                    schemaEntries_[start.entry] = entry.name.substr(schemaPrefix.size());
+                } else {
+                    schemaEntries_.erase(start.entry);
+                }
+            }
+            break;
+        }
+        case wpilog::ControlType::Finish: {
+            uint32_t entry = 0;
+            if (wpilog::parseControlEntry(record.payload, record.size, entry)) {
+                auto it = entries_.find(entry);
+                if (it != entries_.end() && record.offset > it->second.startOffset) {
+                    it->second.active = false;
+                }
+            }
+            break;
+        }
+        case wpilog::ControlType::SetMetadata: {
+            uint32_t entry = 0;
+            if (wpilog::parseControlEntry(record.payload, record.size, entry) && record.size >= 9) {
+                auto it = entries_.find(entry);
+                uint32_t length = static_cast<uint32_t>(wpilog::readLittleEndian(record.payload + 5, 4));
+                if (it != entries_.end() && record.offset > it->second.startOffset && record.size - 9 >= length) {
+                    it->second.metadata.assign(reinterpret_cast<const char*>(record.payload + 9), length);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void WpiLogReader::captureStructSchema(const wpilog::RecordView& record) {
+    auto it = schemaEntries_.find(record.entry);
+    if (it != schemaEntries_.end()) {
+        structSchemas_[it->second].assign(reinterpret_cast<const char*>(record.payload), record.size);
+    }
+}
+
+} // namespace data
@@ -0,0 +1,200 @@
+#include "../../include/data/WpiLogRecorder.hpp"
+#include "../../include/data/WpiLogFormat.hpp"
+#include <algorithm>
+
+namespace data {
+
+namespace {
+    // How often the I/O thread drains the rings; rings hold about a second
+    // of a fast NT stream, so this leaves plenty of headroom
+    constexpr auto kDrainPeriod = std::chrono::milliseconds(10);
+
+    // Records drained from one channel at a time
+    constexpr size_t kBatchSize = 1024;
+
+    int64_t steadyMicroseconds() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+WpiLogRecorder::Channel::Channel(const std::string& name, uint32_t entry, size_t capacity, Clock clock)
+    : name_(name)
+    , entry_(entry)
+    , clock_(std::move(clock))
+    , records_(capacity) {
+}
+
+bool WpiLogRecorder::Channel::record(int64_t timestampUs, double value) {
+    if (!active_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (!records_.tryPush(Record{timestampUs, value})) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+size_t WpiLogRecorder::Channel::recordBlock(const double* values, size_t count) {
+    const int64_t timestampUs = clock_();
+    size_t recorded = 0;
+    for (size_t i = 0; i < count; ++i) {
+        recorded += record(timestampUs, values[i]) ? 1 : 0;
+    }
+    return recorded;
+}
+
+WpiLogRecorder::WpiLogRecorder(Clock clock, size_t channelCapacity, std::chrono::milliseconds flushPeriod)
+    : clock_(clock ? std::move(clock) : Clock(steadyMicroseconds))
+    , channelCapacity_(channelCapacity)
+    , flushPeriod_(flushPeriod) {
+}
+
+WpiLogRecorder::~WpiLogRecorder() {
+    close();
+}
+
+bool WpiLogRecorder::open(const std::string& filename) {
+    close();
+    if (!writer_.open(filename)) {
+        return false;
+    }
+    const std::string header = wpilog::encodeFileHeader();
+    writer_.write(header.data(), header.size());
+
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        stopping_ = false;
+        for (auto& channel : channels_) {
+            // Anything queued while not recording belongs to no file
+            Record stale;
+            while (channel->records_.tryPop(stale)) {
+            }
+            channel->started_ = false;
+            channel->active_ = true;
+        }
+        recording_ = true;
+    }
+    ioThread_ = std::thread(&WpiLogRecorder::ioLoop, this);
+    return true;
+}
+
+bool WpiLogRecorder::close() {
+    if (!ioThread_.joinable()) {
+        return !writer_.hasFailed();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex_);
+        for (auto& channel : channels_) {
+            channel->active_ = false;
+        }
+        recording_ = false;
+        stopping_ = true;
+    }
+    stopCondition_.notify_one();
+    ioThread_.join();
+    return writer_.close();
+}
+
+std::shared_ptr<WpiLogRecorder::Channel> WpiLogRecorder::addChannel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    // Entry 0 is reserved for control records
+    auto channel = std::make_shared<Channel>(name, static_cast<uint32_t>(channels_.size() + 1), channelCapacity_, clock_);
+    channel->active_ = recording_.load();
+    channels_.push_back(channel);
+    ++channelsVersion_;
+    return channel;
+}
+
+bool WpiLogRecorder::hasChannel(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    return std::any_of(channels_.begin(), channels_.end(),
+        [&](const std::shared_ptr<Channel>& channel) { return channel->getName() == name; });
+}
+
+uint64_t WpiLogRecorder::getDroppedRecords() const {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    uint64_t dropped = 0;
+    for (const auto& channel : channels_) {
+        dropped += channel->getDroppedRecords();
+    }
+    return dropped;
+}
+
+uint64_t WpiLogRecorder::getWrittenRecords() const {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    uint64_t written = 0;
+    for (const auto& channel : channels_) {
+        written += channel->getWrittenRecords();
+    }
+    return written;
+}
+
+void WpiLogRecorder::ioLoop() {
+    std::vector<std::shared_ptr<Channel>> channels;
+    uint64_t seenVersion = ~uint64_t(0);
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(channelsMutex_);
+            stopCondition_.wait_for(lock, kDrainPeriod, [this]() { return stopping_; });
+            stopping = stopping_;
+            if (seenVersion != channelsVersion_) {
+                channels = channels_;
+                seenVersion = channelsVersion_;
+            }
+        }
+
+        // After stop no producer pushes, so this last pass empties every ring
+        drainChannels(channels);
+        if (stopping) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastFlush >= flushPeriod_) {
+            writer_.flush();
+            lastFlush = now;
+        }
+    }
+}
+
+size_t WpiLogRecorder::drainChannels(std::vector<std::shared_ptr<Channel>>& channels) {
+    constexpr size_t kMaxRecordSize = wpilog::kMaxRecordHeaderSize + sizeof(double);
+    Record batch[kBatchSize];
+    size_t drained = 0;
+
+    for (auto& channel : channels) {
+        if (!channel->started_) {
+            wpilog::StartRecord start;
+            start.entry = channel->entry_;
+            start.name = channel->name_;
+            start.type = "double";
+            const std::string encoded = wpilog::encodeStartRecord(start, clock_());
+            writer_.write(encoded.data(), encoded.size());
+            channel->started_ = true;
+        }
+
+        size_t count;
+        while ((count = channel->records_.pop(batch, kBatchSize)) > 0) {
+            char* begin = writer_.reserve(count * kMaxRecordSize);
+            if (!begin) {
+                return drained;  // Write error; the rings keep filling and drop
+            }
+            auto* out = reinterpret_cast<uint8_t*>(begin);
+            for (size_t i = 0; i < count; ++i) {
+                out += wpilog::encodeDoubleRecord(out, channel->entry_, batch[i].timestampUs, batch[i].value);
+            }
+            writer_.commit(static_cast<size_t>(reinterpret_cast<char*>(out) - begin));
+            channel->written_.fetch_add(count, std::memory_order_relaxed);
+            drained += count;
+        }
+    }
+    return drained;
+}
+
+} // namespace data
@@ -0,0 +1,124 @@
+#include "../../include/filter/AsyncLogLoader.hpp"
+
+namespace filter {
+
+bool AsyncLogLoader::Task::isFinished() const {
+    const State state = state_;
+    return state == State::Done || state == State::Failed || state == State::Cancelled;
+}
+
+std::shared_ptr<const LogFileParser> AsyncLogLoader::Task::getResult() const {
+    std::lock_guard<std::mutex> lock(resultMutex_);
+    return result_;
+}
+
+AsyncLogLoader::AsyncLogLoader() {
+    worker_ = std::thread(&AsyncLogLoader::workerLoop, this);
+}
+
+AsyncLogLoader::~AsyncLogLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& task : queue_) {
+            task->cancelled_ = true;
+        }
+        for (auto& [filename, weakTask] : inFlight_) {
+            if (auto task = weakTask.lock()) {
+                task->cancelled_ = true;
+            }
+        }
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+AsyncLogLoader& AsyncLogLoader::shared() {
+    static AsyncLogLoader loader;
+    return loader;
+}
+
+std::shared_ptr<AsyncLogLoader::Task> AsyncLogLoader::load(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Join a request that is still queued or loading and not being cancelled
+    auto it = inFlight_.find(filename);
+    if (it != inFlight_.end()) {
+        if (auto task = it->second.lock()) {
+            if (!task->cancelled_ && !task->isFinished()) {
+                ++task->requesters_;
+                return task;
+            }
+        }
+    }
+
+    auto task = std::make_shared<Task>(filename);
+    task->requesters_ = 1;
+    inFlight_[filename] = task;
+    queue_.push_back(task);
+    wake_.notify_one();
+    return task;
+}
+
+void AsyncLogLoader::cancel(const std::shared_ptr<Task>& task) {
+    // Under mutex_, so load() cannot join the task between the two steps
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (task && --task->requesters_ <= 0) {
+        task->cancelled_ = true;
+    }
+}
+
+void AsyncLogLoader::workerLoop() {
+    while (true) {
+        std::shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        if (task->cancelled_) {
+            task->state_ = State::Cancelled;
+        } else {
+            task->state_ = State::Loading;
+            auto parser = std::make_shared<LogFileParser>();
+            bool loaded = false;
+            try {
+                loaded = parser->loadFile(task->filename_, [&task](double fraction) {
+                    task->progress_ = fraction;
+                    return !task->cancelled_;
+                });
+            } catch (const std::exception&) {
+                loaded = false;
+            }
+
+            if (task->cancelled_) {
+                task->state_ = State::Cancelled;
+            } else if (loaded) {
+                // Publish the finished parser before the state flips to Done
+                {
+                    std::lock_guard<std::mutex> lock(task->resultMutex_);
+                    task->result_ = std::move(parser);
+                }
+                task->state_ = State::Done;
+            } else {
+                task->state_ = State::Failed;
+            }
+        }
+
+        // Later requests for this file start a fresh load
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = inFlight_.find(task->filename_);
+        if (it != inFlight_.end() && it->second.lock() == task) {
+            inFlight_.erase(it);
+        }
+    }
+}
+
+} // namespace filter
@@ -73,6 +73,15 @@ std::string ButterworthFilter::getTypeName() const {
     return "Butterworth";
 }
 
+std::shared_ptr<Filter> ButterworthFilter::clone() const {
+    return std::make_shared<ButterworthFilter>(*this);
+}
+
+void ButterworthFilter::reset() {
+    std::fill(xHistory_.begin(), xHistory_.end(), 0.0);
+    std::fill(yHistory_.begin(), yHistory_.end(), 0.0);
+}
+
 void ButterworthFilter::setParameter(const std::string& name, double value) {
     if (name == "order") {
         order_ = static_cast<int>(value);
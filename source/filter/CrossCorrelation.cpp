@@ -0,0 +1,303 @@
+#include "../../include/filter/CrossCorrelation.hpp"
+#include "../../include/data/ParallelFor.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace filter {
+
+namespace {
+    using Complex = std::complex<double>;
+
+    // Fewer windows than this per thread are not worth a thread
+    constexpr size_t kMinWindowsPerThread = 4;
+
+    struct Scratch {
+        std::vector<double> reference;
+        std::vector<double> signal;
+        std::vector<double> correlation;
+        std::vector<double> referenceEnergy;  // Running sum of squares
+        std::vector<Complex> referenceSpectrum;
+        std::vector<Complex> signalSpectrum;
+    };
+
+    // Copy data[begin, end) with its mean removed into out at the same
+    // positions; NaN samples count as the mean. Returns the energy.
+    double centre(const double* data, size_t begin, size_t end, std::vector<double>& out) {
+        double sum = 0.0;
+        size_t valid = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (!std::isnan(data[i])) {
+                sum += data[i];
+                ++valid;
+            }
+        }
+        const double mean = valid > 0 ? sum / static_cast<double>(valid) : 0.0;
+        double energy = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = std::isnan(data[i]) ? 0.0 : data[i] - mean;
+            energy += out[i] * out[i];
+        }
+        return energy;
+    }
+
+    CorrelationPeak correlateWith(const double* reference, const double* signal, size_t count, size_t maxLag,
+                                  double sampleRate, Scratch& scratch, std::vector<double>* function) {
+        CorrelationPeak peak;
+        if (function) {
+            function->clear();
+        }
+        if (count < 8) {
+            return peak;
+        }
+
+        // Only the inner part of the signal is matched, against the whole
+        // reference, so every lag compares the same number of samples. A
+        // shrinking overlap would otherwise pull broad peaks towards zero.
+        maxLag = std::min(maxLag, count / 4);
+        const size_t innerBegin = maxLag;
+        const size_t innerEnd = count - maxLag;
+        const auto plan = RealFft::plan(count);
+        const size_t size = plan->size();
+        scratch.reference.assign(size, 0.0);
+        scratch.signal.assign(size, 0.0);
+        centre(reference, 0, count, scratch.reference);
+        const double signalEnergy = centre(signal, innerBegin, innerEnd, scratch.signal);
+        if (!(signalEnergy > 0.0)) {
+            return peak;
+        }
+        scratch.referenceEnergy.resize(count + 1);
+        scratch.referenceEnergy[0] = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            scratch.referenceEnergy[i + 1] = scratch.referenceEnergy[i] + scratch.reference[i] * scratch.reference[i];
+        }
+
+        // r[k] = sum over t of signal[t] * reference[t - k]; negative lags wrap to the end.
+        // The reference never reaches past the buffer, so nothing wraps into the searched lags.
+        scratch.referenceSpectrum.resize(plan->bins());
+        scratch.signalSpectrum.resize(plan->bins());
+        plan->forward(scratch.reference.data(), scratch.referenceSpectrum.data());
+        plan->forward(scratch.signal.data(), scratch.signalSpectrum.data());
+        for (size_t k = 0; k < plan->bins(); ++k) {
+            // conj(R) * S, written out; operator* adds NaN checks in the hot loop
+            const Complex r = scratch.referenceSpectrum[k];
+            const Complex x = scratch.signalSpectrum[k];
+            scratch.referenceSpectrum[k] = Complex(r.real() * x.real() + r.imag() * x.imag(),
+                                                   r.real() * x.imag() - r.imag() * x.real());
+        }
+        scratch.correlation.resize(size);
+        plan->inverse(scratch.referenceSpectrum.data(), scratch.correlation.data());
+
+        // Normalized by the energy of the reference span each lag lines up with
+        const auto lag = static_cast<std::ptrdiff_t>(maxLag);
+        auto at = [&](std::ptrdiff_t k) {
+            const size_t begin = static_cast<size_t>(static_cast<std::ptrdiff_t>(innerBegin) - k);
+            const size_t end = static_cast<size_t>(static_cast<std::ptrdiff_t>(innerEnd) - k);
+            const double energy = (scratch.referenceEnergy[end] - scratch.referenceEnergy[begin]) * signalEnergy;
+            const double value = scratch.correlation[k >= 0 ? static_cast<size_t>(k) : size - static_cast<size_t>(-k)];
+            return energy > 0.0 ? value / std::sqrt(energy) : 0.0;
+        };
+
+        std::ptrdiff_t best = -lag;
+        for (std::ptrdiff_t k = -lag; k <= lag; ++k) {
+            if (at(k) > at(best)) {
+                best = k;
+            }
+        }
+
+        // Parabola through the peak and its neighbours for the sub-sample position
+        double offset = 0.0;
+        double value = at(best);
+        if (best > -lag && best < lag) {
+            const double before = at(best - 1);
+            const double after = at(best + 1);
+            const double curvature = before - 2.0 * value + after;
+            if (curvature < 0.0) {
+                offset = std::clamp(0.5 * (before - after) / curvature, -0.5, 0.5);
+                value -= 0.25 * (before - after) * offset;
+            }
+        }
+
+        peak.lagSamples = static_cast<double>(best) + offset;
+        peak.lagSeconds = peak.lagSamples / sampleRate;
+        peak.coefficient = std::clamp(value, -1.0, 1.0);
+        peak.time = 0.5 * static_cast<double>(count) / sampleRate;
+        peak.valid = true;
+
+        if (function) {
+            function->resize(2 * maxLag + 1);
+            for (std::ptrdiff_t k = -lag; k <= lag; ++k) {
+                (*function)[static_cast<size_t>(k + lag)] = at(k);
+            }
+        }
+        return peak;
+    }
+}
+
+CorrelationPeak correlate(const double* reference, const double* signal, size_t count, size_t maxLag,
+                          double sampleRate, std::vector<double>* function) {
+    Scratch scratch;
+    return correlateWith(reference, signal, count, maxLag, sampleRate, scratch, function);
+}
+
+size_t CorrelationOptions::step() const {
+    if (hop > 0) {
+        return hop;
+    }
+    // A quarter window while sliding, otherwise about a second of data
+    if (windowLength > 0) {
+        return std::max<size_t>(1, windowLength / 4);
+    }
+    return std::max<size_t>(1, static_cast<size_t>(sampleRate));
+}
+
+CrossCorrelator::CrossCorrelator(const CorrelationOptions& options)
+    : options_(options) {
+    if (!(options_.sampleRate > 0.0)) {
+        options_.sampleRate = 1.0;
+    }
+    options_.maxHistory = std::max<size_t>(1, options_.maxHistory);
+}
+
+void CrossCorrelator::appendReference(const double* data, size_t count) {
+    reference_.insert(reference_.end(), data, data + count);
+    update();
+}
+
+void CrossCorrelator::appendSignal(const double* data, size_t count) {
+    signal_.insert(signal_.end(), data, data + count);
+    update();
+}
+
+void CrossCorrelator::reset() {
+    reference_.clear();
+    signal_.clear();
+    consumed_ = 0;
+    nextWindow_ = 0;
+    correlatedLength_ = 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    peak_ = CorrelationPeak();
+    function_.clear();
+    history_.clear();
+    ++revision_;
+}
+
+void CrossCorrelator::update() {
+    if (isSliding()) {
+        updateSliding();
+    } else {
+        updateWhole();
+    }
+}
+
+void CrossCorrelator::updateWhole() {
+    // Only the span both streams cover can be compared
+    const size_t length = std::min(reference_.size(), signal_.size());
+    if (length < 2 || (correlatedLength_ > 0 && length < correlatedLength_ + options_.step())) {
+        return;
+    }
+    correlatedLength_ = length;
+
+    Scratch scratch;
+    std::vector<double> function;
+    const CorrelationPeak peak = correlateWith(reference_.data(), signal_.data(), length, options_.maxLag,
+                                               options_.sampleRate, scratch, &function);
+    publish(peak, std::move(function));
+}
+
+void CrossCorrelator::updateSliding() {
+    const size_t window = options_.windowLength;
+    const size_t step = options_.step();
+    const uint64_t available = consumed_ + std::min(reference_.size(), signal_.size());
+    if (nextWindow_ + window > available) {
+        return;
+    }
+
+    // Windows that would fall out of the history right away are skipped
+    size_t windows = static_cast<size_t>((available - window - nextWindow_) / step) + 1;
+    const size_t skipped = windows - std::min(windows, options_.maxHistory);
+    const uint64_t firstStart = nextWindow_ + skipped * step;
+    windows -= skipped;
+
+    std::vector<CorrelationPeak> peaks(windows);
+    std::vector<double> function;
+    const size_t threadCount = std::clamp<size_t>(windows / kMinWindowsPerThread, 1,
+                                                  data::workerThreadCount(options_.threadCount));
+
+    // Each thread takes a contiguous run of windows with its own buffers
+    data::parallelFor(threadCount, threadCount, [&](size_t thread, size_t) {
+        Scratch scratch;
+        const size_t begin = windows * thread / threadCount;
+        const size_t end = windows * (thread + 1) / threadCount;
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t start = firstStart + i * step;
+            const size_t offset = static_cast<size_t>(start - consumed_);
+            peaks[i] = correlateWith(&reference_[offset], &signal_[offset], window, options_.maxLag,
+                                     options_.sampleRate, scratch, i + 1 == windows ? &function : nullptr);
+            peaks[i].time += static_cast<double>(start) / options_.sampleRate;
+        }
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& peak : peaks) {
+            history_.push_back(peak);
+        }
+        while (history_.size() > options_.maxHistory) {
+            history_.pop_front();
+        }
+        peak_ = peaks.back();
+        function_ = std::move(function);
+        ++revision_;
+    }
+
+    // Drop the samples no later window needs
+    nextWindow_ = firstStart + windows * step;
+    const size_t used = static_cast<size_t>(std::min<uint64_t>(nextWindow_ - consumed_, std::min(reference_.size(), signal_.size())));
+    reference_.erase(reference_.begin(), reference_.begin() + static_cast<std::ptrdiff_t>(used));
+    signal_.erase(signal_.begin(), signal_.begin() + static_cast<std::ptrdiff_t>(used));
+    consumed_ += used;
+}
+
+void CrossCorrelator::publish(const CorrelationPeak& peak, std::vector<double>&& function) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peak_ = peak;
+    function_ = std::move(function);
+    ++revision_;
+}
+
+CorrelationPeak CrossCorrelator::getPeak() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
+
+void CrossCorrelator::getFunction(std::vector<double>& lagsSeconds, std::vector<double>& values) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values = function_;
+    lagsSeconds.resize(values.size());
+    const double maxLag = 0.5 * static_cast<double>(values.size() - (values.empty() ? 0 : 1));
+    for (size_t i = 0; i < values.size(); ++i) {
+        lagsSeconds[i] = (static_cast<double>(i) - maxLag) / options_.sampleRate;
+    }
+}
+
+void CrossCorrelator::getHistory(std::vector<double>& times, std::vector<double>& lagsSeconds, std::vector<double>& coefficients) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    times.clear();
+    lagsSeconds.clear();
+    coefficients.clear();
+    for (const auto& peak : history_) {
+        if (peak.valid) {
+            times.push_back(peak.time);
+            lagsSeconds.push_back(peak.lagSeconds);
+            coefficients.push_back(peak.coefficient);
+        }
+    }
+}
+
+uint64_t CrossCorrelator::getRevision() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return revision_;
+}
+
+} // namespace filter
@@ -0,0 +1,183 @@
+#include "../../include/filter/Fft.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace filter {
+
+namespace {
+    using Complex = std::complex<double>;
+
+    // Plain product; operator* also checks for NaN and infinity, which costs
+    // more than the butterfly itself
+    inline Complex multiply(const Complex& a, const Complex& b) {
+        return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+
+    // Plans and windows live for the whole run; analyses ask for the same few sizes
+    std::mutex cacheMutex;
+    std::map<size_t, std::shared_ptr<const RealFft>> plans;
+    std::map<std::pair<WindowType, size_t>, std::shared_ptr<const std::vector<double>>> windows;
+}
+
+size_t nextPowerOfTwo(size_t size) {
+    size_t power = 1;
+    while (power < size) {
+        power <<= 1;
+    }
+    return power;
+}
+
+RealFft::RealFft(size_t size)
+    : size_(std::max<size_t>(4, nextPowerOfTwo(size))) {
+    // The real input is packed into a complex sequence of half the length
+    // Twiddles are stored stage by stage so each butterfly pass reads them in order
+    const size_t half = size_ / 2;
+    twiddles_.resize(half > 1 ? half - 1 : 0);
+    for (size_t length = 2; length <= half; length <<= 1) {
+        for (size_t k = 0; k < length / 2; ++k) {
+            twiddles_[length / 2 - 1 + k] = std::polar(1.0, -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(length));
+        }
+    }
+    realTwiddles_.resize(half / 2 + 1);
+    for (size_t k = 0; k < realTwiddles_.size(); ++k) {
+        realTwiddles_[k] = std::polar(1.0, -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size_));
+    }
+
+    int bits = 0;
+    while ((size_t(1) << bits) < half) {
+        ++bits;
+    }
+    bitReverse_.resize(half);
+    for (size_t i = 0; i < half; ++i) {
+        uint32_t reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        bitReverse_[i] = reversed;
+    }
+}
+
+void RealFft::transform(Complex* data) const {
+    const size_t n = size_ / 2;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t j = bitReverse_[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        const size_t halfLength = length / 2;
+        const Complex* twiddles = &twiddles_[halfLength - 1];
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t k = 0; k < halfLength; ++k) {
+                const Complex even = data[start + k];
+                const Complex odd = multiply(data[start + k + halfLength], twiddles[k]);
+                data[start + k] = even + odd;
+                data[start + k + halfLength] = even - odd;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const double* input, Complex* output) const {
+    // Even samples go in the real part and odd samples in the imaginary part
+    const size_t half = size_ / 2;
+    for (size_t i = 0; i < half; ++i) {
+        output[i] = Complex(input[2 * i], input[2 * i + 1]);
+    }
+    transform(output);
+
+    // Split into the spectra of the even and odd samples and combine them.
+    // Bins k and half - k depend on each other, so they are done in pairs.
+    const Complex z0 = output[0];
+    output[0] = Complex(z0.real() + z0.imag(), 0.0);
+    output[half] = Complex(z0.real() - z0.imag(), 0.0);
+    for (size_t k = 1; k <= half / 2; ++k) {
+        const Complex a = output[k];
+        const Complex b = std::conj(output[half - k]);
+        const Complex even = 0.5 * (a + b);
+        const Complex difference = a - b;
+        const Complex odd(0.5 * difference.imag(), -0.5 * difference.real());  // (a - b) / 2i
+        const Complex rotated = multiply(realTwiddles_[k], odd);
+        output[k] = even + rotated;
+        output[half - k] = std::conj(even - rotated);
+    }
+}
+
+void RealFft::inverse(Complex* spectrum, double* output) const {
+    // Undo the split step, pairing bins k and half - k as forward() does
+    const size_t half = size_ / 2;
+    const Complex first = spectrum[0];
+    const Complex last = spectrum[half];
+    spectrum[0] = Complex(0.5 * (first.real() + last.real()), 0.5 * (first.real() - last.real()));
+    for (size_t k = 1; k <= half / 2; ++k) {
+        const Complex a = spectrum[k];
+        const Complex b = std::conj(spectrum[half - k]);
+        const Complex even = 0.5 * (a + b);
+        const Complex odd = multiply(0.5 * (a - b), std::conj(realTwiddles_[k]));
+        const Complex pairedOdd = std::conj(odd);
+        // Packed spectrum: even + i * odd
+        spectrum[k] = Complex(even.real() - odd.imag(), even.imag() + odd.real());
+        spectrum[half - k] = Complex(even.real() - pairedOdd.imag(), -even.imag() + pairedOdd.real());
+    }
+
+    // Inverse complex FFT through the forward one: conj(FFT(conj(Z))) / n
+    for (size_t i = 0; i < half; ++i) {
+        spectrum[i] = std::conj(spectrum[i]);
+    }
+    transform(spectrum);
+    const double scale = 1.0 / static_cast<double>(half);
+    for (size_t i = 0; i < half; ++i) {
+        output[2 * i] = spectrum[i].real() * scale;
+        output[2 * i + 1] = -spectrum[i].imag() * scale;
+    }
+}
+
+std::shared_ptr<const RealFft> RealFft::plan(size_t size) {
+    size = std::max<size_t>(4, nextPowerOfTwo(size));
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto& plan = plans[size];
+    if (!plan) {
+        plan = std::make_shared<const RealFft>(size);
+    }
+    return plan;
+}
+
+std::shared_ptr<const std::vector<double>> makeWindow(WindowType type, size_t length) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto& window = windows[{type, length}];
+    if (window) {
+        return window;
+    }
+
+    std::vector<double> values(length, 1.0);
+    const double n = static_cast<double>(length);
+    for (size_t i = 0; i < length; ++i) {
+        const double phase = 2.0 * M_PI * static_cast<double>(i) / n;
+        switch (type) {
+            case WindowType::Hann:
+                values[i] = 0.5 - 0.5 * std::cos(phase);
+                break;
+            case WindowType::Hamming:
+                values[i] = 0.54 - 0.46 * std::cos(phase);
+                break;
+            case WindowType::Blackman:
+                values[i] = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+                break;
+            case WindowType::Rectangular:
+                break;
+        }
+    }
+    window = std::make_shared<const std::vector<double>>(std::move(values));
+    return window;
+}
+
+} // namespace filter
@@ -0,0 +1,187 @@
+#include "../../include/filter/FilterDesign.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace filter {
+
+namespace {
+    using Complex = std::complex<double>;
+
+    // Analog prototype poles with a cutoff of 1 rad/s, left half plane.
+    // Only one pole of each conjugate pair, then the real pole if the order is odd.
+    std::vector<Complex> prototypePoles(const DesignSpec& spec) {
+        std::vector<Complex> poles;
+        const int order = spec.order;
+        double sinhMu = 1.0;
+        double coshMu = 1.0;
+        if (spec.type == DesignType::Chebyshev) {
+            const double epsilon = std::sqrt(std::pow(10.0, std::max(spec.ripple, 1e-3) / 10.0) - 1.0);
+            const double mu = std::asinh(1.0 / epsilon) / order;
+            sinhMu = std::sinh(mu);
+            coshMu = std::cosh(mu);
+        }
+        for (int k = 0; k < order / 2; ++k) {
+            const double theta = M_PI * (2.0 * k + 1.0) / (2.0 * order);
+            poles.emplace_back(-sinhMu * std::sin(theta), coshMu * std::cos(theta));
+        }
+        if (order % 2 == 1) {
+            poles.emplace_back(-sinhMu, 0.0);
+        }
+        return poles;
+    }
+}
+
+std::string designTypeName(DesignType type) {
+    switch (type) {
+        case DesignType::FirstOrder:
+            return "First Order";
+        case DesignType::Butterworth:
+            return "Butterworth";
+        case DesignType::Chebyshev:
+            return "Chebyshev";
+    }
+    return "Unknown";
+}
+
+std::vector<Biquad> designLowPass(const DesignSpec& spec) {
+    const double nyquist = 0.5 * spec.sampleRate;
+    const double cutoff = std::clamp(spec.cutoffFreq, 1e-6 * nyquist, 0.999 * nyquist);
+
+    if (spec.type == DesignType::FirstOrder) {
+        // Same pole as LowPassFilter: y += alpha * (x - y)
+        const double dt = 1.0 / spec.sampleRate;
+        const double rc = 1.0 / (2.0 * M_PI * cutoff);
+        const double alpha = dt / (dt + rc);
+        Biquad section;
+        section.b0 = alpha;
+        section.a1 = -(1.0 - alpha);
+        return {section};
+    }
+
+    // Prewarp so the digital cutoff lands where asked, then map s -> z bilinearly
+    const double fs2 = 2.0 * spec.sampleRate;
+    const double warped = fs2 * std::tan(M_PI * cutoff / spec.sampleRate);
+    const DesignSpec clamped{spec.type, std::max(spec.order, 1), cutoff, spec.sampleRate, spec.ripple};
+
+    std::vector<Biquad> sections;
+    for (const Complex& prototype : prototypePoles(clamped)) {
+        const Complex s = prototype * warped;
+        const Complex z = (fs2 + s) / (fs2 - s);
+        Biquad section;
+        if (std::abs(prototype.imag()) > 0.0) {
+            // Conjugate pair with both zeros at z = -1; unity gain at DC
+            section.a1 = -2.0 * z.real();
+            section.a2 = std::norm(z);
+            const double gain = (1.0 + section.a1 + section.a2) / 4.0;
+            section.b0 = gain;
+            section.b1 = 2.0 * gain;
+            section.b2 = gain;
+        } else {
+            section.a1 = -z.real();
+            const double gain = (1.0 + section.a1) / 2.0;
+            section.b0 = gain;
+            section.b1 = gain;
+        }
+        sections.push_back(section);
+    }
+
+    // Even-order Chebyshev starts the passband at the bottom of the ripple
+    if (spec.type == DesignType::Chebyshev && clamped.order % 2 == 0 && !sections.empty()) {
+        const double dcGain = std::pow(10.0, -std::max(spec.ripple, 1e-3) / 20.0);
+        sections.front().b0 *= dcGain;
+        sections.front().b1 *= dcGain;
+        sections.front().b2 *= dcGain;
+    }
+    return sections;
+}
+
+double magnitudeResponse(const std::vector<Biquad>& sections, double frequency, double sampleRate) {
+    // Evaluate every section on the unit circle at z = e^(jw)
+    const Complex z1 = std::polar(1.0, -2.0 * M_PI * frequency / sampleRate);
+    const Complex z2 = z1 * z1;
+    double gain = 1.0;
+    for (const auto& section : sections) {
+        gain *= std::abs((section.b0 + section.b1 * z1 + section.b2 * z2) / (1.0 + section.a1 * z1 + section.a2 * z2));
+    }
+    return gain;
+}
+
+BiquadCascade::BiquadCascade(std::shared_ptr<const std::vector<Biquad>> sections)
+    : sections_(std::move(sections))
+    , state_(sections_ ? sections_->size() : 0) {
+}
+
+void BiquadCascade::process(const double* in, double* out, size_t count) {
+    if (!sections_ || sections_->empty()) {
+        std::copy(in, in + count, out);
+        return;
+    }
+
+    // One section at a time over the whole block keeps its state in registers
+    const double* source = in;
+    for (size_t s = 0; s < sections_->size(); ++s) {
+        const Biquad& q = (*sections_)[s];
+        double z1 = state_[s].z1;
+        double z2 = state_[s].z2;
+        for (size_t i = 0; i < count; ++i) {
+            // Transposed direct form II
+            const double x = source[i];
+            const double y = q.b0 * x + z1;
+            z1 = q.b1 * x - q.a1 * y + z2;
+            z2 = q.b2 * x - q.a2 * y;
+            out[i] = y;
+        }
+        state_[s] = {z1, z2};
+        source = out;
+    }
+}
+
+void BiquadCascade::reset() {
+    std::fill(state_.begin(), state_.end(), State());
+}
+
+std::vector<double> BiquadCascade::stepResponse(size_t length) const {
+    BiquadCascade copy(sections_);
+    std::vector<double> response(length, 1.0);
+    copy.process(response.data(), response.data(), length);
+    return response;
+}
+
+std::shared_ptr<const std::vector<Biquad>> DesignCache::get(const DesignSpec& spec) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = designs_.find(spec);
+        if (it != designs_.end()) {
+            ++hits_;
+            return it->second;
+        }
+    }
+
+    // Design outside the lock; a racing thread may design the same spec once more
+    auto design = std::make_shared<const std::vector<Biquad>>(designLowPass(spec));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return designs_.emplace(spec, std::move(design)).first->second;
+}
+
+size_t DesignCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return designs_.size();
+}
+
+size_t DesignCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+void DesignCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    designs_.clear();
+    hits_ = 0;
+}
+
+} // namespace filter
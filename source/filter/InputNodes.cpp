@@ -1,76 +1,739 @@
 #include "../../include/filter/InputNodes.hpp"
 #include <algorithm>
+#include <limits>
+#include <cmath>
 
 namespace filter {
 
-LogFileInput::LogFileInput(const std::string& filename, const std::string& columnName)
-    : filename_(filename), columnName_(columnName), connected_(false) {
-    start();
+namespace {
+    // Text log timestamps are in seconds
+    int64_t toMicroseconds(double seconds) {
+        return static_cast<int64_t>(std::llround(seconds * 1e6));
+    }
+
+    // Move up to maxSamples pending samples (and their times) into the output
+    size_t movePending(std::vector<double>& pending, std::vector<int64_t>& pendingTimestamps,
+                       std::vector<int64_t>* timestampsUs, std::vector<double>& block, size_t maxSamples) {
+        const size_t count = std::min(maxSamples, pending.size());
+        block.insert(block.end(), pending.begin(), pending.begin() + count);
+        pending.erase(pending.begin(), pending.begin() + count);
+        if (timestampsUs) {
+            timestampsUs->insert(timestampsUs->end(), pendingTimestamps.begin(), pendingTimestamps.begin() + count);
+        }
+        pendingTimestamps.erase(pendingTimestamps.begin(), pendingTimestamps.begin() + count);
+        return count;
+    }
+
+    // Glob match supporting * (any run) and ? (any one character)
+    bool matchesGlob(const std::string& pattern, const std::string& text) {
+        size_t p = 0;
+        size_t t = 0;
+        size_t starPattern = std::string::npos;
+        size_t starText = 0;
+        while (t < text.size()) {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+                ++p;
+                ++t;
+            } else if (p < pattern.size() && pattern[p] == '*') {
+                starPattern = p++;
+                starText = t;
+            } else if (starPattern != std::string::npos) {
+                p = starPattern + 1;
+                t = ++starText;
+            } else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern[p] == '*') {
+            ++p;
+        }
+        return p == pattern.size();
+    }
+}
+
+LogFileInput::LogFileInput(const std::string& filename, const std::string& columnName, AsyncLogLoader& loader)
+    : filename_(filename), columnName_(columnName), loader_(&loader) {}
+
+LogFileInput::~LogFileInput() {
+    // The follower thread calls back into this object, so it is joined
+    // before any member it touches is destroyed
+    follower_.reset();
+    cancelLoad();
 }
 
 bool LogFileInput::isConnected() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
     return connected_;
 }
 
 std::vector<double> LogFileInput::getData() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return data_.values();
+}
+
+ColumnBuffer LogFileInput::getBuffer() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
     return data_;
 }
 
 void LogFileInput::start() {
-    if (filename_.empty() || columnName_.empty()) {
-        connected_ = false;
+    stop();
+    if (filename_.empty()) {
         return;
     }
 
-    parser_ = std::make_unique<LogFileParser>();
-    if (!parser_->loadFile(filename_)) {
-        connected_ = false;
+    if (follow_) {
+        // The follower reads the file on its own thread. Not under
+        // dataMutex_: the follower's callback takes it.
+        follower_ = std::make_unique<LogFileFollower>(filename_,
+            [this](const std::vector<std::string>& fields, const std::vector<LogEntry>& rows, bool restarted) {
+                onRowsAppended(fields, rows, restarted);
+            });
+        connected_ = follower_->start();
         return;
     }
 
-    data_ = parser_->getFieldData(columnName_);
-    connected_ = !data_.empty();
+    // Parsed on the loader's thread; picked up by adoptLoadedFile
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    loadTask_ = loader_->load(filename_);
 }
 
 void LogFileInput::stop() {
+    follower_.reset();
+    cancelLoad();
+
+    std::lock_guard<std::mutex> lock(dataMutex_);
     parser_.reset();
     connected_ = false;
-    data_.clear();
+    data_ = ColumnBuffer();
+    pyramid_.reset();
+    fields_.clear();
+    timestamps_.clear();
+    pending_.clear();
+    pendingTimestamps_.clear();
+}
+
+bool LogFileInput::isLoading() const {
+    // A followed file is first read in full on the follower's thread
+    if (follower_ && follower_->isLoading()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return loadTask_ != nullptr;
+}
+
+double LogFileInput::getLoadProgress() const {
+    if (follower_ && follower_->isLoading()) {
+        return follower_->getLoadProgress();
+    }
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return loadTask_ ? loadTask_->getProgress() : (parser_ ? 1.0 : 0.0);
+}
+
+void LogFileInput::cancelLoad() {
+    if (follower_ && follower_->isLoading()) {
+        follower_.reset();  // Stops the follower's first read
+        connected_ = false;
+    }
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (loadTask_) {
+        loader_->cancel(loadTask_);
+        loadTask_.reset();
+    }
+}
+
+void LogFileInput::adoptLoadedFile() const {
+    // Called with dataMutex_ held; the parser is swapped in as a whole
+    if (!loadTask_ || !loadTask_->isFinished()) {
+        return;
+    }
+    parser_ = loadTask_->getResult();
+    loadTask_.reset();
+    if (parser_) {
+        data_ = parser_->getFieldBuffer(columnName_, &pyramid_);
+        connected_ = !data_.empty();
+    }
+}
+
+size_t LogFileInput::readBlock(std::vector<double>& block, size_t maxSamples) {
+    return takePending(nullptr, block, maxSamples);
+}
+
+size_t LogFileInput::readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) {
+    return takePending(&timestampsUs, block, maxSamples);
+}
+
+size_t LogFileInput::takePending(std::vector<int64_t>* timestampsUs, std::vector<double>& block, size_t maxSamples) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return movePending(pending_, pendingTimestamps_, timestampsUs, block, maxSamples);
 }
 
-const std::vector<std::string>& LogFileInput::getAvailableFields() const {
-    static std::vector<std::string> empty;
-    return parser_ ? parser_->getFields() : empty;
+std::shared_ptr<data::MinMaxPyramid> LogFileInput::getPyramid(const ColumnBuffer& buffer) const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return pyramid_ && data_.sharesWith(buffer) ? pyramid_ : nullptr;
+}
+
+std::vector<int64_t> LogFileInput::getTimestamps() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    if (follow_ || !parser_) {
+        return timestamps_;
+    }
+
+    // Same rows getFieldBuffer takes the column from
+    std::vector<int64_t> timestamps;
+    for (const auto& entry : parser_->getEntries()) {
+        if (entry.values.count(columnName_) != 0) {
+            timestamps.push_back(toMicroseconds(entry.timestamp));
+        }
+    }
+    return timestamps;
+}
+
+std::vector<std::string> LogFileInput::getAvailableFields() const {
+    // A copy, since the follower thread may be filling in fields_
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (follow_) {
+        return fields_;
+    }
+    adoptLoadedFile();
+    return parser_ ? parser_->getFields() : std::vector<std::string>();
 }
 
 void LogFileInput::setColumnName(const std::string& columnName) {
+    if (follow_) {
+        {
+            std::lock_guard<std::mutex> lock(dataMutex_);
+            columnName_ = columnName;
+        }
+        // Re-read the file so the new column starts from the first row
+        stop();
+        start();
+        return;
+    }
+
+    // If the file is still loading, the new column is picked up when it is adopted
+    std::lock_guard<std::mutex> lock(dataMutex_);
     columnName_ = columnName;
+    if (parser_) {
+        data_ = parser_->getFieldBuffer(columnName_, &pyramid_);
+        connected_ = !data_.empty();
+    }
+}
+
+void LogFileInput::setFollow(bool follow) {
+    if (follow == follow_) {
+        return;
+    }
+    stop();
+    follow_ = follow;
+    start();
+}
+
+void LogFileInput::onRowsAppended(const std::vector<std::string>& fields, const std::vector<LogEntry>& rows, bool restarted) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (restarted) {
+        // The file started over; what was read before no longer applies.
+        // Rows already queued for the stream are still delivered.
+        data_ = ColumnBuffer();
+        timestamps_.clear();
+        fields_.clear();
+    }
+    if (fields_.empty()) {
+        fields_ = fields;
+    }
+
+    // Copy-on-write: readers holding the previous buffer keep their snapshot
+    auto& values = data_.mutableValues();
+    const size_t previousSize = values.size();
+    values.reserve(previousSize + rows.size());
+    for (const auto& row : rows) {
+        auto it = row.values.find(columnName_);
+        if (it != row.values.end()) {
+            values.push_back(it->second);
+            timestamps_.push_back(toMicroseconds(row.timestamp));
+        }
+    }
+    pending_.insert(pending_.end(), values.begin() + previousSize, values.end());
+    pendingTimestamps_.insert(pendingTimestamps_.end(), timestamps_.begin() + previousSize, timestamps_.end());
+}
+
+MultiColumnInput::MultiColumnInput(const std::string& filename, AsyncLogLoader& loader)
+    : filename_(filename), loader_(&loader) {}
+
+MultiColumnInput::~MultiColumnInput() {
+    cancelLoad();
+}
+
+bool MultiColumnInput::isConnected() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return !channels_.empty();
+}
+
+std::vector<double> MultiColumnInput::getData() const {
+    return getBuffer().values();
+}
+
+ColumnBuffer MultiColumnInput::getBuffer() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return channels_.empty() ? ColumnBuffer() : channels_.front().data;
+}
+
+std::vector<InputChannel> MultiColumnInput::getChannels() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return channels_;
+}
+
+void MultiColumnInput::start() {
+    stop();
+    if (filename_.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    loadTask_ = loader_->load(filename_);
+}
+
+void MultiColumnInput::stop() {
+    cancelLoad();
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    parser_.reset();
+    channels_.clear();
+}
+
+bool MultiColumnInput::isLoading() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return loadTask_ != nullptr;
+}
+
+double MultiColumnInput::getLoadProgress() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return loadTask_ ? loadTask_->getProgress() : (parser_ ? 1.0 : 0.0);
+}
+
+void MultiColumnInput::cancelLoad() {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (loadTask_) {
+        loader_->cancel(loadTask_);
+        loadTask_.reset();
+    }
+}
+
+std::vector<std::string> MultiColumnInput::getAvailableFields() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    adoptLoadedFile();
+    return parser_ ? parser_->getFields() : std::vector<std::string>();
+}
+
+void MultiColumnInput::setColumns(const std::vector<std::string>& columns) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    columns_ = columns;
+    selectChannels();
+}
+
+void MultiColumnInput::setPattern(const std::string& pattern) {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    pattern_ = pattern;
+    selectChannels();
+}
+
+void MultiColumnInput::adoptLoadedFile() const {
+    // Called with dataMutex_ held
+    if (!loadTask_ || !loadTask_->isFinished()) {
+        return;
+    }
+    parser_ = loadTask_->getResult();
+    loadTask_.reset();
+    selectChannels();
+}
+
+void MultiColumnInput::selectChannels() const {
+    // Called with dataMutex_ held; channels keep the file's column order
+    channels_.clear();
+    if (!parser_) {
+        return;
+    }
+    for (const auto& field : parser_->getFields()) {
+        const bool listed = std::find(columns_.begin(), columns_.end(), field) != columns_.end();
+        if (listed || (!pattern_.empty() && matchesGlob(pattern_, field))) {
+            channels_.push_back({field, parser_->getFieldBuffer(field)});
+        }
+    }
+}
+
+LogReplayInput::LogReplayInput(const std::string& filename, const std::string& field)
+    : filename_(filename), field_(field), source_(filename) {
+    source_.setBatchCallback([this](const std::vector<data::DataBatch>& batches) { onBatch(batches); });
+}
+
+LogReplayInput::~LogReplayInput() {
+    stop();
+}
+
+bool LogReplayInput::isConnected() const {
+    return connected_;
+}
+
+std::vector<double> LogReplayInput::getData() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return history_;
+}
+
+ColumnBuffer LogReplayInput::getBuffer() const {
+    // Copied here rather than on every batch, and only if samples arrived
+    // since the last call
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    if (snapshotStale_) {
+        snapshot_ = ColumnBuffer(history_);
+        snapshotStale_ = false;
+    }
+    return snapshot_;
+}
+
+void LogReplayInput::start() {
+    stop();
+    if (filename_.empty()) {
+        return;
+    }
+
+    // Mapping, decompressing and indexing a large log takes a while, so it
+    // runs off the owning thread; isLoading() starts the replay afterwards
+    connecting_ = true;
+    connectThread_ = std::thread([this]() {
+        subscribed_ = source_.connect() && !field_.empty() && source_.subscribe(field_);
+        connecting_ = false;
+    });
+}
+
+bool LogReplayInput::isLoading() {
+    finishConnect();
+    return connecting_;
+}
+
+void LogReplayInput::finishConnect() {
+    if (!connectThread_.joinable() || connecting_) {
+        return;
+    }
+    connectThread_.join();
+    if (subscribed_) {
+        restartReplay(std::numeric_limits<int64_t>::min());
+    }
+}
+
+void LogReplayInput::stop() {
+    // An index build cannot be interrupted, so it is waited for
+    if (connectThread_.joinable()) {
+        connectThread_.join();
+    }
+
+    // Release a replay thread that is waiting for the pipeline before joining it
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        stopping_ = true;
+    }
+    drained_.notify_all();
+    source_.stopReplay();
+    connected_ = false;
+
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    clearHistory();
+    pending_.clear();
+    pendingTimestamps_.clear();
+}
+
+void LogReplayInput::clearHistory() {
+    // Called with dataMutex_ held
+    history_.clear();
+    timestamps_.clear();
+    snapshot_ = ColumnBuffer();
+    snapshotStale_ = false;
+}
+
+void LogReplayInput::restartReplay(int64_t positionUs) {
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        stopping_ = true;
+    }
+    drained_.notify_all();
+    source_.stopReplay();
+
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        stopping_ = false;
+    }
+    options_.startUs = positionUs;
+    connected_ = source_.startReplay(options_);
+}
+
+size_t LogReplayInput::readBlock(std::vector<double>& block, size_t maxSamples) {
+    return takePending(nullptr, block, maxSamples);
+}
+
+size_t LogReplayInput::readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) {
+    return takePending(&timestampsUs, block, maxSamples);
+}
+
+size_t LogReplayInput::takePending(std::vector<int64_t>* timestampsUs, std::vector<double>& block, size_t maxSamples) {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        count = movePending(pending_, pendingTimestamps_, timestampsUs, block, maxSamples);
+    }
+    drained_.notify_all();
+    return count;
+}
+
+std::vector<int64_t> LogReplayInput::getTimestamps() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    return timestamps_;
+}
+
+std::vector<std::string> LogReplayInput::getAvailableFields() const {
+    return connecting_ ? std::vector<std::string>() : source_.getAvailableFields();
+}
+
+void LogReplayInput::setField(const std::string& field) {
+    stop();
+    if (source_.isConnected()) {
+        source_.unsubscribe(field_);
+    }
+    field_ = field;
+    start();  // The log stays indexed, so this only subscribes again
+}
+
+void LogReplayInput::setSpeed(double speed) {
+    options_.speed = speed;
     if (connected_) {
-        data_ = parser_->getFieldData(columnName_);
+        // Continue from the current position with the new pacing
+        restartReplay(source_.getReplayPosition());
+    }
+}
+
+void LogReplayInput::setLoop(bool loop) {
+    options_.loop = loop;
+    if (connected_) {
+        restartReplay(source_.getReplayPosition());
+    }
+}
+
+void LogReplayInput::seek(double seconds) {
+    if (connecting_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        clearHistory();
+    }
+    source_.seekReplay(source_.getStartTime() + static_cast<int64_t>(seconds * 1e6));
+}
+
+double LogReplayInput::getPosition() const {
+    return connecting_ ? 0.0 : (source_.getReplayPosition() - source_.getStartTime()) * 1e-6;
+}
+
+double LogReplayInput::getDuration() const {
+    return connecting_ ? 0.0 : (source_.getEndTime() - source_.getStartTime()) * 1e-6;
+}
+
+void LogReplayInput::onBatch(const std::vector<data::DataBatch>& batches) {
+    std::unique_lock<std::mutex> lock(dataMutex_);
+    for (const auto& batch : batches) {
+        // Backpressure: as-fast-as-possible replay runs at the pipeline's pace
+        drained_.wait(lock, [&]() { return stopping_ || pending_.size() < maxPending_; });
+        if (stopping_) {
+            return;
+        }
+
+        // Log time going back means the replay looped or was seeked; the
+        // history holds one pass, so it does not grow while looping
+        if (batch.count > 0 && !timestamps_.empty() && batch.timestampsUs[0] < timestamps_.back()) {
+            clearHistory();
+        }
+
+        history_.insert(history_.end(), batch.values, batch.values + batch.count);
+        snapshotStale_ = true;
+        timestamps_.insert(timestamps_.end(), batch.timestampsUs, batch.timestampsUs + batch.count);
+        pending_.insert(pending_.end(), batch.values, batch.values + batch.count);
+        pendingTimestamps_.insert(pendingTimestamps_.end(), batch.timestampsUs, batch.timestampsUs + batch.count);
     }
 }
 
 NetworkTableInput::NetworkTableInput(const std::string& tableName, const std::string& key)
-    : tableName_(tableName), key_(key), useUSB_(true), teamNumber_(0), connected_(false) {
-    start();
+    : tableName_(tableName), key_(key)
+    , instance_(nt::NetworkTableInstance::Create()), ownsInstance_(true)
+    , samples_(kRingCapacity), scratch_(1024) {}
+
+NetworkTableInput::NetworkTableInput(const std::string& tableName, const std::string& key, nt::NetworkTableInstance instance)
+    : tableName_(tableName), key_(key)
+    , instance_(instance), ownsInstance_(false)
+    , samples_(kRingCapacity), scratch_(1024) {}
+
+NetworkTableInput::~NetworkTableInput() {
+    stop();
+    if (ownsInstance_) {
+        nt::NetworkTableInstance::Destroy(instance_);
+    }
 }
 
 bool NetworkTableInput::isConnected() const {
-    return connected_;
+    return connected_.load();
 }
 
 std::vector<double> NetworkTableInput::getData() const {
-    return data_;
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    const size_t count = std::min(data_.size(), historyLimit_.load());
+    return std::vector<double>(data_.end() - count, data_.end());
 }
 
 void NetworkTableInput::start() {
-    // TODO: Implement NetworkTable connection
-    connected_ = false;
+    stop();
+    if (tableName_.empty() || key_.empty()) {
+        return;
+    }
+
+    if (ownsInstance_) {
+        instance_.StartClient4("FilterDesign");
+        if (!useUSB_ && ipAddress_.empty() && teamNumber_ > 0) {
+            instance_.SetServerTeam(static_cast<unsigned int>(teamNumber_));
+        } else {
+            instance_.SetServer(getServerAddress());
+        }
+        connectionListener_ = instance_.AddConnectionListener(true, [this](const nt::Event& event) {
+            connected_.store(event.Is(nt::EventFlags::kConnected));
+        });
+    } else {
+        // A borrowed instance is already serving or connected
+        connected_.store(true);
+    }
+
+    // Every update is delivered, not just the latest value per network tick
+    nt::PubSubOptions options;
+    options.sendAll = true;
+    options.keepDuplicates = true;
+    subscriber_ = instance_.GetTable(tableName_)->GetTopic(key_).GenericSubscribe(options);
+
+    // ntcore calls this from its single listener thread: the only producer
+    valueListener_ = instance_.AddListener(subscriber_, nt::EventFlags::kValueAll, [this](const nt::Event& event) {
+        const nt::ValueEventData* valueData = event.GetValueEventData();
+        if (!valueData) {
+            return;
+        }
+        const nt::Value& value = valueData->value;
+        if (value.IsDouble()) {
+            onValueChanged(value.GetDouble(), value.time());
+        } else if (value.IsFloat()) {
+            onValueChanged(value.GetFloat(), value.time());
+        } else if (value.IsInteger()) {
+            onValueChanged(static_cast<double>(value.GetInteger()), value.time());
+        } else if (value.IsBoolean()) {
+            onValueChanged(value.GetBoolean() ? 1.0 : 0.0, value.time());
+        }
+    });
 }
 
 void NetworkTableInput::stop() {
-    connected_ = false;
+    if (valueListener_ != 0) {
+        nt::NetworkTableInstance::RemoveListener(valueListener_);
+        valueListener_ = 0;
+    }
+    if (connectionListener_ != 0) {
+        nt::NetworkTableInstance::RemoveListener(connectionListener_);
+        connectionListener_ = 0;
+    }
+    // Let a callback that is already running finish before the subscriber goes away
+    instance_.WaitForListenerQueue(1.0);
+    subscriber_ = nt::GenericSubscriber();
+    if (ownsInstance_) {
+        instance_.StopClient();
+    }
+    connected_.store(false);
+
+    // The ring has a single consumer, so the next read skips what is left
+    // instead of emptying it here. Counting keeps updates that arrive after
+    // a restart, which a blanket discard on the next read would lose.
+    discardUntil_.store(pushedSamples_.load());
+    std::lock_guard<std::mutex> lock(dataMutex_);
     data_.clear();
+    timestamps_.clear();
+}
+
+size_t NetworkTableInput::readBlock(std::vector<double>& block, size_t maxSamples) {
+    size_t total = 0;
+    while (total < maxSamples) {
+        const size_t count = readSamples(scratch_.data(), std::min(scratch_.size(), maxSamples - total));
+        if (count == 0) {
+            break;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            block.push_back(scratch_[i].value);
+        }
+        total += count;
+    }
+    return total;
+}
+
+size_t NetworkTableInput::readTimestampedBlock(std::vector<int64_t>& timestampsUs, std::vector<double>& block, size_t maxSamples) {
+    size_t total = 0;
+    while (total < maxSamples) {
+        const size_t count = readSamples(scratch_.data(), std::min(scratch_.size(), maxSamples - total));
+        if (count == 0) {
+            break;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            timestampsUs.push_back(scratch_[i].timestampUs);
+            block.push_back(scratch_[i].value);
+        }
+        total += count;
+    }
+    return total;
+}
+
+std::vector<int64_t> NetworkTableInput::getTimestamps() const {
+    std::lock_guard<std::mutex> lock(dataMutex_);
+    const size_t count = std::min(timestamps_.size(), historyLimit_.load());
+    return std::vector<int64_t>(timestamps_.end() - count, timestamps_.end());
+}
+
+size_t NetworkTableInput::readSamples(TimestampedSample* samples, size_t maxSamples) {
+    // Samples from before a restart are dropped in the ring, not copied out
+    const uint64_t discardUntil = discardUntil_.load();
+    if (poppedSamples_ < discardUntil) {
+        poppedSamples_ += samples_.discard(static_cast<size_t>(discardUntil - poppedSamples_));
+    }
+
+    const size_t count = samples_.pop(samples, maxSamples);
+    poppedSamples_ += count;
+    const size_t limit = historyLimit_.load(std::memory_order_relaxed);
+    if (count > 0 && limit > 0) {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        for (size_t i = 0; i < count; ++i) {
+            data_.push_back(samples[i].value);
+            timestamps_.push_back(samples[i].timestampUs);
+        }
+        // Dropped in bulk, so trimming stays O(1) per sample
+        if (data_.size() >= 2 * limit) {
+            const auto excess = static_cast<std::ptrdiff_t>(data_.size() - limit);
+            data_.erase(data_.begin(), data_.begin() + excess);
+            timestamps_.erase(timestamps_.begin(), timestamps_.begin() + excess);
+        }
+    }
+    return count;
+}
+
+void NetworkTableInput::setHistoryLimit(size_t maxSamples) {
+    historyLimit_.store(maxSamples);
+    if (maxSamples == 0) {
+        std::lock_guard<std::mutex> lock(dataMutex_);
+        data_.clear();
+        timestamps_.clear();
+    }
 }
 
 void NetworkTableInput::setUseUSB(bool useUSB) {
@@ -79,23 +742,100 @@ void NetworkTableInput::setUseUSB(bool useUSB) {
 
 void NetworkTableInput::setTeamNumber(int teamNumber) {
     teamNumber_ = teamNumber;
+    ipAddress_.clear();
 }
 
 void NetworkTableInput::setIPAddress(const std::string& ipAddress) {
     ipAddress_ = ipAddress;
 }
 
-void NetworkTableInput::updateLoop() {
-    // TODO: Implement NetworkTable update loop
+void NetworkTableInput::setRecorder(std::shared_ptr<data::WpiLogRecorder::Channel> channel) {
+    std::atomic_store(&recordChannel_, std::move(channel));
 }
 
-void NetworkTableInput::onValueChanged(double value) {
-    // TODO: Implement value change handler
+void NetworkTableInput::onValueChanged(double value, int64_t timestampUs) {
+    if (samples_.tryPush(TimestampedSample{timestampUs, value})) {
+        pushedSamples_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        droppedSamples_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (auto channel = std::atomic_load(&recordChannel_)) {
+        channel->record(timestampUs, value);
+    }
 }
 
 std::string NetworkTableInput::getServerAddress() const {
-    // TODO: Implement server address generation
-    return "";
+    if (useUSB_) {
+        return "172.22.11.2";  // roboRIO over USB
+    }
+    if (!ipAddress_.empty()) {
+        return ipAddress_;
+    }
+    // Team number without a team set falls back to a local server
+    return "localhost";
+}
+
+ResamplingInput::ResamplingInput(std::shared_ptr<InputNode> source, double outputRate,
+                                 Interpolation method, double maxGapSeconds)
+    : source_(std::move(source)), outputRate_(outputRate), method_(method), maxGapSeconds_(maxGapSeconds)
+    , resampler_(outputRate, method, maxGapSeconds) {}
+
+bool ResamplingInput::isConnected() const {
+    return source_ && source_->isConnected();
+}
+
+std::vector<double> ResamplingInput::getData() const {
+    if (!source_) {
+        return {};
+    }
+    std::vector<double> values = source_->getData();
+    std::vector<int64_t> timestamps = source_->getTimestamps();
+    if (timestamps.size() != values.size()) {
+        return values;
+    }
+
+    // Batch runs use their own resampler so the streaming state is left alone
+    Resampler resampler(outputRate_, method_, maxGapSeconds_);
+    return resampler.resample(timestamps, values);
+}
+
+void ResamplingInput::start() {
+    stop();
+    if (source_) {
+        source_->start();
+    }
+}
+
+void ResamplingInput::stop() {
+    if (source_) {
+        source_->stop();
+    }
+    resampler_.reset();
+    resampled_.clear();
+}
+
+size_t ResamplingInput::readBlock(std::vector<double>& block, size_t maxSamples) {
+    if (!source_) {
+        return 0;
+    }
+
+    // Untimed sources pass through
+    if (!source_->hasTimestamps()) {
+        return source_->readBlock(block, maxSamples);
+    }
+
+    if (resampled_.size() < maxSamples) {
+        blockTimes_.clear();
+        blockValues_.clear();
+        if (source_->readTimestampedBlock(blockTimes_, blockValues_, maxSamples) > 0) {
+            resampler_.process(blockTimes_.data(), blockValues_.data(), blockValues_.size(), resampled_);
+        }
+    }
+
+    const size_t count = std::min(maxSamples, resampled_.size());
+    block.insert(block.end(), resampled_.begin(), resampled_.begin() + count);
+    resampled_.erase(resampled_.begin(), resampled_.begin() + count);
+    return count;
 }
 
 } // namespace filter
@@ -0,0 +1,235 @@
+#include "../../include/filter/KalmanFilter.hpp"
+#include <frc/system/Discretization.h>
+#include <units/time.h>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace filter {
+
+namespace {
+    constexpr double kPi = 3.14159265358979323846;
+
+    // Keeps the innovation covariance invertible when the noise is set to zero
+    constexpr double kMinNoise = 1e-9;
+
+    template <int States>
+    KalmanModel<States, 1> kinematicModel(const KinematicSettings& settings) {
+        // Each state is the derivative of the one before; white noise drives the last
+        frc::Matrixd<States, States> contA = frc::Matrixd<States, States>::Zero();
+        for (int i = 0; i + 1 < States; ++i) {
+            contA(i, i + 1) = 1.0;
+        }
+        frc::Matrixd<States, States> contQ = frc::Matrixd<States, States>::Zero();
+        const double processNoise = std::max(settings.processNoise, kMinNoise);
+        contQ(States - 1, States - 1) = processNoise * processNoise;
+
+        KalmanModel<States, 1> model;
+        frc::DiscretizeAQ<States>(contA, contQ, units::second_t{1.0 / settings.sampleRate}, &model.A, &model.Q);
+        model.C = frc::Matrixd<1, States>::Zero();
+        model.C(0, 0) = 1.0;
+        const double measurementNoise = std::max(settings.measurementNoise, kMinNoise);
+        model.R(0, 0) = measurementNoise * measurementNoise;
+        return model;
+    }
+
+    KinematicSettings sanitize(KinematicSettings settings, int states) {
+        if (!(settings.sampleRate > 0.0)) {
+            settings.sampleRate = 1.0;
+        }
+        settings.output = std::clamp(settings.output, 0, states - 1);
+        return settings;
+    }
+
+    // Roots of b[0] z^n + b[1] z^(n-1) + ... + b[n]
+    std::vector<std::complex<double>> roots(std::vector<double> coefficients) {
+        while (!coefficients.empty() && coefficients.front() == 0.0) {
+            coefficients.erase(coefficients.begin());
+        }
+        while (!coefficients.empty() && coefficients.back() == 0.0) {
+            coefficients.pop_back();
+        }
+        if (coefficients.size() < 2) {
+            return {};
+        }
+
+        // Eigenvalues of the companion matrix
+        const auto degree = static_cast<Eigen::Index>(coefficients.size() - 1);
+        Eigen::MatrixXd companion = Eigen::MatrixXd::Zero(degree, degree);
+        for (Eigen::Index i = 0; i < degree; ++i) {
+            companion(0, i) = -coefficients[static_cast<size_t>(i + 1)] / coefficients.front();
+        }
+        for (Eigen::Index i = 1; i < degree; ++i) {
+            companion(i, i - 1) = 1.0;
+        }
+        const Eigen::VectorXcd values = Eigen::EigenSolver<Eigen::MatrixXd>(companion, false).eigenvalues();
+        return std::vector<std::complex<double>>(values.data(), values.data() + values.size());
+    }
+}
+
+template <int States>
+KinematicKalmanFilter<States>::KinematicKalmanFilter(const KinematicSettings& settings)
+    : settings_(sanitize(settings, States))
+    , estimator_(kinematicModel<States>(settings_), settings_.steadyState) {
+}
+
+template <int States>
+double KinematicKalmanFilter<States>::output() const {
+    // No estimate before the first valid sample
+    return estimator_.isInitialized() ? estimator_.getState()(settings_.output)
+                                      : std::numeric_limits<double>::quiet_NaN();
+}
+
+template <int States>
+double KinematicKalmanFilter<States>::processSample(double input) {
+    frc::Vectord<1> y;
+    y(0) = input;
+    estimator_.update(y);
+    return output();
+}
+
+template <int States>
+std::vector<double> KinematicKalmanFilter<States>::processBlock(const std::vector<double>& input) {
+    // The estimate carries over, so consecutive streamed blocks match one
+    // long block; the pipeline resets the filter before a batch run
+    std::vector<double> result(input.size());
+    frc::Vectord<1> y;
+    for (size_t i = 0; i < input.size(); ++i) {
+        y(0) = input[i];
+        estimator_.update(y);
+        result[i] = output();
+    }
+    return result;
+}
+
+template <int States>
+std::vector<double> KinematicKalmanFilter<States>::getNumeratorCoefficients() const {
+    // Steady state: x[k] = F x[k-1] + K y[k] with F = (I - K C) A. The
+    // adjugate of (zI - F) expands as sum of B_i z^(n-1-i) (Faddeev-LeVerrier),
+    // so b_i = e B_i K for the output row e.
+    const auto& model = estimator_.getModel();
+    const auto& K = estimator_.getSteadyStateGain();
+    const frc::Matrixd<States, States> F = (frc::Matrixd<States, States>::Identity() - K * model.C) * model.A;
+    frc::Matrixd<States, States> B = frc::Matrixd<States, States>::Identity();
+    std::vector<double> b;
+    for (int i = 0; i < States; ++i) {
+        b.push_back((B * K)(settings_.output, 0));
+        const frc::Matrixd<States, States> product = F * B;
+        B = product - (product.trace() / (i + 1)) * frc::Matrixd<States, States>::Identity();
+    }
+    return b;
+}
+
+template <int States>
+std::vector<double> KinematicKalmanFilter<States>::getDenominatorCoefficients() const {
+    // Characteristic polynomial of F, from the same recursion
+    const auto& model = estimator_.getModel();
+    const auto& K = estimator_.getSteadyStateGain();
+    const frc::Matrixd<States, States> F = (frc::Matrixd<States, States>::Identity() - K * model.C) * model.A;
+    frc::Matrixd<States, States> B = frc::Matrixd<States, States>::Identity();
+    std::vector<double> a{1.0};
+    for (int i = 0; i < States; ++i) {
+        const frc::Matrixd<States, States> product = F * B;
+        a.push_back(-product.trace() / (i + 1));
+        B = product + a.back() * frc::Matrixd<States, States>::Identity();
+    }
+    return a;
+}
+
+template <int States>
+std::vector<std::complex<double>> KinematicKalmanFilter<States>::getPoles() const {
+    return roots(getDenominatorCoefficients());
+}
+
+template <int States>
+std::vector<std::complex<double>> KinematicKalmanFilter<States>::getZeros() const {
+    return roots(getNumeratorCoefficients());
+}
+
+template <int States>
+std::vector<std::complex<double>> KinematicKalmanFilter<States>::getFrequencyResponse(const std::vector<double>& frequencies) const {
+    std::vector<std::complex<double>> response;
+    response.reserve(frequencies.size());
+    for (double frequency : frequencies) {
+        response.push_back(evaluateTransferFunction(std::polar(1.0, 2.0 * kPi * frequency / settings_.sampleRate)));
+    }
+    return response;
+}
+
+template <int States>
+std::complex<double> KinematicKalmanFilter<States>::evaluateTransferFunction(const std::complex<double>& z) const {
+    const std::vector<double> b = getNumeratorCoefficients();
+    const std::vector<double> a = getDenominatorCoefficients();
+    const std::complex<double> zInverse = 1.0 / z;
+    std::complex<double> numerator = 0.0;
+    std::complex<double> denominator = 0.0;
+    std::complex<double> power = 1.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (i < b.size()) {
+            numerator += b[i] * power;
+        }
+        denominator += a[i] * power;
+        power *= zInverse;
+    }
+    return numerator / denominator;
+}
+
+template <int States>
+std::string KinematicKalmanFilter<States>::getTypeName() const {
+    return States == 2 ? "ConstantVelocityKalman" : "ConstantAccelerationKalman";
+}
+
+template <int States>
+std::shared_ptr<Filter> KinematicKalmanFilter<States>::clone() const {
+    return std::make_shared<KinematicKalmanFilter<States>>(*this);
+}
+
+template <int States>
+void KinematicKalmanFilter<States>::setParameter(const std::string& name, double value) {
+    KinematicSettings settings = settings_;
+    if (name == "sampleRate") {
+        settings.sampleRate = value;
+    } else if (name == "processNoise") {
+        settings.processNoise = value;
+    } else if (name == "measurementNoise") {
+        settings.measurementNoise = value;
+    } else if (name == "steadyState") {
+        settings.steadyState = value != 0.0;
+    } else if (name == "output") {
+        settings.output = static_cast<int>(value);
+    } else {
+        throw std::invalid_argument("Unknown parameter: " + name);
+    }
+    *this = KinematicKalmanFilter<States>(settings);
+}
+
+template <int States>
+double KinematicKalmanFilter<States>::getParameter(const std::string& name) const {
+    if (name == "sampleRate") {
+        return settings_.sampleRate;
+    } else if (name == "processNoise") {
+        return settings_.processNoise;
+    } else if (name == "measurementNoise") {
+        return settings_.measurementNoise;
+    } else if (name == "steadyState") {
+        return settings_.steadyState ? 1.0 : 0.0;
+    } else if (name == "output") {
+        return static_cast<double>(settings_.output);
+    } else {
+        throw std::invalid_argument("Unknown parameter: " + name);
+    }
+}
+
+template class KinematicKalmanFilter<2>;
+template class KinematicKalmanFilter<3>;
+
+std::shared_ptr<Filter> makeKinematicKalmanFilter(KinematicModel model, const KinematicSettings& settings) {
+    if (model == KinematicModel::ConstantAcceleration) {
+        return std::make_shared<ConstantAccelerationKalmanFilter>(settings);
+    }
+    return std::make_shared<ConstantVelocityKalmanFilter>(settings);
+}
+
+} // namespace filter
@@ -0,0 +1,144 @@
+#include "../../include/filter/LogFileFollower.hpp"
+#include <fstream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace filter {
+
+LogFileFollower::LogFileFollower(const std::string& filename, RowsCallback callback)
+    : filename_(filename), callback_(std::move(callback)) {}
+
+LogFileFollower::~LogFileFollower() {
+    stop();
+}
+
+bool LogFileFollower::start() {
+    if (running_) {
+        return true;
+    }
+    stop();  // Reap a watcher that gave up on the file
+
+    if (!std::ifstream(filename_, std::ios::binary).is_open()) {
+        return false;
+    }
+
+    loading_ = true;
+    loadProgress_ = 0.0;
+    running_ = true;
+    watchThread_ = std::thread(&LogFileFollower::watchLoop, this);
+    return true;
+}
+
+void LogFileFollower::stop() {
+    running_ = false;
+    if (watchThread_.joinable()) {
+        watchThread_.join();
+    }
+    closeWatch();
+    parser_.clear();
+    publishedCount_ = 0;
+    loading_ = false;
+}
+
+void LogFileFollower::watchLoop() {
+    // A large file takes a while to parse; stop() cancels it
+    if (!parser_.openFollow(filename_, [this](double fraction) {
+            loadProgress_ = fraction;
+            return running_.load();
+        })) {
+        running_ = false;
+        loading_ = false;
+        return;
+    }
+
+    // Rows already in the file are delivered as the first block
+    publishedCount_ = 0;
+    publishedRestarts_ = parser_.getRestartCount();
+    publishNewRows();
+    openWatch();
+    loading_ = false;
+
+    while (running_) {
+        waitForChange();
+        if (!running_) {
+            break;
+        }
+        // Published even without new rows, so a restart to an empty file is seen
+        parser_.readAppended();
+        publishNewRows();
+    }
+}
+
+void LogFileFollower::waitForChange() {
+#ifdef __linux__
+    if (inotifyFd_ >= 0) {
+        // Block until the writer touches the file, waking up periodically to check running_
+        pollfd pfd{inotifyFd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, static_cast<int>(pollInterval_.count()));
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            // Drain the event queue; the parser works out what changed on its own
+            char events[4096];
+            while (::read(inotifyFd_, events, sizeof(events)) > 0) {
+            }
+        }
+        return;
+    }
+#endif
+    std::this_thread::sleep_for(pollInterval_);
+}
+
+void LogFileFollower::publishNewRows() {
+    // The parser starts over if the file was truncated, rewritten or replaced
+    const auto& entries = parser_.getEntries();
+    const bool restarted = parser_.getRestartCount() != publishedRestarts_;
+    if (restarted) {
+        publishedRestarts_ = parser_.getRestartCount();
+        publishedCount_ = 0;
+    }
+    if (!restarted && entries.size() == publishedCount_) {
+        return;
+    }
+
+    std::vector<LogEntry> rows(entries.begin() + publishedCount_, entries.end());
+    publishedCount_ = entries.size();
+    if (callback_) {
+        callback_(parser_.getFields(), rows, restarted);
+    }
+}
+
+bool LogFileFollower::openWatch() {
+#ifdef __linux__
+    inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        return false;
+    }
+    watchFd_ = ::inotify_add_watch(inotifyFd_, filename_.c_str(),
+                                   IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB);
+    if (watchFd_ < 0) {
+        closeWatch();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LogFileFollower::closeWatch() {
+#ifdef __linux__
+    if (inotifyFd_ >= 0) {
+        if (watchFd_ >= 0) {
+            ::inotify_rm_watch(inotifyFd_, watchFd_);
+        }
+        ::close(inotifyFd_);
+    }
+#endif
+    inotifyFd_ = -1;
+    watchFd_ = -1;
+}
+
+} // namespace filter
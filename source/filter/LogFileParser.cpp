@@ -1,43 +1,199 @@
 #include "../../include/filter/LogFileParser.hpp"
+#include "../../include/data/CompressedStream.hpp"
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
 
 namespace filter {
 
-bool LogFileParser::loadFile(const std::string& filename) {
+namespace {
+    // Bytes compared on each read of a followed file to check that the part
+    // already parsed is still there
+    constexpr size_t kLastBytesSize = 256;
+}
+
+bool LogFileParser::loadFile(const std::string& filename, const ProgressCallback& progress) {
     clear();
     
-    file_.open(filename);
-    if (!file_.is_open()) {
+    // Compressed logs are decompressed on the fly
+    auto stream = data::openLogStream(filename);
+    if (!stream) {
         return false;
     }
 
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(filename, ec);
+    const double totalBytes = ec || fileSize == 0 ? 1.0 : static_cast<double>(fileSize);
+
     std::string line;
-    bool headerParsed = false;
+    size_t lineCount = 0;
 
     // Read and process each line
-    while (std::getline(file_, line)) {
-        if (!headerParsed) {
-            if (parseHeader(line)) {
-                headerParsed = true;
-            }
-        } else {
-            parseData(line);
+    while (std::getline(*stream, line)) {
+        processLine(line);
+
+        // Progress is reported every few thousand lines to keep the loop cheap
+        if (progress && (++lineCount & 0xFFF) == 0 &&
+            !progress(std::min(1.0, data::logStreamBytesRead(*stream) / totalBytes))) {
+            clear();
+            return false;
         }
     }
 
-    file_.close();
+    // A corrupt or truncated compressed file fails the load instead of
+    // leaving it partly read
+    if (stream->bad()) {
+        clear();
+        return false;
+    }
+
+    if (progress) {
+        progress(1.0);
+    }
     return !entries_.empty();
 }
 
+bool LogFileParser::openFollow(const std::string& filename, const ProgressCallback& progress) {
+    clear();
+
+    file_.open(filename, std::ios::binary);
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    filename_ = filename;
+    following_ = true;
+
+    // Parse whatever has been written so far; the rest arrives via readAppended()
+    bool cancelled = false;
+    readAppended([&](double fraction) {
+        cancelled = progress && !progress(fraction);
+        return !cancelled;
+    });
+    if (cancelled) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+size_t LogFileParser::readAppended(const ProgressCallback& progress) {
+    if (!following_) {
+        return 0;
+    }
+
+    std::error_code ec;
+    auto size = static_cast<std::streamoff>(std::filesystem::file_size(filename_, ec));
+    if (ec) {
+        return 0;
+    }
+
+    // Reopened on every read, so a file replaced at the same path is seen
+    file_.close();
+    file_.clear();
+    file_.open(filename_, std::ios::binary);
+    if (!file_.is_open()) {
+        return 0;
+    }
+
+    // A file that shrank, or whose parsed part changed, was truncated,
+    // rewritten or replaced: start over from the beginning. Checking the
+    // content also catches a rewrite that has already grown past the old size.
+    if (size < readOffset_ || !matchesLastBytes()) {
+        std::string filename = filename_;
+        clear();
+        file_.open(filename, std::ios::binary);
+        if (!file_.is_open()) {
+            return 0;
+        }
+        filename_ = filename;
+        following_ = true;
+        ++restartCount_;
+    }
+    if (size == readOffset_) {
+        return 0;
+    }
+
+    const size_t previousCount = entries_.size();
+
+    // Only read the bytes appended since the last call
+    file_.clear();
+    file_.seekg(readOffset_);
+
+    char buffer[64 * 1024];
+    while (file_.read(buffer, sizeof(buffer)) || file_.gcount() > 0) {
+        const std::streamsize count = file_.gcount();
+        readOffset_ += count;
+
+        const size_t keep = std::min(static_cast<size_t>(count), kLastBytesSize);
+        lastBytes_.append(buffer + count - keep, keep);
+        if (lastBytes_.size() > kLastBytesSize) {
+            lastBytes_.erase(0, lastBytes_.size() - kLastBytesSize);
+        }
+
+        const char* begin = buffer;
+        const char* end = buffer + count;
+        while (begin < end) {
+            const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            if (!newline) {
+                // Keep the incomplete trailing line until the writer finishes it
+                partialLine_.append(begin, end);
+                break;
+            }
+            partialLine_.append(begin, newline);
+            if (!partialLine_.empty() && partialLine_.back() == '\r') {
+                partialLine_.pop_back();
+            }
+            processLine(partialLine_);
+            partialLine_.clear();
+            begin = newline + 1;
+        }
+
+        // Reported once per chunk; the bytes read so far stay parsed when cancelled
+        if (progress && !progress(std::min(1.0, static_cast<double>(readOffset_) / size))) {
+            break;
+        }
+    }
+
+    return entries_.size() - previousCount;
+}
+
+bool LogFileParser::matchesLastBytes() {
+    if (lastBytes_.empty()) {
+        return true;
+    }
+    std::string current(lastBytes_.size(), '\0');
+    file_.clear();
+    file_.seekg(readOffset_ - static_cast<std::streamoff>(lastBytes_.size()));
+    return file_.read(current.data(), static_cast<std::streamsize>(current.size())) && current == lastBytes_;
+}
+
 void LogFileParser::clear() {
     entries_.clear();
     fields_.clear();
     fieldIndices_.clear();
+    columnCache_.clear();
     if (file_.is_open()) {
         file_.close();
     }
+    file_.clear();
+    filename_.clear();
+    partialLine_.clear();
+    readOffset_ = 0;
+    lastBytes_.clear();
+    headerParsed_ = false;
+    following_ = false;
+}
+
+void LogFileParser::processLine(const std::string& line) {
+    if (!headerParsed_) {
+        headerParsed_ = parseHeader(line);
+    } else {
+        parseData(line);
+    }
 }
 
 bool LogFileParser::parseHeader(const std::string& line) {
@@ -105,4 +261,45 @@ std::vector<double> LogFileParser::getFieldData(const std::string& fieldName) co
     return data;
 }
 
-} // namespace filter 
\ No newline at end of file
+ColumnBuffer LogFileParser::getFieldBuffer(const std::string& fieldName,
+                                           std::shared_ptr<data::MinMaxPyramid>* pyramid) const {
+    // A loaded parser may be shared by several inputs on different threads
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = columnCache_.find(fieldName);
+    if (it == columnCache_.end() || it->second.rows > entries_.size()) {
+        CachedColumn& cached = columnCache_[fieldName];
+        cached.buffer = ColumnBuffer(getFieldData(fieldName));
+        cached.pyramid = std::make_shared<data::MinMaxPyramid>();
+        cached.pyramid->build(cached.buffer.values());
+        cached.rows = entries_.size();
+        if (pyramid) {
+            *pyramid = cached.pyramid;
+        }
+        return cached.buffer;
+    }
+
+    // Rows are only appended between clears, so a cached column is extended
+    // with the new rows rather than rebuilt; it is copied first only if an
+    // earlier buffer is still held elsewhere
+    CachedColumn& cached = it->second;
+    if (cached.rows < entries_.size()) {
+        std::vector<double>& values = cached.buffer.mutableValues();
+        for (size_t i = cached.rows; i < entries_.size(); ++i) {
+            auto value = entries_[i].values.find(fieldName);
+            if (value != entries_[i].values.end()) {
+                values.push_back(value->second);
+            }
+        }
+        cached.rows = entries_.size();
+        if (cached.pyramid.use_count() > 1) {
+            cached.pyramid = std::make_shared<data::MinMaxPyramid>(*cached.pyramid);
+        }
+        cached.pyramid->update(values);
+    }
+    if (pyramid) {
+        *pyramid = cached.pyramid;
+    }
+    return cached.buffer;
+}
+
+} // namespace filter
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "../../include/filter/LogFileWindowReader.hpp"
+#include "../../include/data/CompressedStream.hpp"
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+
+namespace filter {
+
+bool LogFileWindowReader::open(const std::string& filename) {
+    close();
+
+    // Compressed logs are decompressed on the fly; progress then counts decompressed bytes
+    stream_ = data::openLogStream(filename);
+    if (!stream_) {
+        return false;
+    }
+
+    std::error_code ec;
+    if (data::detectCompression(filename) == data::Compression::None) {
+        fileSize_ = std::filesystem::file_size(filename, ec);
+    }
+
+    // The first line with at least one field name is the header
+    std::string line;
+    while (std::getline(*stream_, line)) {
+        bytesRead_ += line.size() + 1;
+
+        std::istringstream iss(line);
+        std::string field;
+
+        // Skip timestamp column
+        if (!(iss >> field)) {
+            continue;
+        }
+
+        while (iss >> field) {
+            field.erase(std::remove(field.begin(), field.end(), '"'), field.end());
+            fields_.push_back(field);
+            fieldIndices_[field] = fields_.size() - 1;
+        }
+        if (!fields_.empty()) {
+            break;
+        }
+    }
+
+    lastValues_.assign(fields_.size(), 0.0);
+    return !fields_.empty() && !stream_->bad();
+}
+
+bool LogFileWindowReader::selectColumn(const std::string& columnName) {
+    auto it = fieldIndices_.find(columnName);
+    if (it == fieldIndices_.end()) {
+        return false;
+    }
+    columnIndex_ = it->second;
+    return true;
+}
+
+size_t LogFileWindowReader::readWindow(size_t maxRows, std::vector<double>& timestamps, std::vector<double>& values) {
+    timestamps.clear();
+    values.clear();
+    if (!stream_ || fields_.empty()) {
+        return 0;
+    }
+
+    std::string line;
+    while (timestamps.size() < maxRows && std::getline(*stream_, line)) {
+        bytesRead_ += line.size() + 1;
+
+        const char* cursor = line.c_str();
+        char* next = nullptr;
+        double timestamp = std::strtod(cursor, &next);
+        if (next == cursor) {
+            continue;
+        }
+        cursor = next;
+
+        // Missing trailing values keep the last known value, as in LogFileParser
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            double value = std::strtod(cursor, &next);
+            if (next == cursor) {
+                break;
+            }
+            lastValues_[i] = value;
+            cursor = next;
+        }
+
+        timestamps.push_back(timestamp);
+        values.push_back(lastValues_[columnIndex_]);
+    }
+
+    return timestamps.size();
+}
+
+void LogFileWindowReader::close() {
+    stream_.reset();
+    fields_.clear();
+    fieldIndices_.clear();
+    lastValues_.clear();
+    columnIndex_ = 0;
+    bytesRead_ = 0;
+    fileSize_ = 0;
+}
+
+} // namespace filter
@@ -60,6 +60,14 @@ std::string LowPassFilter::getTypeName() const {
     return "LowPassFilter";
 }
 
+std::shared_ptr<Filter> LowPassFilter::clone() const {
+    return std::make_shared<LowPassFilter>(*this);
+}
+
+void LowPassFilter::reset() {
+    prevOutput_ = 0.0f;
+}
+
 void LowPassFilter::setParameter(const std::string& name, double value) {
     if (name == "cutoffFreq") {
         cutoffFreq_ = static_cast<float>(value);
@@ -0,0 +1,130 @@
+#include "../../include/filter/OrderStatisticFilter.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace filter {
+
+OrderStatisticFilter::OrderStatisticFilter(size_t windowSize, SlidingOrderStatistics::Statistic statistic, double parameter)
+    : window_(windowSize, statistic, parameter) {
+}
+
+double OrderStatisticFilter::processSample(double input) {
+    return window_.push(input);
+}
+
+std::vector<double> OrderStatisticFilter::processBlock(const std::vector<double>& input) {
+    // Window state carries over, so consecutive blocks match one long block
+    std::vector<double> output(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        output[i] = window_.push(input[i]);
+    }
+    return output;
+}
+
+std::vector<double> OrderStatisticFilter::getNumeratorCoefficients() const {
+    return {};
+}
+
+std::vector<double> OrderStatisticFilter::getDenominatorCoefficients() const {
+    return {};
+}
+
+std::vector<std::complex<double>> OrderStatisticFilter::getPoles() const {
+    return {};
+}
+
+std::vector<std::complex<double>> OrderStatisticFilter::getZeros() const {
+    return {};
+}
+
+std::vector<std::complex<double>> OrderStatisticFilter::getFrequencyResponse(const std::vector<double>& frequencies) const {
+    return {};
+}
+
+void OrderStatisticFilter::setParameter(const std::string& name, double value) {
+    if (name == "windowSize") {
+        window_.setWindowSize(value >= 1.0 ? static_cast<size_t>(value) : 1);
+    } else {
+        throw std::invalid_argument("Unknown parameter: " + name);
+    }
+}
+
+double OrderStatisticFilter::getParameter(const std::string& name) const {
+    if (name == "windowSize") {
+        return static_cast<double>(window_.getWindowSize());
+    } else {
+        throw std::invalid_argument("Unknown parameter: " + name);
+    }
+}
+
+std::complex<double> OrderStatisticFilter::evaluateTransferFunction(const std::complex<double>& z) const {
+    return 1.0;  // Not a linear filter
+}
+
+MedianFilter::MedianFilter(size_t windowSize)
+    : OrderStatisticFilter(windowSize, SlidingOrderStatistics::Statistic::Quantile, 0.5) {
+}
+
+std::string MedianFilter::getTypeName() const {
+    return "MedianFilter";
+}
+
+std::shared_ptr<Filter> MedianFilter::clone() const {
+    return std::make_shared<MedianFilter>(*this);
+}
+
+PercentileFilter::PercentileFilter(size_t windowSize, double percentile)
+    : OrderStatisticFilter(windowSize, SlidingOrderStatistics::Statistic::Quantile, percentile / 100.0) {
+}
+
+std::string PercentileFilter::getTypeName() const {
+    return "PercentileFilter";
+}
+
+std::shared_ptr<Filter> PercentileFilter::clone() const {
+    return std::make_shared<PercentileFilter>(*this);
+}
+
+void PercentileFilter::setParameter(const std::string& name, double value) {
+    if (name == "percentile") {
+        window_.setParameter(value / 100.0);
+    } else {
+        OrderStatisticFilter::setParameter(name, value);
+    }
+}
+
+double PercentileFilter::getParameter(const std::string& name) const {
+    if (name == "percentile") {
+        return window_.getParameter() * 100.0;
+    }
+    return OrderStatisticFilter::getParameter(name);
+}
+
+TrimmedMeanFilter::TrimmedMeanFilter(size_t windowSize, double trimFraction)
+    : OrderStatisticFilter(windowSize, SlidingOrderStatistics::Statistic::TrimmedMean, trimFraction) {
+}
+
+std::string TrimmedMeanFilter::getTypeName() const {
+    return "TrimmedMeanFilter";
+}
+
+std::shared_ptr<Filter> TrimmedMeanFilter::clone() const {
+    return std::make_shared<TrimmedMeanFilter>(*this);
+}
+
+void TrimmedMeanFilter::setParameter(const std::string& name, double value) {
+    if (name == "trimFraction") {
+        window_.setParameter(value);
+    } else {
+        OrderStatisticFilter::setParameter(name, value);
+    }
+}
+
+double TrimmedMeanFilter::getParameter(const std::string& name) const {
+    if (name == "trimFraction") {
+        return window_.getParameter();
+    }
+    return OrderStatisticFilter::getParameter(name);
+}
+
+} // namespace filter
@@ -0,0 +1,128 @@
+#include "../../include/filter/OutputSink.hpp"
+#include "../../include/data/WpiLogFormat.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace filter {
+
+namespace {
+    // Longest shortest-round-trip double ("-1.2345678901234567e-308") plus a separator
+    constexpr size_t kMaxNumberSize = 32;
+
+    // Entry ids 1..n; 0 is reserved for control records
+    constexpr uint32_t kFirstEntry = 1;
+
+    char* appendNumber(char* out, double value) {
+        if (std::isnan(value)) {
+            return out;  // Empty CSV field
+        }
+        return std::to_chars(out, out + kMaxNumberSize, value).ptr;
+    }
+}
+
+OutputSink::OutputSink(const std::string& filename, Format format, double sampleRate)
+    : filename_(filename)
+    , format_(format)
+    , sampleRate_(sampleRate > 0.0 ? sampleRate : 1.0) {
+}
+
+OutputSink::~OutputSink() {
+    close();
+}
+
+bool OutputSink::open(const std::vector<std::string>& columnNames) {
+    close();
+    columnCount_ = columnNames.size();
+    nextRow_ = 0;
+    rowsWritten_ = 0;
+
+    if (!writer_.open(filename_)) {
+        return false;
+    }
+
+    if (format_ == Format::Csv) {
+        std::string header = "time";
+        for (const auto& name : columnNames) {
+            header += ',';
+            header += name;
+        }
+        header += '\n';
+        return writer_.write(header.data(), header.size());
+    }
+
+    const std::string fileHeader = data::wpilog::encodeFileHeader();
+    writer_.write(fileHeader.data(), fileHeader.size());
+    for (size_t i = 0; i < columnNames.size(); ++i) {
+        data::wpilog::StartRecord record;
+        record.entry = kFirstEntry + static_cast<uint32_t>(i);
+        record.name = columnNames[i];
+        record.type = "double";
+        const std::string encoded = data::wpilog::encodeStartRecord(record, 0);
+        writer_.write(encoded.data(), encoded.size());
+    }
+    return !writer_.hasFailed();
+}
+
+bool OutputSink::write(const std::vector<const double*>& columns, size_t rows) {
+    if (!writer_.isOpen() || columns.size() != columnCount_) {
+        return false;
+    }
+
+    const bool written = format_ == Format::Csv ? writeCsv(columns, rows) : writeWpiLog(columns, rows);
+    nextRow_ += rows;
+    if (written) {
+        rowsWritten_ += rows;
+    }
+    return written;
+}
+
+bool OutputSink::writeCsv(const std::vector<const double*>& columns, size_t rows) {
+    const size_t maxRowSize = (columns.size() + 1) * kMaxNumberSize + 1;
+    if (maxRowSize > writer_.getBufferSize()) {
+        return false;
+    }
+
+    // Format straight into the writer's buffer; no per-row strings
+    for (size_t row = 0; row < rows; ++row) {
+        char* begin = writer_.reserve(maxRowSize);
+        if (!begin) {
+            return false;
+        }
+        char* out = appendNumber(begin, static_cast<double>(nextRow_ + row) / sampleRate_);
+        for (const double* column : columns) {
+            *out++ = ',';
+            out = appendNumber(out, column[row]);
+        }
+        *out++ = '\n';
+        writer_.commit(static_cast<size_t>(out - begin));
+    }
+    return true;
+}
+
+bool OutputSink::writeWpiLog(const std::vector<const double*>& columns, size_t rows) {
+    constexpr size_t kMaxRecordSize = data::wpilog::kMaxRecordHeaderSize + sizeof(double);
+    const size_t maxRowSize = columns.size() * kMaxRecordSize;
+    if (maxRowSize > writer_.getBufferSize()) {
+        return false;
+    }
+
+    for (size_t row = 0; row < rows; ++row) {
+        char* begin = writer_.reserve(maxRowSize);
+        if (!begin) {
+            return false;
+        }
+        const auto timestamp = static_cast<int64_t>(std::llround((nextRow_ + row) * 1e6 / sampleRate_));
+        auto* out = reinterpret_cast<uint8_t*>(begin);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            out += data::wpilog::encodeDoubleRecord(out, kFirstEntry + static_cast<uint32_t>(i), timestamp, columns[i][row]);
+        }
+        writer_.commit(static_cast<size_t>(reinterpret_cast<char*>(out) - begin));
+    }
+    return true;
+}
+
+bool OutputSink::close() {
+    return writer_.close();
+}
+
+} // namespace filter
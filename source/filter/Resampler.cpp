@@ -0,0 +1,184 @@
+#include "../../include/filter/Resampler.hpp"
+#include <algorithm>
+
+namespace filter {
+
+Resampler::Resampler(double outputRate, Interpolation method, double maxGapSeconds)
+    : periodUs_(1e6 / outputRate), method_(method) {
+    setMaxGap(maxGapSeconds);
+}
+
+void Resampler::setOutputRate(double outputRate) {
+    if (outputRate <= 0.0) {
+        return;
+    }
+    // Keep the grid continuous: restart it at the next grid point of the old rate
+    if (!times_.empty()) {
+        gridOriginUs_ += static_cast<int64_t>(gridIndex_ * periodUs_);
+        gridIndex_ = 0;
+    }
+    periodUs_ = 1e6 / outputRate;
+}
+
+void Resampler::setMaxGap(double seconds) {
+    maxGapUs_ = seconds > 0.0 ? static_cast<int64_t>(seconds * 1e6) : 0;
+}
+
+void Resampler::reset() {
+    times_.clear();
+    values_.clear();
+    cursor_ = 0;
+    gridOriginUs_ = 0;
+    gridIndex_ = 0;
+    gaps_.clear();
+    droppedSamples_ = 0;
+    outputCount_ = 0;
+}
+
+size_t Resampler::process(const int64_t* timestampsUs, const double* values, size_t count, std::vector<double>& output) {
+    size_t added = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t timestamp = timestampsUs[i];
+        if (times_.empty()) {
+            gridOriginUs_ = timestamp;
+            gridIndex_ = 0;
+        } else if (timestamp <= times_.back()) {
+            ++droppedSamples_;
+            continue;
+        } else if (maxGapUs_ > 0 && timestamp - times_.back() > maxGapUs_) {
+            // Finish the segment before the gap and start a fresh grid after it
+            added += emit(output, true);
+            gaps_.push_back({times_.back(), timestamp, outputCount_});
+            times_.clear();
+            values_.clear();
+            cursor_ = 0;
+            gridOriginUs_ = timestamp;
+            gridIndex_ = 0;
+        }
+        times_.push_back(timestamp);
+        values_.push_back(values[i]);
+    }
+    return added + emit(output, false);
+}
+
+size_t Resampler::flush(std::vector<double>& output) {
+    return emit(output, true);
+}
+
+std::vector<double> Resampler::resample(const std::vector<int64_t>& timestampsUs, const std::vector<double>& values) {
+    reset();
+    std::vector<double> output;
+    const size_t count = std::min(timestampsUs.size(), values.size());
+    output.reserve(static_cast<size_t>((count > 0 ? timestampsUs[count - 1] - timestampsUs[0] : 0) / periodUs_) + 1);
+    // Fed in blocks so the interpolation window stays small and in cache
+    constexpr size_t kBlock = 4096;
+    for (size_t i = 0; i < count; i += kBlock) {
+        process(timestampsUs.data() + i, values.data() + i, std::min(kBlock, count - i), output);
+    }
+    flush(output);
+    return output;
+}
+
+size_t Resampler::emit(std::vector<double>& output, bool final) {
+    const size_t n = times_.size();
+    if (n < 2) {
+        return 0;
+    }
+
+    // Cubic needs one sample past the segment, except at the very end
+    size_t lookahead = 1;
+    if (method_ == Interpolation::Cubic && !final) {
+        if (n < 3) {
+            return 0;
+        }
+        lookahead = 2;
+    }
+    const double lastUs = static_cast<double>(times_[n - lookahead]);
+
+    // Grid points are handled in chunks so the scratch arrays stay in cache
+    constexpr size_t kChunk = 1024;
+    segments_.resize(kChunk);
+    fractions_.resize(kChunk);
+
+    size_t segment = cursor_;
+    size_t emitted = 0;
+    for (;;) {
+        // Pass 1: locate each grid point in the input
+        size_t count = 0;
+        while (count < kChunk) {
+            const double t = static_cast<double>(gridOriginUs_) + static_cast<double>(gridIndex_) * periodUs_;
+            if (t > lastUs) {
+                break;
+            }
+            while (segment + 2 < n && static_cast<double>(times_[segment + 1]) <= t) {
+                ++segment;
+            }
+            const double start = static_cast<double>(times_[segment]);
+            segments_[count] = segment;
+            fractions_[count] = (t - start) / (static_cast<double>(times_[segment + 1]) - start);
+            ++gridIndex_;
+            ++count;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        // Pass 2: branch-free kernels over the located points
+        const size_t base = output.size();
+        output.resize(base + count);
+        double* out = output.data() + base;
+        const double* v = values_.data();
+        const int64_t* ts = times_.data();
+        const size_t* seg = segments_.data();
+        const double* frac = fractions_.data();
+
+        switch (method_) {
+            case Interpolation::ZeroOrderHold:
+                for (size_t k = 0; k < count; ++k) {
+                    out[k] = v[seg[k] + (frac[k] >= 1.0 ? 1 : 0)];
+                }
+                break;
+            case Interpolation::Linear:
+                for (size_t k = 0; k < count; ++k) {
+                    const double p1 = v[seg[k]];
+                    const double p2 = v[seg[k] + 1];
+                    out[k] = p1 + frac[k] * (p2 - p1);
+                }
+                break;
+            case Interpolation::Cubic:
+                // Cubic Hermite with Catmull-Rom tangents scaled by the real sample
+                // spacing, so jittered timestamps do not bend straight lines
+                for (size_t k = 0; k < count; ++k) {
+                    const size_t j = seg[k];
+                    const size_t i0 = j > 0 ? j - 1 : 0;
+                    const size_t i3 = std::min(j + 2, n - 1);
+                    const double t0 = static_cast<double>(ts[i0]);
+                    const double t1 = static_cast<double>(ts[j]);
+                    const double t2 = static_cast<double>(ts[j + 1]);
+                    const double t3 = static_cast<double>(ts[i3]);
+                    const double span = t2 - t1;
+                    const double m1 = (v[j + 1] - v[i0]) / (t2 - t0) * span;
+                    const double m2 = (v[i3] - v[j]) / (t3 - t1) * span;
+                    const double f = frac[k];
+                    const double f2 = f * f;
+                    const double f3 = f2 * f;
+                    out[k] = (2.0 * f3 - 3.0 * f2 + 1.0) * v[j] + (f3 - 2.0 * f2 + f) * m1 +
+                             (3.0 * f2 - 2.0 * f3) * v[j + 1] + (f3 - f2) * m2;
+                }
+                break;
+        }
+        emitted += count;
+    }
+    outputCount_ += emitted;
+
+    // Drop samples no later grid point can need; cubic keeps one before the segment
+    const size_t keepFrom = segment > 0 ? segment - 1 : 0;
+    if (keepFrom > 0) {
+        times_.erase(times_.begin(), times_.begin() + keepFrom);
+        values_.erase(values_.begin(), values_.begin() + keepFrom);
+    }
+    cursor_ = segment - keepFrom;
+    return emitted;
+}
+
+} // namespace filter
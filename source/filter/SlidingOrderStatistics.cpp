@@ -0,0 +1,161 @@
+#include "../../include/filter/SlidingOrderStatistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace filter {
+
+SlidingOrderStatistics::SlidingOrderStatistics(size_t windowSize, Statistic statistic, double parameter)
+    : windowSize_(std::max<size_t>(windowSize, 1))
+    , statistic_(statistic)
+    , parameter_(parameter) {
+}
+
+double SlidingOrderStatistics::push(double sample) {
+    Partition::node_type spare;
+    history_.push_back(sample);
+    if (history_.size() > windowSize_) {
+        const double oldest = history_.front();
+        history_.pop_front();
+        if (!std::isnan(oldest)) {
+            spare = erase(oldest);
+        }
+    }
+    if (!std::isnan(sample)) {
+        insert(sample, std::move(spare));
+    }
+    rebalance();
+    return value();
+}
+
+double SlidingOrderStatistics::value() const {
+    if (selected_.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (statistic_ == Statistic::TrimmedMean) {
+        return selectedSum_ / static_cast<double>(selected_.size());
+    }
+
+    // One selected sample on an exact rank, otherwise the two around it
+    const double low = *selected_.begin();
+    if (selected_.size() == 1) {
+        return low;
+    }
+    const double position = std::clamp(parameter_, 0.0, 1.0) * static_cast<double>(getCount() - 1);
+    const double fraction = position - std::floor(position);
+    return low + fraction * (*selected_.rbegin() - low);
+}
+
+void SlidingOrderStatistics::reset() {
+    history_.clear();
+    below_.clear();
+    selected_.clear();
+    above_.clear();
+    selectedSum_ = 0.0;
+    sinceResum_ = 0;
+}
+
+void SlidingOrderStatistics::setWindowSize(size_t windowSize) {
+    windowSize_ = std::max<size_t>(windowSize, 1);
+    reset();
+}
+
+void SlidingOrderStatistics::setParameter(double parameter) {
+    parameter_ = parameter;
+    reset();
+}
+
+void SlidingOrderStatistics::insert(double sample, Partition::node_type spare) {
+    Partition* target = &selected_;
+    if (!below_.empty() && sample < *below_.rbegin()) {
+        target = &below_;
+    } else if (!above_.empty() && sample > *above_.begin()) {
+        target = &above_;
+    }
+
+    if (spare) {
+        spare.value() = sample;
+        target->insert(std::move(spare));
+    } else {
+        target->insert(sample);
+    }
+    if (target == &selected_) {
+        selectedSum_ += sample;
+    }
+}
+
+SlidingOrderStatistics::Partition::node_type SlidingOrderStatistics::erase(double sample) {
+    // Partitions are ordered, so equal samples are interchangeable across a boundary
+    Partition* source = &selected_;
+    if (!below_.empty() && sample <= *below_.rbegin()) {
+        source = &below_;
+    } else if (!above_.empty() && sample >= *above_.begin()) {
+        source = &above_;
+    }
+
+    auto it = source->find(sample);
+    if (it == source->end()) {
+        return Partition::node_type();
+    }
+    if (source == &selected_) {
+        selectedSum_ -= sample;
+    }
+    return source->extract(it);
+}
+
+void SlidingOrderStatistics::moveNode(Partition& from, Partition::iterator it, Partition& to) {
+    const double sample = *it;
+    if (&from == &selected_) {
+        selectedSum_ -= sample;
+    }
+    if (&to == &selected_) {
+        selectedSum_ += sample;
+    }
+    to.insert(from.extract(it));
+}
+
+void SlidingOrderStatistics::rebalance() {
+    const size_t count = getCount();
+    if (count == 0) {
+        selectedSum_ = 0.0;
+        return;
+    }
+
+    // Target sizes of the tails
+    size_t belowCount;
+    size_t aboveCount;
+    if (statistic_ == Statistic::TrimmedMean) {
+        const double trim = std::clamp(parameter_, 0.0, 0.5);
+        belowCount = std::min(static_cast<size_t>(trim * static_cast<double>(count)), (count - 1) / 2);
+        aboveCount = belowCount;
+    } else {
+        const double position = std::clamp(parameter_, 0.0, 1.0) * static_cast<double>(count - 1);
+        belowCount = static_cast<size_t>(std::floor(position));
+        aboveCount = count - 1 - belowCount - (position > std::floor(position) ? 1 : 0);
+    }
+
+    // Shrink oversized tails into the selection, then fill short ones from it.
+    // Elements always move between neighbouring partitions, so order holds.
+    while (below_.size() > belowCount) {
+        moveNode(below_, std::prev(below_.end()), selected_);
+    }
+    while (above_.size() > aboveCount) {
+        moveNode(above_, above_.begin(), selected_);
+    }
+    while (below_.size() < belowCount) {
+        moveNode(selected_, selected_.begin(), below_);
+    }
+    while (above_.size() < aboveCount) {
+        moveNode(selected_, std::prev(selected_.end()), above_);
+    }
+
+    // Adding and removing samples drifts the running sum; recompute it once per window
+    if (statistic_ == Statistic::TrimmedMean && ++sinceResum_ >= windowSize_) {
+        selectedSum_ = std::accumulate(selected_.begin(), selected_.end(), 0.0);
+        sinceResum_ = 0;
+    }
+}
+
+} // namespace filter
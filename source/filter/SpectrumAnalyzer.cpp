@@ -0,0 +1,233 @@
+#include "../../include/filter/SpectrumAnalyzer.hpp"
+#include "../../include/data/ParallelFor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace filter {
+
+namespace {
+    // Fewer segments than this per thread are not worth a thread
+    constexpr size_t kMinSegmentsPerThread = 8;
+
+    // Floor for the dB conversion, well below any real noise floor
+    constexpr double kMinPower = 1e-30;
+}
+
+size_t SpectrumOptions::hop() const {
+    const double shared = std::clamp(overlap, 0.0, 0.95);
+    const size_t length = std::max<size_t>(4, nextPowerOfTwo(segmentLength));
+    return std::max<size_t>(1, static_cast<size_t>(std::round(static_cast<double>(length) * (1.0 - shared))));
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(const SpectrumOptions& options)
+    : options_(options)
+    , plan_(RealFft::plan(options.segmentLength)) {
+    options_.segmentLength = plan_->size();
+    options_.maxColumns = std::max<size_t>(1, options_.maxColumns);
+    if (!(options_.sampleRate > 0.0)) {
+        options_.sampleRate = 1.0;
+    }
+    window_ = makeWindow(options_.window, plan_->size());
+
+    // Density scaling, so the PSD does not depend on the window or segment length
+    double windowPower = 0.0;
+    for (double w : *window_) {
+        windowPower += w * w;
+    }
+    scale_ = 1.0 / (options_.sampleRate * windowPower);
+
+    psdSum_.assign(plan_->bins(), 0.0);
+    columns_.assign(options_.maxColumns * plan_->bins(), 0.0);
+}
+
+bool SpectrumAnalyzer::periodogram(const double* segment, std::vector<std::complex<double>>& spectrum,
+                                   std::vector<double>& windowed, double* out) const {
+    const size_t length = plan_->size();
+    double mean = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        mean += segment[i];
+    }
+    if (std::isnan(mean)) {
+        return false;
+    }
+    mean /= static_cast<double>(length);
+
+    const std::vector<double>& window = *window_;
+    for (size_t i = 0; i < length; ++i) {
+        windowed[i] = (segment[i] - mean) * window[i];
+    }
+    plan_->forward(windowed.data(), spectrum.data());
+
+    // One-sided: every bin but DC and Nyquist stands for two
+    const size_t bins = plan_->bins();
+    for (size_t k = 0; k < bins; ++k) {
+        const double factor = (k == 0 || k == bins - 1) ? scale_ : 2.0 * scale_;
+        out[k] = std::norm(spectrum[k]) * factor;
+    }
+    return true;
+}
+
+void SpectrumAnalyzer::append(const double* data, size_t count) {
+    pending_.insert(pending_.end(), data, data + count);
+
+    const size_t length = plan_->size();
+    const size_t hop = options_.hop();
+    if (pending_.size() < length) {
+        return;
+    }
+
+    // Only the newest maxColumns segments are kept as columns; the rest
+    // only feed the average
+    const size_t bins = plan_->bins();
+    const size_t segments = (pending_.size() - length) / hop + 1;
+    const size_t firstColumn = segments - std::min(segments, options_.maxColumns);
+    std::vector<double> newColumns((segments - firstColumn) * bins);
+    std::vector<char> columnValid(segments - firstColumn, 0);
+
+    struct Partial {
+        std::vector<double> sum;
+        uint64_t count = 0;
+    };
+    const size_t threadCount = std::clamp<size_t>(segments / kMinSegmentsPerThread, 1,
+                                                  data::workerThreadCount(options_.threadCount));
+    std::vector<Partial> partials(threadCount);
+
+    // Each thread takes a contiguous run of segments and sums into its own buffer
+    data::parallelFor(threadCount, threadCount, [&](size_t thread, size_t) {
+        const size_t begin = segments * thread / threadCount;
+        const size_t end = segments * (thread + 1) / threadCount;
+        Partial& partial = partials[thread];
+        partial.sum.assign(bins, 0.0);
+        std::vector<std::complex<double>> spectrum(bins);
+        std::vector<double> windowed(length);
+        std::vector<double> power(bins);
+        for (size_t segment = begin; segment < end; ++segment) {
+            double* out = segment >= firstColumn ? &newColumns[(segment - firstColumn) * bins] : power.data();
+            if (!periodogram(&pending_[segment * hop], spectrum, windowed, out)) {
+                continue;
+            }
+            for (size_t k = 0; k < bins; ++k) {
+                partial.sum[k] += out[k];
+            }
+            ++partial.count;
+            if (segment >= firstColumn) {
+                columnValid[segment - firstColumn] = 1;
+                for (size_t k = 0; k < bins; ++k) {
+                    out[k] = 10.0 * std::log10(std::max(out[k], kMinPower));
+                }
+            }
+        }
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& partial : partials) {
+            for (size_t k = 0; k < bins; ++k) {
+                psdSum_[k] += partial.sum[k];
+            }
+            psdSegments_ += partial.count;
+        }
+        for (size_t column = 0; column < columnValid.size(); ++column) {
+            double* target = &columns_[nextColumn_ * bins];
+            if (columnValid[column]) {
+                std::copy_n(&newColumns[column * bins], bins, target);
+            } else {
+                std::fill_n(target, bins, std::numeric_limits<double>::quiet_NaN());
+            }
+            nextColumn_ = (nextColumn_ + 1) % options_.maxColumns;
+        }
+        columnCount_ = std::min(options_.maxColumns, columnCount_ + columnValid.size());
+        lastColumnStart_ = consumed_ + (segments - 1) * hop;
+        segments_ += segments;
+        ++revision_;
+    }
+
+    // Keep the samples the next segment still needs
+    const size_t used = segments * hop;
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(std::min(used, pending_.size())));
+    consumed_ += used;
+}
+
+void SpectrumAnalyzer::reset() {
+    pending_.clear();
+    consumed_ = 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(psdSum_.begin(), psdSum_.end(), 0.0);
+    psdSegments_ = 0;
+    columnCount_ = 0;
+    nextColumn_ = 0;
+    lastColumnStart_ = 0;
+    segments_ = 0;
+    ++revision_;
+}
+
+bool SpectrumAnalyzer::getPsd(std::vector<double>& frequencies, std::vector<double>& power) const {
+    const size_t bins = plan_->bins();
+    frequencies.resize(bins);
+    const double resolution = options_.sampleRate / static_cast<double>(plan_->size());
+    for (size_t k = 0; k < bins; ++k) {
+        frequencies[k] = static_cast<double>(k) * resolution;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (psdSegments_ == 0) {
+        power.clear();
+        return false;
+    }
+    power.resize(bins);
+    const double norm = 1.0 / static_cast<double>(psdSegments_);
+    for (size_t k = 0; k < bins; ++k) {
+        power[k] = psdSum_[k] * norm;
+    }
+    return true;
+}
+
+size_t SpectrumAnalyzer::getSpectrogram(std::vector<double>& image, double& startTime, double& endTime) const {
+    const size_t bins = plan_->bins();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = columnCount_;
+    image.resize(count * bins);
+    if (count == 0) {
+        startTime = endTime = 0.0;
+        return 0;
+    }
+
+    // Columns are stored one after another; the image wants rows of bins
+    const size_t oldest = (nextColumn_ + options_.maxColumns - count) % options_.maxColumns;
+    double minimum = std::numeric_limits<double>::infinity();
+    for (size_t column = 0; column < count; ++column) {
+        const double* source = &columns_[((oldest + column) % options_.maxColumns) * bins];
+        for (size_t k = 0; k < bins; ++k) {
+            image[(bins - 1 - k) * count + column] = source[k];
+            minimum = std::min(minimum, source[k]);  // NaN never compares less
+        }
+    }
+    if (!std::isfinite(minimum)) {
+        minimum = 10.0 * std::log10(kMinPower);
+    }
+    for (double& value : image) {
+        if (std::isnan(value)) {
+            value = minimum;
+        }
+    }
+
+    const double hop = static_cast<double>(options_.hop());
+    const double firstStart = static_cast<double>(lastColumnStart_) - static_cast<double>(count - 1) * hop;
+    startTime = firstStart / options_.sampleRate;
+    endTime = (static_cast<double>(lastColumnStart_) + static_cast<double>(plan_->size())) / options_.sampleRate;
+    return count;
+}
+
+uint64_t SpectrumAnalyzer::getRevision() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return revision_;
+}
+
+uint64_t SpectrumAnalyzer::getSegmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_;
+}
+
+} // namespace filter
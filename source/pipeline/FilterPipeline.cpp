@@ -1,6 +1,9 @@
 #include "../../include/pipeline/FilterPipeline.hpp"
 #include "../../include/filter/Filter.hpp"
 #include "../../include/filter/InputNodes.hpp"
+#include "../../include/filter/OrderStatisticFilter.hpp"
+#include "../../include/filter/KalmanFilter.hpp"
+#include "../../include/data/ParallelFor.hpp"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -9,15 +12,57 @@
 
 namespace pipeline {
 
+namespace {
+    double parameterOr(const std::map<std::string, double>& params, const std::string& name, double fallback) {
+        auto it = params.find(name);
+        return it != params.end() ? it->second : fallback;
+    }
+
+    // Filters the pipeline runs itself; other types pass their input through
+    std::shared_ptr<filter::Filter> createFilter(const std::string& type, const std::map<std::string, double>& params) {
+        const auto windowSize = static_cast<size_t>(std::max(1.0, parameterOr(params, "windowSize", 5.0)));
+        if (type == "Median") {
+            return std::make_shared<filter::MedianFilter>(windowSize);
+        }
+        if (type == "Percentile") {
+            return std::make_shared<filter::PercentileFilter>(windowSize, parameterOr(params, "percentile", 50.0));
+        }
+        if (type == "TrimmedMean") {
+            return std::make_shared<filter::TrimmedMeanFilter>(windowSize, parameterOr(params, "trimFraction", 0.25));
+        }
+        if (type == "Kalman") {
+            filter::KinematicSettings settings;
+            settings.sampleRate = parameterOr(params, "sampleRate", settings.sampleRate);
+            settings.processNoise = parameterOr(params, "processNoise", settings.processNoise);
+            settings.measurementNoise = parameterOr(params, "measurementNoise", settings.measurementNoise);
+            settings.steadyState = parameterOr(params, "steadyState", 1.0) != 0.0;
+            settings.output = static_cast<int>(parameterOr(params, "output", 0.0));
+            const auto model = static_cast<filter::KinematicModel>(static_cast<int>(parameterOr(params, "model", 0.0)));
+            return filter::makeKinematicKalmanFilter(model, settings);
+        }
+        return nullptr;
+    }
+}
+
 std::string FilterPipeline::addNode(const std::string& type, const std::map<std::string, double>& params) {
     PipelineNode node;
     node.id = "node_" + std::to_string(nodes_.size());
     node.type = type;
     node.parameters = params;
+    node.filter = createFilter(type, params);
     nodes_.push_back(node);
     return node.id;
 }
 
+void FilterPipeline::addNode(const std::string& nodeId, const std::string& type, const std::map<std::string, double>& params) {
+    PipelineNode node;
+    node.id = nodeId;
+    node.type = type;
+    node.parameters = params;
+    node.filter = createFilter(type, params);
+    nodes_.push_back(node);
+}
+
 void FilterPipeline::removeNode(const std::string& nodeId) {
     // Remove the node
     nodes_.erase(
@@ -92,8 +137,12 @@ std::map<std::string, double> FilterPipeline::getNodeParameters(const std::strin
 void FilterPipeline::setNodeParameters(const std::string& nodeId, const std::map<std::string, double>& params) {
     auto it = std::find_if(nodes_.begin(), nodes_.end(),
         [&](const PipelineNode& node) { return node.id == nodeId; });
-    if (it != nodes_.end()) {
+    if (it != nodes_.end() && it->parameters != params) {
         it->parameters = params;
+        // Start the filter over; unchanged parameters keep its state
+        if (it->filter) {
+            it->filter = createFilter(it->type, params);
+        }
     }
 }
 
@@ -112,6 +161,10 @@ std::shared_ptr<filter::InputNode> FilterPipeline::getInputNode(const std::strin
 }
 
 std::vector<double> FilterPipeline::processData(const std::vector<double>& input) {
+    return processColumns(filter::ColumnBuffer(input)).values();
+}
+
+filter::ColumnBuffer FilterPipeline::processColumns(const filter::ColumnBuffer& input) {
     if (nodes_.empty()) {
         return input;
     }
@@ -128,8 +181,16 @@ std::vector<double> FilterPipeline::processData(const std::vector<double>& input
         return input;
     }
 
+    // A batch run covers the whole signal, so every filter starts over;
+    // only streamed blocks carry state from one call to the next
+    for (auto& node : nodes_) {
+        if (node.filter) {
+            node.filter->reset();
+        }
+    }
+
     // Process data through each input node
-    std::vector<double> output = input;
+    filter::ColumnBuffer output = input;
     for (const auto& inputNodeId : inputNodes) {
         // Find the input node
         auto inputNodeIt = std::find_if(nodes_.begin(), nodes_.end(),
@@ -139,56 +200,151 @@ std::vector<double> FilterPipeline::processData(const std::vector<double>& input
             continue;
         }
 
-        // Get input data from input node if available
-        std::vector<double> nodeInput = input;
+        // Get input data from input node if available; the column is shared, not copied
+        filter::ColumnBuffer nodeInput = input;
         if (inputNodeIt->inputNode && inputNodeIt->inputNode->isConnected()) {
-            nodeInput = inputNodeIt->inputNode->getData();
+            nodeInput = inputNodeIt->inputNode->getBuffer();
         }
 
         // Process data through the pipeline starting from this input node
-        std::queue<std::string> nodeQueue;
-        std::unordered_set<std::string> processedNodes;
-        nodeQueue.push(inputNodeId);
+        combineOutputs(output, propagate(inputNodeId, std::move(nodeInput)));
+    }
 
-        while (!nodeQueue.empty()) {
-            std::string currentNodeId = nodeQueue.front();
-            nodeQueue.pop();
+    return output;
+}
 
-            if (processedNodes.find(currentNodeId) != processedNodes.end()) {
-                continue;
-            }
-            processedNodes.insert(currentNodeId);
-
-            // Find the current node
-            auto currentNodeIt = std::find_if(nodes_.begin(), nodes_.end(),
-                [&](const PipelineNode& node) { return node.id == currentNodeId; });
-            
-            if (currentNodeIt == nodes_.end()) {
-                continue;
-            }
+filter::ColumnBuffer FilterPipeline::getNodeOutput(const std::string& nodeId) const {
+    auto it = std::find_if(nodes_.begin(), nodes_.end(),
+        [&](const PipelineNode& node) { return node.id == nodeId; });
+    return it != nodes_.end() ? it->output : filter::ColumnBuffer();
+}
 
-            // Process data through the current node
-            if (currentNodeIt->filter) {
-                nodeInput = currentNodeIt->filter->processBlock(nodeInput);
-            }
+std::vector<double> FilterPipeline::processBlock(const std::string& sourceId, const std::vector<double>& block) {
+    return propagate(sourceId, filter::ColumnBuffer(block)).values();
+}
 
-            // Add output nodes to the queue
-            for (const auto& outputId : currentNodeIt->outputIds) {
-                nodeQueue.push(outputId);
-            }
+std::vector<double> FilterPipeline::processStream(size_t maxBlockSize) {
+    filter::ColumnBuffer output;
+    std::vector<double> block;
+
+    for (const auto& node : nodes_) {
+        if (!node.inputNode) {
+            continue;
         }
 
-        // Combine outputs from different input nodes
-        if (output.size() != nodeInput.size()) {
-            output = nodeInput;
-        } else {
-            for (size_t i = 0; i < output.size(); ++i) {
-                output[i] += nodeInput[i];
-            }
+        block.clear();
+        if (node.inputNode->readBlock(block, maxBlockSize) == 0) {
+            continue;
         }
+
+        combineOutputs(output, propagate(node.id, filter::ColumnBuffer(block)));
     }
 
-    return output;
+    return output.values();
+}
+
+filter::ColumnBuffer FilterPipeline::propagate(const std::string& sourceId, filter::ColumnBuffer data) {
+    for (size_t index : downstreamOrder(sourceId)) {
+        auto& node = nodes_[index];
+
+        // Process data through the current node; pass-through nodes share the buffer
+        if (node.filter) {
+            data = filter::ColumnBuffer(node.filter->processBlock(data.values()));
+        }
+        node.output = data;
+    }
+
+    return data;
+}
+
+std::vector<size_t> FilterPipeline::downstreamOrder(const std::string& sourceId) const {
+    std::vector<size_t> order;
+    std::queue<std::string> nodeQueue;
+    std::unordered_set<std::string> processedNodes;
+    nodeQueue.push(sourceId);
+
+    while (!nodeQueue.empty()) {
+        std::string currentNodeId = nodeQueue.front();
+        nodeQueue.pop();
+
+        if (processedNodes.find(currentNodeId) != processedNodes.end()) {
+            continue;
+        }
+        processedNodes.insert(currentNodeId);
+
+        // Find the current node
+        auto currentNodeIt = std::find_if(nodes_.begin(), nodes_.end(),
+            [&](const PipelineNode& node) { return node.id == currentNodeId; });
+        
+        if (currentNodeIt == nodes_.end()) {
+            continue;
+        }
+        order.push_back(static_cast<size_t>(currentNodeIt - nodes_.begin()));
+
+        // Add output nodes to the queue
+        for (const auto& outputId : currentNodeIt->outputIds) {
+            nodeQueue.push(outputId);
+        }
+    }
+
+    return order;
+}
+
+FilterPipeline FilterPipeline::detachedCopy() const {
+    FilterPipeline copy;
+    copy.nodes_ = nodes_;
+    for (auto& node : copy.nodes_) {
+        if (node.filter) {
+            node.filter = node.filter->clone();
+            node.filter->reset();
+        }
+        node.inputNode.reset();
+        node.output = filter::ColumnBuffer();
+    }
+    return copy;
+}
+
+std::vector<FilterPipeline::ChannelOutput> FilterPipeline::processChannels(const std::string& sourceId) const {
+    auto sourceIt = std::find_if(nodes_.begin(), nodes_.end(),
+        [&](const PipelineNode& node) { return node.id == sourceId; });
+    if (sourceIt == nodes_.end() || !sourceIt->inputNode) {
+        return {};
+    }
+
+    const std::vector<filter::InputChannel> channels = sourceIt->inputNode->getChannels();
+    const std::vector<size_t> order = downstreamOrder(sourceId);
+    std::vector<ChannelOutput> outputs(channels.size());
+
+    // Each channel gets its own reset copy of the chain's filters, so channels
+    // share no state and none inherit what the node's filter last processed
+    auto runChannel = [&](size_t channel) {
+        filter::ColumnBuffer data = channels[channel].data;
+        for (size_t index : order) {
+            if (const auto& nodeFilter = nodes_[index].filter) {
+                const auto channelFilter = nodeFilter->clone();
+                channelFilter->reset();
+                data = filter::ColumnBuffer(channelFilter->processBlock(data.values()));
+            }
+        }
+        outputs[channel] = {channels[channel].name, std::move(data)};
+    };
+
+    // Channels can differ a lot in length, so threads take them one at a time
+    data::parallelFor(channels.size(), data::workerThreadCount(), [&](size_t channel, size_t) { runChannel(channel); });
+    return outputs;
+}
+
+void FilterPipeline::combineOutputs(filter::ColumnBuffer& output, const filter::ColumnBuffer& nodeOutput) {
+    // Combine outputs from different input nodes
+    if (output.size() != nodeOutput.size()) {
+        output = nodeOutput;
+    } else {
+        // Detaches from nodeOutput first if both share one allocation
+        auto& values = output.mutableValues();
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] += nodeOutput[i];
+        }
+    }
 }
 
 std::vector<double> FilterPipeline::getLinearFilterCoefficients() const {
@@ -0,0 +1,345 @@
+#include "../../include/pipeline/ParameterSweep.hpp"
+#include "../../include/data/ParallelFor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace pipeline {
+
+namespace {
+    // Vertex of the parabola through three neighbouring samples, relative to the middle one
+    double parabolicOffset(double left, double middle, double right) {
+        const double denominator = left - 2.0 * middle + right;
+        if (denominator == 0.0) {
+            return 0.0;
+        }
+        return std::clamp(0.5 * (left - right) / denominator, -0.5, 0.5);
+    }
+
+    void removeMean(double* values, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        const double mean = std::accumulate(values, values + count, 0.0) / static_cast<double>(count);
+        for (size_t i = 0; i < count; ++i) {
+            values[i] -= mean;
+        }
+    }
+
+    // Peak of the cross-correlation of x and y over lags -1..maxLag, in samples.
+    // Low-pass filters only delay, so the negative lag is there for interpolation.
+    double estimateLag(const double* x, const double* y, size_t length, size_t maxLag, std::vector<double>& correlation) {
+        maxLag = std::min(maxLag, length > 1 ? length - 1 : 0);
+        correlation.assign(maxLag + 2, 0.0);
+
+        // Slot 0 is lag -1
+        double sum = 0.0;
+        for (size_t i = 0; i + 1 < length; ++i) {
+            sum += x[i + 1] * y[i];
+        }
+        correlation[0] = length > 1 ? sum / static_cast<double>(length - 1) : 0.0;
+
+        // Four lags per pass share the x loads and give four independent sums
+        size_t lag = 0;
+        for (; lag + 3 <= maxLag; lag += 4) {
+            const size_t overlap = length - (lag + 3);
+            double sums[4] = {};
+            for (size_t i = 0; i < overlap; ++i) {
+                const double xi = x[i];
+                sums[0] += xi * y[i + lag];
+                sums[1] += xi * y[i + lag + 1];
+                sums[2] += xi * y[i + lag + 2];
+                sums[3] += xi * y[i + lag + 3];
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                // Products past the common overlap
+                for (size_t i = overlap; i + lag + k < length; ++i) {
+                    sums[k] += x[i] * y[i + lag + k];
+                }
+                correlation[lag + k + 1] = sums[k] / static_cast<double>(length - lag - k);
+            }
+        }
+
+        // Up to three lags left over
+        for (; lag <= maxLag; ++lag) {
+            double lagSum = 0.0;
+            for (size_t i = 0; i + lag < length; ++i) {
+                lagSum += x[i] * y[i + lag];
+            }
+            correlation[lag + 1] = lagSum / static_cast<double>(length - lag);
+        }
+
+        const size_t peak = static_cast<size_t>(std::max_element(correlation.begin() + 1, correlation.end()) - correlation.begin());
+        double peakLag = static_cast<double>(peak) - 1.0;
+        if (peak + 1 < correlation.size()) {
+            peakLag += parabolicOffset(correlation[peak - 1], correlation[peak], correlation[peak + 1]);
+        }
+        return peakLag;
+    }
+}
+
+std::vector<filter::DesignSpec> SweepGrid::specs() const {
+    std::vector<filter::DesignSpec> specs;
+    for (filter::DesignType type : types) {
+        // First-order designs have no order to sweep
+        const std::vector<int> typeOrders = type == filter::DesignType::FirstOrder ? std::vector<int>{1} : orders;
+        for (int order : typeOrders) {
+            for (double cutoff : cutoffs) {
+                specs.push_back({type, order, cutoff, sampleRate, ripple});
+            }
+        }
+    }
+    return specs;
+}
+
+std::vector<double> SweepGrid::logSpace(double minimum, double maximum, size_t count) {
+    std::vector<double> values;
+    if (count == 0 || minimum <= 0.0 || maximum <= 0.0) {
+        return values;
+    }
+    if (count == 1) {
+        return {minimum};
+    }
+    const double step = std::log(maximum / minimum) / static_cast<double>(count - 1);
+    for (size_t i = 0; i < count; ++i) {
+        values.push_back(minimum * std::exp(step * static_cast<double>(i)));
+    }
+    return values;
+}
+
+ParameterSweep::ParameterSweep() = default;
+
+ParameterSweep::~ParameterSweep() {
+    cancel();
+    join();
+}
+
+void ParameterSweep::start(filter::ColumnBuffer signal, const SweepGrid& grid, const SweepOptions& options) {
+    cancel();
+    join();
+
+    cancelled_ = false;
+    running_ = true;
+    thread_ = std::thread([this, signal = std::move(signal), specs = grid.specs(), options]() {
+        auto results = std::make_shared<std::vector<SweepResult>>(run(signal, specs, options));
+        if (!cancelled_) {
+            std::lock_guard<std::mutex> lock(resultsMutex_);
+            results_ = std::move(results);
+        }
+        running_ = false;
+    });
+}
+
+void ParameterSweep::cancel() {
+    cancelled_ = true;
+}
+
+void ParameterSweep::join() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+double ParameterSweep::getProgress() const {
+    const size_t total = total_.load();
+    return total > 0 ? static_cast<double>(completed_.load()) / static_cast<double>(total) : 0.0;
+}
+
+std::shared_ptr<const std::vector<SweepResult>> ParameterSweep::getResults() const {
+    std::lock_guard<std::mutex> lock(resultsMutex_);
+    return results_;
+}
+
+std::vector<SweepResult> ParameterSweep::run(const filter::ColumnBuffer& signal, const std::vector<filter::DesignSpec>& specs,
+                                             const SweepOptions& options) {
+    completed_ = 0;
+    total_ = specs.size();
+    if (specs.empty() || signal.empty()) {
+        return {};
+    }
+
+    // A gap would stick in every IIR state; hold the last valid sample instead
+    std::vector<double> cleaned;
+    const std::vector<double>* samples = &signal.values();
+    if (std::any_of(samples->begin(), samples->end(), [](double value) { return std::isnan(value); })) {
+        cleaned = *samples;
+        double last = 0.0;
+        for (double& value : cleaned) {
+            value = std::isnan(value) ? last : value;
+            last = value;
+        }
+        samples = &cleaned;
+    }
+
+    // The input side of the lag estimate is the same for every design
+    const size_t excerptLength = std::min(options.lagWindow, samples->size());
+    const size_t excerptStart = (samples->size() - excerptLength) / 2;
+    std::vector<double> inputExcerpt(samples->begin() + excerptStart, samples->begin() + excerptStart + excerptLength);
+    removeMean(inputExcerpt.data(), inputExcerpt.size());
+
+    // Group neighbouring designs with the same number of sections; the grid
+    // lists cutoffs innermost, so groups are almost always full
+    std::vector<std::pair<size_t, size_t>> groups;  // First spec, count
+    for (size_t first = 0; first < specs.size();) {
+        const size_t sectionCount = cache_.get(specs[first])->size();
+        size_t count = 1;
+        while (count < kLanes && first + count < specs.size() && cache_.get(specs[first + count])->size() == sectionCount) {
+            ++count;
+        }
+        groups.emplace_back(first, count);
+        first += count;
+    }
+
+    std::vector<SweepResult> results(specs.size());
+    const size_t threadCount = data::workerThreadCount(options.threadCount);
+    std::vector<Scratch> scratch(std::min(threadCount, groups.size()));
+    data::parallelFor(groups.size(), threadCount, [&](size_t index, size_t worker) {
+        if (cancelled_) {
+            return;
+        }
+        const auto [first, count] = groups[index];
+        evaluateGroup(*samples, inputExcerpt, excerptStart, &specs[first], count, options, scratch[worker], &results[first]);
+        completed_ += count;
+    });
+
+    if (cancelled_) {
+        return {};
+    }
+    markParetoFront(results);
+    return results;
+}
+
+void ParameterSweep::evaluateGroup(const std::vector<double>& signal, const std::vector<double>& inputExcerpt, size_t excerptStart,
+                                   const filter::DesignSpec* specs, size_t count, const SweepOptions& options,
+                                   Scratch& scratch, SweepResult* results) {
+    // Lay the sections out lane by lane; unused lanes pass samples through
+    std::shared_ptr<const std::vector<filter::Biquad>> designs[kLanes];
+    for (size_t lane = 0; lane < count; ++lane) {
+        designs[lane] = cache_.get(specs[lane]);
+    }
+    const size_t sectionCount = designs[0]->size();
+    scratch.sections.assign(sectionCount, LaneSection());
+    for (size_t s = 0; s < sectionCount; ++s) {
+        LaneSection& section = scratch.sections[s];
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            const filter::Biquad q = lane < count ? (*designs[lane])[s] : filter::Biquad();
+            section.b0[lane] = q.b0;
+            section.b1[lane] = q.b1;
+            section.b2[lane] = q.b2;
+            section.a1[lane] = q.a1;
+            section.a2[lane] = q.a2;
+        }
+    }
+
+    const size_t blockSize = std::max<size_t>(options.blockSize, 1);
+    const size_t excerptLength = inputExcerpt.size();
+    const size_t excerptEnd = excerptStart + excerptLength;
+    scratch.block.resize(blockSize * kLanes);
+    scratch.excerpts.resize(excerptLength * kLanes);
+
+    // Start every cascade settled on the first sample, as if the signal had
+    // held it forever; from rest, the start-up transient would count against
+    // every design in the residual and noise metrics
+    std::vector<double> z1(sectionCount * kLanes, 0.0);
+    std::vector<double> z2(sectionCount * kLanes, 0.0);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        double x = signal.front();
+        for (size_t s = 0; s < sectionCount && x != 0.0; ++s) {
+            // A section with a pole at DC has no steady state; it and the rest start from rest
+            const LaneSection& q = scratch.sections[s];
+            const double denominator = 1.0 + q.a1[lane] + q.a2[lane];
+            const double y = denominator != 0.0 ? (q.b0[lane] + q.b1[lane] + q.b2[lane]) / denominator * x : 0.0;
+            if (denominator != 0.0) {
+                z2[s * kLanes + lane] = q.b2[lane] * x - q.a2[lane] * y;
+                z1[s * kLanes + lane] = q.b1[lane] * x - q.a1[lane] * y + z2[s * kLanes + lane];
+            }
+            x = y;
+        }
+    }
+    double residualSum[kLanes] = {};
+    double differenceSum[kLanes] = {};
+    double previous[kLanes];
+    std::fill(previous, previous + kLanes, signal.front());
+
+    // Stream the signal through every lane, accumulating the metrics per block
+    for (size_t offset = 0; offset < signal.size(); offset += blockSize) {
+        const size_t blockCount = std::min(blockSize, signal.size() - offset);
+        const double* input = signal.data() + offset;
+        double* output = scratch.block.data();
+
+        for (size_t s = 0; s < sectionCount; ++s) {
+            // Transposed direct form II, all lanes per sample
+            const LaneSection& q = scratch.sections[s];
+            double* state1 = &z1[s * kLanes];
+            double* state2 = &z2[s * kLanes];
+            const double* source = s == 0 ? input : output;
+            const size_t sourceStride = s == 0 ? 1 : kLanes;
+            const size_t laneStride = s == 0 ? 0 : 1;
+            for (size_t i = 0; i < blockCount; ++i) {
+                for (size_t lane = 0; lane < kLanes; ++lane) {
+                    const double x = source[i * sourceStride + lane * laneStride];
+                    const double y = q.b0[lane] * x + state1[lane];
+                    state1[lane] = q.b1[lane] * x - q.a1[lane] * y + state2[lane];
+                    state2[lane] = q.b2[lane] * x - q.a2[lane] * y;
+                    output[i * kLanes + lane] = y;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < blockCount; ++i) {
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                const double y = output[i * kLanes + lane];
+                const double residual = y - input[i];
+                const double difference = y - previous[lane];
+                residualSum[lane] += residual * residual;
+                differenceSum[lane] += difference * difference;
+                previous[lane] = y;
+            }
+        }
+
+        // Keep each lane's output over the lag window
+        const size_t copyBegin = std::max(offset, excerptStart);
+        const size_t copyEnd = std::min(offset + blockCount, excerptEnd);
+        for (size_t index = copyBegin; index < copyEnd; ++index) {
+            for (size_t lane = 0; lane < count; ++lane) {
+                scratch.excerpts[lane * excerptLength + (index - excerptStart)] = output[(index - offset) * kLanes + lane];
+            }
+        }
+    }
+
+    for (size_t lane = 0; lane < count; ++lane) {
+        SweepResult& result = results[lane];
+        result.spec = specs[lane];
+        result.rmsResidual = std::sqrt(residualSum[lane] / static_cast<double>(signal.size()));
+        result.noisePower = differenceSum[lane] / static_cast<double>(signal.size());
+
+        double* excerpt = scratch.excerpts.data() + lane * excerptLength;
+        removeMean(excerpt, excerptLength);
+        result.lagSamples = estimateLag(inputExcerpt.data(), excerpt, excerptLength, options.maxLag, scratch.correlation);
+        result.lagSeconds = result.lagSamples / specs[lane].sampleRate;
+
+        const std::vector<double> step = filter::BiquadCascade(designs[lane]).stepResponse(options.stepLength);
+        const double peak = step.empty() ? 1.0 : *std::max_element(step.begin(), step.end());
+        result.overshoot = std::max(0.0, peak - 1.0) * 100.0;
+    }
+}
+
+void ParameterSweep::markParetoFront(std::vector<SweepResult>& results) {
+    std::vector<size_t> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const double lagA = std::fabs(results[a].lagSamples);
+        const double lagB = std::fabs(results[b].lagSamples);
+        return lagA != lagB ? lagA < lagB : results[a].noisePower < results[b].noisePower;
+    });
+
+    // In order of lag, a design is on the front if it is quieter than every faster one
+    double quietest = std::numeric_limits<double>::infinity();
+    for (size_t index : order) {
+        results[index].pareto = results[index].noisePower < quietest;
+        quietest = std::min(quietest, results[index].noisePower);
+    }
+}
+
+} // namespace pipeline
@@ -0,0 +1,457 @@
+#include "../../include/pipeline/ProcessingWorker.hpp"
+#include "../../include/pipeline/WindowedProcessor.hpp"
+#include "../../include/filter/InputNodes.hpp"
+#include "../../include/filter/OutputSink.hpp"
+#include "../../include/filter/SpectrumAnalyzer.hpp"
+#include "../../include/filter/CrossCorrelation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+namespace pipeline {
+
+namespace {
+    // How often streaming inputs are polled when no edits arrive
+    constexpr auto kStreamPeriod = std::chrono::milliseconds(2);
+    constexpr size_t kStreamBlockQueue = 256;
+
+    // Nearest multi-column source feeding a node, or empty if there is none
+    std::string findChannelSource(const std::vector<FilterPipeline::PipelineNode>& nodes, const std::string& nodeId) {
+        std::vector<std::string> pending{nodeId};
+        std::unordered_set<std::string> visited;
+        while (!pending.empty()) {
+            const std::string id = pending.back();
+            pending.pop_back();
+            if (!visited.insert(id).second) {
+                continue;
+            }
+            for (const auto& node : nodes) {
+                if (node.id != id) {
+                    continue;
+                }
+                if (dynamic_cast<const filter::MultiColumnInput*>(node.inputNode.get())) {
+                    return node.id;
+                }
+                pending.insert(pending.end(), node.inputIds.begin(), node.inputIds.end());
+            }
+        }
+        return std::string();
+    }
+
+    // The node itself, or the first node feeding it
+    std::string analyzedNode(const FilterPipeline& pipeline, const std::string& nodeId, bool nodeInput) {
+        if (!nodeInput) {
+            return nodeId;
+        }
+        for (const auto& node : pipeline.getPipelineNodes()) {
+            if (node.id == nodeId) {
+                return node.inputIds.empty() ? std::string() : node.inputIds.front();
+            }
+        }
+        return std::string();
+    }
+
+    // Plot summary of a node's batch output. Sources hand out the one they
+    // built while loading, and pass-through nodes reuse the one of the column
+    // they share; only new columns are summarized here.
+    std::shared_ptr<data::MinMaxPyramid> outputPyramid(const ProcessingResult& result,
+                                                       const FilterPipeline::PipelineNode& node) {
+        if (node.inputNode) {
+            if (auto pyramid = node.inputNode->getPyramid(node.output)) {
+                return pyramid;
+            }
+        }
+        for (const auto& entry : result.nodePyramids) {
+            if (result.nodeOutputs.at(entry.first).sharesWith(node.output)) {
+                return entry.second;
+            }
+        }
+        auto pyramid = std::make_shared<data::MinMaxPyramid>();
+        pyramid->build(node.output.values());
+        return pyramid;
+    }
+}
+
+ProcessingWorker::ProcessingWorker(size_t queueCapacity)
+    : commands_(queueCapacity)
+    , streamBlocks_(kStreamBlockQueue) {
+    worker_ = std::thread(&ProcessingWorker::workerLoop, this);
+}
+
+ProcessingWorker::~ProcessingWorker() {
+    running_.store(false);
+    wake();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void ProcessingWorker::submit(Command command) {
+    // Never block the owner: edits that do not fit wait on this side, in order
+    flushOverflow();
+    if (!overflow_.empty() || !commands_.tryPush(std::move(command))) {
+        overflow_.push_back(std::move(command));
+    }
+    wake();
+}
+
+void ProcessingWorker::flushOverflow() {
+    while (!overflow_.empty() && commands_.tryPush(std::move(overflow_.front()))) {
+        overflow_.pop_front();
+    }
+}
+
+std::string ProcessingWorker::addNode(const std::string& type, const std::map<std::string, double>& params) {
+    std::string nodeId = "node_" + std::to_string(nextNodeId_++);
+    submit([nodeId, type, params](FilterPipeline& pipeline) {
+        pipeline.addNode(nodeId, type, params);
+    });
+    return nodeId;
+}
+
+void ProcessingWorker::removeNode(const std::string& nodeId) {
+    submit([nodeId](FilterPipeline& pipeline) { pipeline.removeNode(nodeId); });
+}
+
+void ProcessingWorker::connectNodes(const std::string& sourceId, const std::string& targetId) {
+    submit([sourceId, targetId](FilterPipeline& pipeline) { pipeline.connectNodes(sourceId, targetId); });
+}
+
+void ProcessingWorker::disconnectNodes(const std::string& sourceId, const std::string& targetId) {
+    submit([sourceId, targetId](FilterPipeline& pipeline) { pipeline.disconnectNodes(sourceId, targetId); });
+}
+
+void ProcessingWorker::setNodeParameters(const std::string& nodeId, const std::map<std::string, double>& params) {
+    submit([nodeId, params](FilterPipeline& pipeline) { pipeline.setNodeParameters(nodeId, params); });
+}
+
+void ProcessingWorker::setInputNode(const std::string& nodeId, std::shared_ptr<filter::InputNode> inputNode) {
+    submit([nodeId, inputNode](FilterPipeline& pipeline) { pipeline.setInputNode(nodeId, inputNode); });
+}
+
+void ProcessingWorker::setOutputSink(const std::string& nodeId, std::shared_ptr<filter::OutputSink> sink) {
+    submit([this, nodeId, sink](FilterPipeline&) {
+        auto it = sinks_.find(nodeId);
+        if (it != sinks_.end()) {
+            it->second.sink->close();
+            sinks_.erase(it);
+        }
+        if (sink) {
+            sinks_[nodeId].sink = sink;
+        }
+    });
+}
+
+void ProcessingWorker::setRecorder(const std::string& nodeId, std::shared_ptr<data::WpiLogRecorder::Channel> channel) {
+    submit([this, nodeId, channel](FilterPipeline& pipeline) {
+        if (channel) {
+            // Only output produced from now on is live
+            recorders_[nodeId] = {channel, pipeline.getNodeOutput(nodeId)};
+        } else {
+            recorders_.erase(nodeId);
+        }
+    });
+}
+
+void ProcessingWorker::setAnalyzer(const std::string& nodeId, std::shared_ptr<filter::SpectrumAnalyzer> analyzer, bool nodeInput) {
+    submit([this, nodeId, analyzer, nodeInput](FilterPipeline& pipeline) {
+        if (!analyzer) {
+            analyzers_.erase({nodeId, nodeInput});
+            return;
+        }
+
+        // Start from what the node already holds, so no rerun is needed
+        AnalyzerState state{analyzer, analyzedNode(pipeline, nodeId, nodeInput), filter::ColumnBuffer()};
+        if (!state.sourceId.empty()) {
+            state.lastAnalyzed = pipeline.getNodeOutput(state.sourceId);
+            analyzer->append(state.lastAnalyzed.data(), state.lastAnalyzed.size());
+        }
+        analyzers_[{nodeId, nodeInput}] = std::move(state);
+    });
+}
+
+void ProcessingWorker::setCorrelator(std::shared_ptr<filter::CrossCorrelator> correlator,
+                                     const std::string& referenceId, const std::string& signalId) {
+    submit([this, correlator, referenceId, signalId](FilterPipeline&) {
+        if (referenceId.empty() || signalId.empty()) {
+            correlators_.erase(correlator);
+            return;
+        }
+        CorrelatorState& state = correlators_[correlator];
+        state.referenceId = referenceId;
+        state.signalId = signalId;
+        fillCorrelator(*correlator, state);
+    });
+}
+
+void ProcessingWorker::fillCorrelator(filter::CrossCorrelator& correlator, CorrelatorState& state) {
+    // Both outputs from the start; streamed blocks follow on from here
+    state.lastReference = pipeline_.getNodeOutput(state.referenceId);
+    state.lastSignal = pipeline_.getNodeOutput(state.signalId);
+    correlator.reset();
+    correlator.appendReference(state.lastReference.data(), state.lastReference.size());
+    correlator.appendSignal(state.lastSignal.data(), state.lastSignal.size());
+}
+
+void ProcessingWorker::startWindowedRun(std::shared_ptr<WindowedRun> run, const std::string& inputFile,
+                                        const std::string& field, bool wpilog, const std::string& sourceNodeId,
+                                        const std::string& outputFile) {
+    submit([run, inputFile, field, wpilog, sourceNodeId, outputFile](FilterPipeline& pipeline) {
+        run->start(pipeline, inputFile, field, wpilog, sourceNodeId, outputFile);
+    });
+}
+
+void ProcessingWorker::reset() {
+    submit([this](FilterPipeline& pipeline) {
+        pipeline = FilterPipeline();
+        recorders_.clear();
+        analyzers_.clear();
+        correlators_.clear();
+        lastPublished_.clear();
+        for (auto& entry : sinks_) {
+            entry.second.sink->close();
+        }
+        sinks_.clear();
+    });
+}
+
+uint64_t ProcessingWorker::requestProcess() {
+    // The request travels with the edits, so it sees every one submitted before it
+    const uint64_t revision = ++nextRevision_;
+    submit([this, revision](FilterPipeline&) { requestedRevision_ = revision; });
+    return revision;
+}
+
+std::shared_ptr<const ProcessingResult> ProcessingWorker::getLatestResult() {
+    flushOverflow();
+    if (results_.update()) {
+        latestResult_ = results_.front();
+    }
+    return latestResult_;
+}
+
+size_t ProcessingWorker::takeStreamOutput(std::map<std::string, std::vector<double>>& outputs) {
+    size_t added = 0;
+    StreamBlock block;
+    while (streamBlocks_.tryPop(block)) {
+        for (const auto& entry : block) {
+            auto& output = outputs[entry.first];
+            output.insert(output.end(), entry.second.begin(), entry.second.end());
+            added += entry.second.size();
+        }
+    }
+    return added;
+}
+
+void ProcessingWorker::wake() {
+    wakeCondition_.notify_one();
+}
+
+bool ProcessingWorker::applyCommands() {
+    bool applied = false;
+    Command command;
+    while (commands_.tryPop(command)) {
+        command(pipeline_);
+        command = nullptr;  // Release captured state here, not on the next pop
+        applied = true;
+    }
+    return applied;
+}
+
+void ProcessingWorker::runBatch() {
+    auto result = std::make_shared<ProcessingResult>();
+    result->revision = requestedRevision_;
+    result->output = pipeline_.processColumns(filter::ColumnBuffer());
+    lastPublished_.clear();  // The result carries every output; streaming continues from there
+    for (const auto& node : pipeline_.getPipelineNodes()) {
+        auto nodePyramid = outputPyramid(*result, node);
+        result->nodeOutputs[node.id] = node.output;
+        result->nodePyramids[node.id] = std::move(nodePyramid);
+        lastPublished_[node.id] = node.output;
+
+        // Multi-column sources also run each column through its own copy of the chain
+        if (dynamic_cast<const filter::MultiColumnInput*>(node.inputNode.get())) {
+            auto& channels = result->channelOutputs[node.id];
+            for (auto& channel : pipeline_.processChannels(node.id)) {
+                auto pyramid = std::make_shared<data::MinMaxPyramid>();
+                pyramid->build(channel.output.values());
+                channels.push_back({std::move(channel.name), std::move(channel.output), std::move(pyramid)});
+            }
+        }
+    }
+    processedRevision_ = requestedRevision_;
+    writeBatchToSinks(*result);
+
+    // A batch rerun is not live data; recordings continue with the next block
+    for (auto& entry : recorders_) {
+        entry.second.lastRecorded = pipeline_.getNodeOutput(entry.first);
+    }
+
+    // Connections may have changed, so the analyzed node is looked up again
+    for (auto& entry : analyzers_) {
+        AnalyzerState& state = entry.second;
+        state.sourceId = analyzedNode(pipeline_, entry.first.first, entry.first.second);
+        state.lastAnalyzed = state.sourceId.empty() ? filter::ColumnBuffer() : pipeline_.getNodeOutput(state.sourceId);
+        state.analyzer->reset();
+        state.analyzer->append(state.lastAnalyzed.data(), state.lastAnalyzed.size());
+    }
+    for (auto& entry : correlators_) {
+        fillCorrelator(*entry.first, entry.second);
+    }
+
+    results_.back() = std::move(result);
+    results_.publish();
+}
+
+void ProcessingWorker::writeBatchToSinks(const ProcessingResult& result) {
+    if (sinks_.empty()) {
+        return;
+    }
+
+    const auto nodes = pipeline_.getPipelineNodes();
+    for (auto& entry : sinks_) {
+        SinkState& state = entry.second;
+        if (state.opened) {
+            // Only the first run after Write goes to the file; a rerun would
+            // throw away the rows streamed since. Streaming continues from
+            // the rerun's output rather than appending it again.
+            if (!state.channels) {
+                auto output = result.nodeOutputs.find(entry.first);
+                state.lastWritten = output != result.nodeOutputs.end() ? output->second : filter::ColumnBuffer();
+            }
+            continue;
+        }
+
+        std::vector<std::string> names;
+        std::vector<const double*> columns;
+        size_t rows = 0;
+
+        // A sink behind a multi-column source gets one column per channel
+        const std::string sourceId = findChannelSource(nodes, entry.first);
+        auto channels = result.channelOutputs.find(sourceId);
+        state.channels = channels != result.channelOutputs.end() && !channels->second.empty();
+        if (state.channels) {
+            rows = channels->second.front().output.size();
+            for (const auto& channel : channels->second) {
+                rows = std::min(rows, channel.output.size());
+            }
+            for (const auto& channel : channels->second) {
+                names.push_back(channel.name);
+                columns.push_back(channel.output.data());
+            }
+        } else {
+            auto output = result.nodeOutputs.find(entry.first);
+            state.lastWritten = output != result.nodeOutputs.end() ? output->second : filter::ColumnBuffer();
+            rows = state.lastWritten.size();
+            names.push_back(entry.first);
+            columns.push_back(state.lastWritten.data());
+        }
+
+        state.opened = true;
+        if (state.sink->open(names)) {
+            state.sink->write(columns, rows);
+        }
+    }
+}
+
+void ProcessingWorker::writeStreamToSinks() {
+    for (auto& entry : sinks_) {
+        SinkState& state = entry.second;
+        if (state.channels || !state.sink->isOpen()) {
+            continue;
+        }
+
+        // Streaming replaces the node output with each new block
+        filter::ColumnBuffer output = pipeline_.getNodeOutput(entry.first);
+        if (output.empty() || output.sharesWith(state.lastWritten)) {
+            continue;
+        }
+        state.sink->write({output.data()}, output.size());
+        state.lastWritten = std::move(output);
+    }
+}
+
+void ProcessingWorker::recordStream() {
+    for (auto& entry : recorders_) {
+        RecorderState& state = entry.second;
+        filter::ColumnBuffer output = pipeline_.getNodeOutput(entry.first);
+        if (output.empty() || output.sharesWith(state.lastRecorded)) {
+            continue;
+        }
+        state.channel->recordBlock(output.data(), output.size());
+        state.lastRecorded = std::move(output);
+    }
+}
+
+void ProcessingWorker::analyzeStream() {
+    for (auto& entry : analyzers_) {
+        AnalyzerState& state = entry.second;
+        if (state.sourceId.empty()) {
+            continue;
+        }
+        filter::ColumnBuffer output = pipeline_.getNodeOutput(state.sourceId);
+        if (output.empty() || output.sharesWith(state.lastAnalyzed)) {
+            continue;
+        }
+        state.analyzer->append(output.data(), output.size());
+        state.lastAnalyzed = std::move(output);
+    }
+}
+
+void ProcessingWorker::correlateStream() {
+    // The two sides may stream at different times; the correlator lines them up
+    for (auto& entry : correlators_) {
+        CorrelatorState& state = entry.second;
+        filter::ColumnBuffer reference = pipeline_.getNodeOutput(state.referenceId);
+        if (!reference.empty() && !reference.sharesWith(state.lastReference)) {
+            entry.first->appendReference(reference.data(), reference.size());
+            state.lastReference = std::move(reference);
+        }
+        filter::ColumnBuffer signal = pipeline_.getNodeOutput(state.signalId);
+        if (!signal.empty() && !signal.sharesWith(state.lastSignal)) {
+            entry.first->appendSignal(signal.data(), signal.size());
+            state.lastSignal = std::move(signal);
+        }
+    }
+}
+
+void ProcessingWorker::publishStream() {
+    StreamBlock block;
+    for (const auto& node : pipeline_.getPipelineNodes()) {
+        filter::ColumnBuffer& published = lastPublished_[node.id];
+        if (node.output.empty() || node.output.sharesWith(published)) {
+            continue;
+        }
+        block[node.id] = node.output;
+        published = node.output;
+    }
+    if (!block.empty() && !streamBlocks_.tryPush(std::move(block))) {
+        droppedBlocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ProcessingWorker::workerLoop() {
+    while (running_.load()) {
+        applyCommands();
+        if (requestedRevision_ != processedRevision_) {
+            runBatch();
+            continue;  // Pick up edits that arrived during the run first
+        }
+
+        std::vector<double> block = pipeline_.processStream();
+        if (!block.empty()) {
+            writeStreamToSinks();
+            recordStream();
+            analyzeStream();
+            correlateStream();
+            publishStream();
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCondition_.wait_for(lock, kStreamPeriod, [this] {
+            return !running_.load() || !commands_.empty();
+        });
+    }
+}
+
+} // namespace pipeline
@@ -0,0 +1,152 @@
+#include "../../include/pipeline/WindowedProcessor.hpp"
+#include "../../include/pipeline/FilterPipeline.hpp"
+#include "../../include/filter/LogFileWindowReader.hpp"
+#include "../../include/LogLoader.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+namespace pipeline {
+
+namespace {
+// Output stream buffer size; output is flushed to disk in chunks this large
+constexpr size_t kOutputBufferSize = 1 << 20;
+}
+
+WindowedProcessor::WindowedProcessor(FilterPipeline& pipeline, size_t memoryBudgetBytes)
+    : pipeline_(pipeline), memoryBudgetBytes_(memoryBudgetBytes) {}
+
+size_t WindowedProcessor::windowRows() const {
+    // Each row holds a timestamp, an input value and an output value; the
+    // window is sized so that all three, plus the pipeline's own copy of the
+    // block, fit in the budget.
+    return std::max<size_t>(1, memoryBudgetBytes_ / (4 * sizeof(double)));
+}
+
+bool WindowedProcessor::processLogFile(const std::string& inputFile, const std::string& columnName,
+                                       const std::string& sourceNodeId, const std::string& outputFile) {
+    processedSamples_ = 0;
+
+    filter::LogFileWindowReader reader;
+    if (!reader.open(inputFile) || !reader.selectColumn(columnName)) {
+        return false;
+    }
+
+    std::vector<char> buffer(kOutputBufferSize);
+    output_ = std::ofstream();
+    output_.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    output_.open(outputFile);
+    if (!output_.is_open()) {
+        return false;
+    }
+    output_ << "timestamp," << columnName << "\n";
+    output_ << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    const size_t rows = windowRows();
+    std::vector<double> timestamps;
+    std::vector<double> values;
+    timestamps.reserve(rows);
+    values.reserve(rows);
+
+    bool ok = true;
+    while (reader.readWindow(rows, timestamps, values) > 0) {
+        if (!writeWindow(sourceNodeId, timestamps, values)) {
+            ok = false;
+            break;
+        }
+        if (progressCallback_ && !progressCallback_(reader.getBytesRead(), reader.getFileSize())) {
+            ok = false;
+            break;
+        }
+    }
+    if (reader.hasFailed()) {
+        ok = false;
+    }
+
+    output_.close();
+    return ok;
+}
+
+bool WindowedProcessor::processWpiLog(const std::string& inputFile, const std::string& fieldName,
+                                      const std::string& sourceNodeId, const std::string& outputFile) {
+    processedSamples_ = 0;
+
+    std::vector<char> buffer(kOutputBufferSize);
+    output_ = std::ofstream();
+    output_.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    output_.open(outputFile);
+    if (!output_.is_open()) {
+        return false;
+    }
+    output_ << "timestamp," << fieldName << "\n";
+    output_ << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    // The loader buffers timestamps and values of the one field; the other
+    // half of the budget is left for the filtered output
+    LogLoader loader;
+    bool ok = loader.StreamFile(inputFile, memoryBudgetBytes_ / 2,
+        [&](const std::string& field, const std::vector<double>& timestamps, const std::vector<double>& values) {
+            if (field != fieldName) {
+                return true;
+            }
+            // wpilog timestamps are microseconds; the CSV has seconds, as for text logs
+            return writeWindow(sourceNodeId, timestamps, values, 1e-6) &&
+                   (!progressCallback_ || progressCallback_(loader.GetStreamPosition(), loader.GetStreamSize()));
+        }, {fieldName});
+
+    output_.close();
+    return ok;
+}
+
+bool WindowedProcessor::writeWindow(const std::string& sourceNodeId, const std::vector<double>& timestamps,
+                                    const std::vector<double>& values, double timestampScale) {
+    // Filter state carries over from the previous window
+    std::vector<double> filtered = pipeline_.processBlock(sourceNodeId, values);
+    const size_t count = std::min(timestamps.size(), filtered.size());
+    for (size_t i = 0; i < count; ++i) {
+        output_ << timestamps[i] * timestampScale << ',' << filtered[i] << '\n';
+    }
+    processedSamples_ += count;
+    return static_cast<bool>(output_);
+}
+
+WindowedRun::~WindowedRun() {
+    cancel();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void WindowedRun::start(const FilterPipeline& pipeline, const std::string& inputFile, const std::string& field,
+                        bool wpilog, const std::string& sourceNodeId, const std::string& outputFile) {
+    if (cancelled_) {
+        state_ = State::Cancelled;
+        return;
+    }
+    pipeline_ = std::make_unique<FilterPipeline>(pipeline.detachedCopy());
+    state_ = State::Running;
+    thread_ = std::thread([this, inputFile, field, wpilog, sourceNodeId, outputFile]() {
+        WindowedProcessor processor(*pipeline_);
+        processor.setProgressCallback([this, &processor](uint64_t bytesRead, uint64_t totalBytes) {
+            bytesRead_ = bytesRead;
+            totalBytes_ = totalBytes;
+            processedSamples_ = processor.getProcessedSamples();
+            return !cancelled_;
+        });
+        const bool ok = wpilog ? processor.processWpiLog(inputFile, field, sourceNodeId, outputFile)
+                               : processor.processLogFile(inputFile, field, sourceNodeId, outputFile);
+        processedSamples_ = processor.getProcessedSamples();
+        state_ = ok ? State::Succeeded : (cancelled_ ? State::Cancelled : State::Failed);
+    });
+}
+
+void WindowedRun::cancel() {
+    cancelled_ = true;
+}
+
+double WindowedRun::getProgress() const {
+    const uint64_t total = totalBytes_.load();
+    return total > 0 ? std::min(1.0, static_cast<double>(bytesRead_.load()) / static_cast<double>(total)) : 0.0;
+}
+
+} // namespace pipeline
@@ -7,11 +7,15 @@
 #include "imnodes.h"
 #include "implot.h"
 #include <cmath>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <unordered_set>
 #include "pipeline/FilterPipeline.hpp"
 #include "filter/Filter.hpp"
+#include "filter/FilterDesign.hpp"
 #include "filter/ButterworthFilter.hpp"
+#include "filter/KalmanFilter.hpp"
 #include <stdexcept>
 #include "portable-file-dialogs.h"
 
@@ -20,10 +24,11 @@
 namespace ui {
 
 FilterDesignUI::FilterDesignUI() : nextNodeId_(1), nextLinkId_(1) {
-    pipeline_ = std::make_unique<pipeline::FilterPipeline>();
+    worker_ = std::make_unique<pipeline::ProcessingWorker>();
 }
 
 FilterDesignUI::~FilterDesignUI() {
+    stopRecording();
     cleanup();
 }
 
@@ -98,6 +103,8 @@ void FilterDesignUI::run() {
 
         renderMenu();
         renderNodeEditor();
+        renderSweepWindow();
+        collectResults();
 
         ImGui::Render();
         int display_w, display_h;
@@ -115,12 +122,16 @@ void FilterDesignUI::renderMenu() {
     if (ImGui::BeginMainMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("New")) {
-                // Clear all nodes and links
+                // Clear all nodes and links; a recording carries on with the new ones
+                for (auto& [id, node] : nodes_) {
+                    detachRecorder(node);
+                }
+                recordChannels_.clear();
                 nodes_.clear();
                 links_.clear();
                 nextNodeId_ = 1;
                 nextLinkId_ = 1;
-                pipeline_ = std::make_unique<pipeline::FilterPipeline>();
+                worker_->reset();
             }
             if (ImGui::MenuItem("Open")) {
                 std::string filePath;
@@ -129,11 +140,15 @@ void FilterDesignUI::renderMenu() {
                     std::ifstream file(filePath);
                     if (file.is_open()) {
                         // Clear existing nodes and links
+                        for (auto& [id, node] : nodes_) {
+                            detachRecorder(node);
+                        }
+                        recordChannels_.clear();
                         nodes_.clear();
                         links_.clear();
                         nextNodeId_ = 1;
                         nextLinkId_ = 1;
-                        pipeline_ = std::make_unique<pipeline::FilterPipeline>();
+                        worker_->reset();
                         
                         // TODO: Parse file and recreate nodes/links
                         file.close();
@@ -158,6 +173,10 @@ void FilterDesignUI::renderMenu() {
             }
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Tools")) {
+            ImGui::MenuItem("Parameter Sweep", nullptr, &showSweep_);
+            ImGui::EndMenu();
+        }
         ImGui::EndMainMenuBar();
     }
 }
@@ -214,7 +233,9 @@ void FilterDesignUI::renderNodeMenu() {
         if (ImGui::BeginMenu("Add Node")) {
             if (ImGui::BeginMenu("Input")) {
                 if (ImGui::MenuItem("Log File")) createNode(Node::NodeType::LogFileInput);
+                if (ImGui::MenuItem("Log Replay")) createNode(Node::NodeType::LogReplayInput);
                 if (ImGui::MenuItem("Network Table")) createNode(Node::NodeType::NetworkTableInput);
+                if (ImGui::MenuItem("Multi-Column Log")) createNode(Node::NodeType::MultiColumnInput);
                 ImGui::EndMenu();
             }
             if (ImGui::MenuItem("Output")) createNode(Node::NodeType::Output);
@@ -222,8 +243,22 @@ void FilterDesignUI::renderNodeMenu() {
             if (ImGui::MenuItem("Chebyshev")) createNode(Node::NodeType::Chebyshev);
             if (ImGui::MenuItem("Notch")) createNode(Node::NodeType::Notch);
             if (ImGui::MenuItem("Band Pass")) createNode(Node::NodeType::BandPass);
+            if (ImGui::MenuItem("Kalman")) createNode(Node::NodeType::Kalman);
+            if (ImGui::BeginMenu("Nonlinear")) {
+                if (ImGui::MenuItem("Median")) createNode(Node::NodeType::Median);
+                if (ImGui::MenuItem("Percentile")) createNode(Node::NodeType::Percentile);
+                if (ImGui::MenuItem("Trimmed Mean")) createNode(Node::NodeType::TrimmedMean);
+                ImGui::EndMenu();
+            }
+            if (ImGui::BeginMenu("Analysis")) {
+                if (ImGui::MenuItem("Power Spectrum")) createNode(Node::NodeType::PowerSpectrum);
+                if (ImGui::MenuItem("Spectrogram")) createNode(Node::NodeType::Spectrogram);
+                if (ImGui::MenuItem("Cross-Correlation")) createNode(Node::NodeType::CrossCorrelation);
+                ImGui::EndMenu();
+            }
             ImGui::EndMenu();
         }
+        renderRecordingMenu();
         ImGui::EndMenuBar();
     }
 }
@@ -240,14 +275,41 @@ void FilterDesignUI::renderNode(int nodeId, const std::string& title) {
     // Render input pins
     for (int i = 0; i < node.inputPins.size(); ++i) {
         ImNodes::BeginInputAttribute(node.inputPins[i]);
-        ImGui::Text("Input %d", i);
+        if (node.nodeType == Node::NodeType::CrossCorrelation) {
+            ImGui::TextUnformatted(i == 0 ? "Reference" : "Signal");
+        } else {
+            ImGui::Text("Input %d", i);
+        }
         ImNodes::EndInputAttribute();
     }
 
     // Render input parameters for input nodes
-    if (node.nodeType == Node::NodeType::LogFileInput || 
-        node.nodeType == Node::NodeType::NetworkTableInput) {
+    if (node.isInput()) {
         renderInputParameters(nodeId);
+        renderSignalPlot(nodeId);
+    }
+
+    if (node.nodeType == Node::NodeType::Output) {
+        renderOutputParameters(nodeId);
+        renderSignalPlot(nodeId);
+    }
+
+    if (node.isOrderStatistic()) {
+        renderOrderStatisticParameters(nodeId);
+        renderFrequencyResponse(nodeId);
+    }
+
+    if (node.nodeType == Node::NodeType::Kalman) {
+        renderKalmanParameters(nodeId);
+        renderFrequencyResponse(nodeId);
+    }
+
+    if (node.nodeType == Node::NodeType::PowerSpectrum) {
+        renderPowerSpectrum(nodeId);
+    } else if (node.nodeType == Node::NodeType::Spectrogram) {
+        renderSpectrogram(nodeId);
+    } else if (node.nodeType == Node::NodeType::CrossCorrelation) {
+        renderCorrelation(nodeId);
     }
 
     // Render filter parameters for filter nodes
@@ -290,6 +352,10 @@ void FilterDesignUI::renderFilterParameters(int nodeId) {
         node.sampleRate = static_cast<double>(node.ui_sampleRate);
         calculateFilterCoefficients(node);
     }
+    // The spectra share the design's frequency axis
+    if (ImGui::IsItemDeactivatedAfterEdit() && node.analyzer) {
+        attachAnalyzers(node);
+    }
 
     // Type-specific parameters
     switch (node.filterType) {
@@ -319,33 +385,309 @@ void FilterDesignUI::renderFrequencyResponse(int nodeId) {
     auto& node = nodes_[nodeId];
     
     ImGui::Separator();
-    if (ImGui::CollapsingHeader("Frequency Response")) {
-        if (ImPlot::BeginPlot("Frequency Response Plot", ImVec2(-1, 300))) {
-            // Set up the plot
-            ImPlot::SetupAxes("Frequency (Hz)", "Magnitude (dB)", ImPlotAxisFlags_AutoFit);
-            ImPlot::SetupAxisLimits(ImAxis_X1, -1.5, 1.5);
-            ImPlot::SetupAxisLimits(ImAxis_Y1, -1.5, 1.5);
+    if (!ImGui::CollapsingHeader("Frequency Response")) {
+        return;
+    }
 
-            // Plot poles
-            std::vector<float> poleX, poleY;
-            for (const auto& pole : node.poles) {
-                poleX.push_back(static_cast<float>(pole.real()));
-                poleY.push_back(static_cast<float>(pole.imag()));
+    // Spectra are only computed once someone looks at them
+    if (!node.analyzer) {
+        attachAnalyzers(node);
+    }
+    renderSpectrumParameters(nodeId);
+
+    const bool hasInput = node.inputAnalyzer && node.inputAnalyzer->getPsd(spectrumFrequencies_, inputSpectrum_);
+    const bool hasOutput = node.analyzer && node.analyzer->getPsd(spectrumFrequencies_, outputSpectrum_);
+
+    // What the node actually did, from the ratio of the two spectra
+    measuredResponse_.clear();
+    if (hasInput && hasOutput) {
+        measuredResponse_.resize(spectrumFrequencies_.size());
+        for (size_t k = 0; k < measuredResponse_.size(); ++k) {
+            measuredResponse_[k] = 10.0 * std::log10(std::max(outputSpectrum_[k], 1e-30) / std::max(inputSpectrum_[k], 1e-30));
+        }
+    }
+    for (double& power : inputSpectrum_) {
+        power = 10.0 * std::log10(std::max(power, 1e-30));
+    }
+    for (double& power : outputSpectrum_) {
+        power = 10.0 * std::log10(std::max(power, 1e-30));
+    }
+
+    const int bins = static_cast<int>(spectrumFrequencies_.size());
+    if (ImPlot::BeginSubplots("##Spectra", 1, 3, ImVec2(960, 280), ImPlotSubplotFlags_LinkAllX)) {
+        if (ImPlot::BeginPlot("Input")) {
+            ImPlot::SetupAxes("Frequency (Hz)", "PSD (dB/Hz)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            if (hasInput) {
+                ImPlot::PlotLine("Input", spectrumFrequencies_.data(), inputSpectrum_.data(), bins);
             }
-            if (!poleX.empty()) {
-                ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 8, ImVec4(1,0,0,1), 2.0f);
-                ImPlot::PlotScatter("Poles", poleX.data(), poleY.data(), poleX.size());
+            ImPlot::EndPlot();
+        }
+        if (ImPlot::BeginPlot("Output")) {
+            ImPlot::SetupAxes("Frequency (Hz)", "PSD (dB/Hz)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            if (hasOutput) {
+                ImPlot::PlotLine("Output", spectrumFrequencies_.data(), outputSpectrum_.data(), bins);
             }
+            ImPlot::EndPlot();
+        }
+        if (ImPlot::BeginPlot("Response")) {
+            ImPlot::SetupAxes("Frequency (Hz)", "Magnitude (dB)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            if (!node.responseDb.empty()) {
+                ImPlot::PlotLine("Design", node.responseFrequencies.data(), node.responseDb.data(),
+                                 static_cast<int>(node.responseDb.size()));
+            }
+            if (!measuredResponse_.empty()) {
+                ImPlot::PlotLine("Measured", spectrumFrequencies_.data(), measuredResponse_.data(), bins);
+            }
+            ImPlot::EndPlot();
+        }
+        ImPlot::EndSubplots();
+    }
+}
 
-            // Plot zeros
-            std::vector<float> zeroX, zeroY;
-            for (const auto& zero : node.zeros) {
-                zeroX.push_back(static_cast<float>(zero.real()));
-                zeroY.push_back(static_cast<float>(zero.imag()));
+void FilterDesignUI::renderSpectrumParameters(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    static const char* segments[] = {"256", "512", "1024", "2048", "4096", "8192", "16384"};
+    static const char* windows[] = {"Rectangular", "Hann", "Hamming", "Blackman"};
+    int segment = 0;
+    while (segment < IM_ARRAYSIZE(segments) - 1 && (256 << segment) < node.spectrumSegment) {
+        ++segment;
+    }
+
+    // A new analyzer starts over from the whole signal, so only swap once the edit is done
+    bool changed = false;
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::Combo("Segment", &segment, segments, IM_ARRAYSIZE(segments))) {
+        node.spectrumSegment = 256 << segment;
+        changed = true;
+    }
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    changed |= ImGui::Combo("Window", &node.spectrumWindow, windows, IM_ARRAYSIZE(windows));
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::SliderFloat("Overlap", &node.spectrumOverlap, 0.0f, 0.9f, "%.2f");
+    changed |= ImGui::IsItemDeactivatedAfterEdit();
+    if (node.filterType == Node::FilterType::None && node.nodeType != Node::NodeType::Kalman) {
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(120.0f);
+        ImGui::DragFloat("Sample Rate (Hz)##Spectrum", &node.spectrumRate, 1.0f, 1.0f, 100000.0f);
+        changed |= ImGui::IsItemDeactivatedAfterEdit();
+    }
+
+    if (changed) {
+        attachAnalyzers(node);
+    }
+}
+
+void FilterDesignUI::renderPowerSpectrum(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    ImGui::Separator();
+    renderSpectrumParameters(nodeId);
+    if (!node.analyzer || !node.analyzer->getPsd(spectrumFrequencies_, outputSpectrum_)) {
+        ImGui::TextUnformatted("Waiting for a full segment");
+        return;
+    }
+    for (double& power : outputSpectrum_) {
+        power = 10.0 * std::log10(std::max(power, 1e-30));
+    }
+
+    ImGui::Text("%llu segments, %.3g Hz resolution", static_cast<unsigned long long>(node.analyzer->getSegmentCount()),
+                spectrumFrequencies_.size() > 1 ? spectrumFrequencies_[1] : 0.0);
+    if (ImPlot::BeginPlot("Power Spectral Density", ImVec2(640, 300))) {
+        ImPlot::SetupAxes("Frequency (Hz)", "PSD (dB/Hz)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("PSD", spectrumFrequencies_.data(), outputSpectrum_.data(), static_cast<int>(spectrumFrequencies_.size()));
+        ImPlot::EndPlot();
+    }
+}
+
+void FilterDesignUI::renderSpectrogram(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    ImGui::Separator();
+    renderSpectrumParameters(nodeId);
+    if (!node.analyzer) {
+        return;
+    }
+
+    // The image only changes when segments arrive, so most frames reuse it
+    auto& view = node.spectrogram;
+    const uint64_t revision = node.analyzer->getRevision();
+    if (revision != view.revision) {
+        view.revision = revision;
+        view.columns = node.analyzer->getSpectrogram(view.image, view.startTime, view.endTime);
+        if (view.columns > 0) {
+            const auto range = std::minmax_element(view.image.begin(), view.image.end());
+            // Keep 100 dB below the peak; the floor is mostly window leakage
+            view.maxDb = *range.second;
+            view.minDb = std::max(*range.first, view.maxDb - 100.0);
+        }
+    }
+    if (view.columns == 0) {
+        ImGui::TextUnformatted("Waiting for a full segment");
+        return;
+    }
+
+    const auto& options = node.analyzer->getOptions();
+    const int rows = static_cast<int>(node.analyzer->getBinCount());
+    if (ImPlot::BeginPlot("##Spectrogram", ImVec2(640, 300))) {
+        ImPlot::SetupAxes("Time (s)", "Frequency (Hz)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotHeatmap("Spectrogram", view.image.data(), rows, static_cast<int>(view.columns), view.minDb, view.maxDb,
+                            nullptr, ImPlotPoint(view.startTime, 0.0), ImPlotPoint(view.endTime, 0.5 * options.sampleRate));
+        ImPlot::EndPlot();
+    }
+    ImGui::SameLine();
+    ImPlot::ColormapScale("dB", view.minDb, view.maxDb, ImVec2(70, 300));
+}
+
+void FilterDesignUI::renderCorrelation(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    ImGui::Separator();
+    ImGui::Text("Correlation");
+
+    // A new correlator starts over from both whole signals, so only swap once the edit is done
+    ImGui::DragFloat("Sample Rate (Hz)", &node.correlationRate, 1.0f, 1.0f, 100000.0f);
+    bool changed = ImGui::IsItemDeactivatedAfterEdit();
+    ImGui::DragFloat("Max Lag (s)", &node.correlationMaxLag, 0.01f, 0.001f, 60.0f, "%.3f");
+    changed |= ImGui::IsItemDeactivatedAfterEdit();
+    changed |= ImGui::Checkbox("Sliding Window", &node.correlationSliding);
+    if (node.correlationSliding) {
+        ImGui::DragFloat("Window (s)", &node.correlationWindow, 0.1f, 0.1f, 600.0f, "%.1f");
+        changed |= ImGui::IsItemDeactivatedAfterEdit();
+    }
+    if (changed) {
+        updateCorrelator(node, true);
+    }
+
+    const filter::CorrelationPeak peak = node.correlator ? node.correlator->getPeak() : filter::CorrelationPeak();
+    if (!peak.valid) {
+        ImGui::TextUnformatted("Connect a reference and a signal");
+        return;
+    }
+    ImGui::Text("Lag: %.2f ms (%.2f samples), r = %.3f", peak.lagSeconds * 1000.0, peak.lagSamples, peak.coefficient);
+
+    node.correlator->getFunction(correlationLags_, correlationValues_);
+    for (double& lag : correlationLags_) {
+        lag *= 1000.0;
+    }
+    if (ImPlot::BeginPlot("Correlation", ImVec2(480, 250))) {
+        ImPlot::SetupAxes("Lag (ms)", "r", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("r", correlationLags_.data(), correlationValues_.data(), static_cast<int>(correlationValues_.size()));
+        const double peakLag = peak.lagSeconds * 1000.0;
+        ImPlot::PlotInfLines("Peak", &peakLag, 1);
+        ImPlot::EndPlot();
+    }
+
+    if (node.correlator->isSliding()) {
+        node.correlator->getHistory(correlationTimes_, correlationLags_, correlationCoefficients_);
+        for (double& lag : correlationLags_) {
+            lag *= 1000.0;
+        }
+        if (ImPlot::BeginPlot("Lag over Time", ImVec2(480, 250))) {
+            ImPlot::SetupAxes("Time (s)", "Lag (ms)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotLine("Lag", correlationTimes_.data(), correlationLags_.data(), static_cast<int>(correlationLags_.size()));
+            ImPlot::EndPlot();
+        }
+    }
+}
+
+void FilterDesignUI::updateCorrelator(Node& node, bool rebuild) {
+    if (node.correlator && rebuild) {
+        worker_->setCorrelator(node.correlator, std::string(), std::string());
+        node.correlator.reset();
+    }
+    if (!node.correlator) {
+        filter::CorrelationOptions options;
+        options.sampleRate = node.correlationRate;
+        options.maxLag = static_cast<size_t>(std::max(1.0f, std::round(node.correlationMaxLag * node.correlationRate)));
+        if (node.correlationSliding) {
+            options.windowLength = static_cast<size_t>(std::max(2.0f, std::round(node.correlationWindow * node.correlationRate)));
+        }
+        node.correlator = std::make_shared<filter::CrossCorrelator>(options);
+    }
+
+    // The correlator reads the outputs of whatever feeds its two pins
+    std::string referenceId;
+    std::string signalId;
+    for (const auto& [linkId, link] : links_) {
+        if (link.toNode != node.id || node.inputPins.size() < 2) {
+            continue;
+        }
+        auto source = nodes_.find(link.fromNode);
+        if (source == nodes_.end()) {
+            continue;
+        }
+        if (link.toPin == node.inputPins[0]) {
+            referenceId = source->second.pipelineNodeId;
+        } else if (link.toPin == node.inputPins[1]) {
+            signalId = source->second.pipelineNodeId;
+        }
+    }
+    worker_->setCorrelator(node.correlator, referenceId, signalId);
+}
+
+void FilterDesignUI::attachAnalyzers(Node& node) {
+    if (node.pipelineNodeId.empty()) {
+        return;
+    }
+
+    // Options are fixed per analyzer; the worker fills a new one from the whole signal
+    const filter::SpectrumOptions options = spectrumOptions(node);
+    node.analyzer = std::make_shared<filter::SpectrumAnalyzer>(options);
+    worker_->setAnalyzer(node.pipelineNodeId, node.analyzer);
+    node.spectrogram = Node::SpectrogramView();
+    if (!node.isAnalysis()) {
+        node.inputAnalyzer = std::make_shared<filter::SpectrumAnalyzer>(options);
+        worker_->setAnalyzer(node.pipelineNodeId, node.inputAnalyzer, true);
+    }
+}
+
+filter::SpectrumOptions FilterDesignUI::spectrumOptions(const Node& node) const {
+    filter::SpectrumOptions options;
+    options.segmentLength = static_cast<size_t>(node.spectrumSegment);
+    options.overlap = node.spectrumOverlap;
+    options.window = static_cast<filter::WindowType>(node.spectrumWindow);
+    // Linear filters plot against their design, so they share its rate
+    if (node.filterType != Node::FilterType::None) {
+        options.sampleRate = node.sampleRate;
+    } else if (node.nodeType == Node::NodeType::Kalman) {
+        options.sampleRate = node.kalmanRate;
+    } else {
+        options.sampleRate = node.spectrumRate;
+    }
+    return options;
+}
+
+void FilterDesignUI::renderSignalPlot(int nodeId) {
+    auto& node = nodes_[nodeId];
+    const bool hasOutput = !node.outputData.empty() && node.outputPyramid;
+    if (!hasOutput && node.channelOutputs.empty()) {
+        return;
+    }
+
+    size_t length = hasOutput ? node.outputData.size() : 0;
+    for (const auto& channel : node.channelOutputs) {
+        length = std::max(length, channel.output.size());
+    }
+
+    ImGui::Separator();
+    if (ImGui::CollapsingHeader("Signal")) {
+        if (ImPlot::BeginPlot("Signal Plot", ImVec2(-1, 300))) {
+            ImPlot::SetupAxes("Sample", "Value", ImPlotAxisFlags_None, ImPlotAxisFlags_AutoFit);
+            ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, static_cast<double>(length), ImPlotCond_Once);
+
+            // Only the visible range is drawn, decimated to about two points per pixel
+            const ImPlotRect limits = ImPlot::GetPlotLimits();
+            const size_t pixels = static_cast<size_t>(std::max(1.0f, ImPlot::GetPlotSize().x));
+            if (hasOutput) {
+                node.outputPyramid->queryLine(node.outputData.values(), limits.X.Min, limits.X.Max, pixels, plotX_, plotY_);
+                ImPlot::PlotLine("Output", plotX_.data(), plotY_.data(), static_cast<int>(plotX_.size()));
             }
-            if (!zeroX.empty()) {
-                ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 8, ImVec4(0,0,1,1), 2.0f, ImVec4(1,1,1,1));
-                ImPlot::PlotScatter("Zeros", zeroX.data(), zeroY.data(), zeroX.size());
+            for (const auto& channel : node.channelOutputs) {
+                channel.pyramid->queryLine(channel.output.values(), limits.X.Min, limits.X.Max, pixels, plotX_, plotY_);
+                ImPlot::PlotLine(channel.name.c_str(), plotX_.data(), plotY_.data(), static_cast<int>(plotX_.size()));
             }
 
             ImPlot::EndPlot();
@@ -438,6 +780,485 @@ bool FilterDesignUI::openFileDialog(std::string& outPath) {
     return true;
 }
 
+void FilterDesignUI::renderOrderStatisticParameters(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    ImGui::Separator();
+    ImGui::Text("Window");
+
+    // Changing a parameter restarts the window, so only rerun once the edit is done
+    ImGui::DragInt("Samples", &node.windowSize, 1.0f, 1, 100000);
+    bool changed = ImGui::IsItemDeactivatedAfterEdit();
+    if (node.nodeType == Node::NodeType::Percentile) {
+        ImGui::SliderFloat("Percentile", &node.percentile, 0.0f, 100.0f, "%.1f");
+        changed |= ImGui::IsItemDeactivatedAfterEdit();
+    } else if (node.nodeType == Node::NodeType::TrimmedMean) {
+        ImGui::SliderFloat("Trim per Side", &node.trimFraction, 0.0f, 0.5f, "%.2f");
+        changed |= ImGui::IsItemDeactivatedAfterEdit();
+    }
+
+    if (changed) {
+        processFilters();
+    }
+}
+
+void FilterDesignUI::renderKalmanParameters(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    static const char* models[] = {"Constant Velocity", "Constant Acceleration"};
+    static const char* outputs[] = {"Position", "Velocity", "Acceleration"};
+
+    ImGui::Separator();
+    ImGui::Text("Kalman Filter");
+
+    // A new filter starts its estimate over, so only rerun once the edit is done
+    bool changed = ImGui::Combo("Model", &node.kalmanModel, models, IM_ARRAYSIZE(models));
+    const int states = node.kalmanModel == static_cast<int>(filter::KinematicModel::ConstantAcceleration) ? 3 : 2;
+    node.kalmanOutput = std::min(node.kalmanOutput, states - 1);
+    changed |= ImGui::Combo("Output", &node.kalmanOutput, outputs, states);
+    changed |= ImGui::Checkbox("Steady State", &node.kalmanSteadyState);
+    ImGui::DragFloat("Sample Rate (Hz)", &node.kalmanRate, 1.0f, 1.0f, 100000.0f);
+    const bool rateChanged = ImGui::IsItemDeactivatedAfterEdit();
+    ImGui::DragFloat("Process Noise", &node.kalmanProcessNoise, 0.01f, 0.0f, 1e6f, "%.4g");
+    changed |= ImGui::IsItemDeactivatedAfterEdit();
+    ImGui::DragFloat("Measurement Noise", &node.kalmanMeasurementNoise, 0.001f, 0.0f, 1e6f, "%.4g");
+    changed |= ImGui::IsItemDeactivatedAfterEdit();
+
+    if (changed || rateChanged) {
+        calculateFrequencyResponse(node);
+        processFilters();
+    }
+    // The spectra are plotted against the filter's rate
+    if (rateChanged && node.analyzer) {
+        attachAnalyzers(node);
+    }
+}
+
+void FilterDesignUI::startSweep() {
+    auto it = nodes_.find(sweepSettings_.sourceNode);
+    if (it == nodes_.end() || !it->second.inputNode) {
+        return;
+    }
+
+    pipeline::SweepGrid grid;
+    grid.types.clear();
+    if (sweepSettings_.firstOrder) grid.types.push_back(filter::DesignType::FirstOrder);
+    if (sweepSettings_.butterworth) grid.types.push_back(filter::DesignType::Butterworth);
+    if (sweepSettings_.chebyshev) grid.types.push_back(filter::DesignType::Chebyshev);
+    grid.orders.clear();
+    for (int order = sweepSettings_.minOrder; order <= sweepSettings_.maxOrder; ++order) {
+        grid.orders.push_back(order);
+    }
+    grid.cutoffs = pipeline::SweepGrid::logSpace(sweepSettings_.minCutoff, sweepSettings_.maxCutoff,
+                                                  static_cast<size_t>(sweepSettings_.cutoffCount));
+    grid.sampleRate = sweepSettings_.sampleRate;
+    grid.ripple = sweepSettings_.ripple;
+
+    // The sweep runs on the raw input, copied once and shared by every design
+    sweep_.start(it->second.inputNode->getBuffer(), grid);
+}
+
+void FilterDesignUI::renderSweepWindow() {
+    if (!showSweep_) {
+        return;
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(700, 800), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Parameter Sweep", &showSweep_)) {
+        ImGui::End();
+        return;
+    }
+
+    auto& settings = sweepSettings_;
+    auto source = nodes_.find(settings.sourceNode);
+    const char* sourceTitle = source != nodes_.end() ? source->second.title.c_str() : "Select an input";
+    if (ImGui::BeginCombo("Signal", sourceTitle)) {
+        for (const auto& [id, node] : nodes_) {
+            if (node.isInput() && node.inputNode) {
+                const std::string label = node.title + "##" + std::to_string(id);
+                if (ImGui::Selectable(label.c_str(), id == settings.sourceNode)) {
+                    settings.sourceNode = id;
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    ImGui::Checkbox("First Order", &settings.firstOrder);
+    ImGui::SameLine();
+    ImGui::Checkbox("Butterworth", &settings.butterworth);
+    ImGui::SameLine();
+    ImGui::Checkbox("Chebyshev", &settings.chebyshev);
+    ImGui::DragIntRange2("Order", &settings.minOrder, &settings.maxOrder, 0.1f, 1, 12);
+    ImGui::DragFloatRange2("Cutoff (Hz)", &settings.minCutoff, &settings.maxCutoff, 0.1f, 0.01f, 10000.0f, "%.2f");
+    ImGui::SliderInt("Cutoff Steps", &settings.cutoffCount, 2, 200);
+    ImGui::DragFloat("Sample Rate (Hz)", &settings.sampleRate, 1.0f, 1.0f, 100000.0f);
+    if (settings.chebyshev) {
+        ImGui::DragFloat("Ripple (dB)", &settings.ripple, 0.1f, 0.1f, 10.0f);
+    }
+
+    if (sweep_.isRunning()) {
+        ImGui::ProgressBar(static_cast<float>(sweep_.getProgress()), ImVec2(-80.0f, 0.0f));
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel")) {
+            sweep_.cancel();
+        }
+    } else if (ImGui::Button("Run Sweep")) {
+        startSweep();
+    }
+
+    auto results = sweep_.getResults();
+    if (!results || results->empty()) {
+        ImGui::End();
+        return;
+    }
+
+    // Heatmap of one metric over order and cutoff, for one design type
+    const char* types[] = { "First Order", "Butterworth", "Chebyshev" };
+    const char* metrics[] = { "RMS Residual", "Lag (ms)", "Noise Power", "Overshoot (%)" };
+    ImGui::Separator();
+    ImGui::Combo("Type", &settings.heatmapType, types, IM_ARRAYSIZE(types));
+    ImGui::Combo("Metric", &settings.heatmapMetric, metrics, IM_ARRAYSIZE(metrics));
+
+    auto metricValue = [&](const pipeline::SweepResult& result) {
+        switch (settings.heatmapMetric) {
+            case 1: return result.lagSeconds * 1000.0;
+            case 2: return result.noisePower;
+            case 3: return result.overshoot;
+            default: return result.rmsResidual;
+        }
+    };
+
+    // Results are in grid order: orders outer, cutoffs inner
+    const auto heatmapType = static_cast<filter::DesignType>(settings.heatmapType);
+    std::vector<double> cutoffs;
+    std::vector<int> orders;
+    for (const auto& result : *results) {
+        if (result.spec.type != heatmapType) {
+            continue;
+        }
+        if (orders.empty() || orders.back() != result.spec.order) {
+            orders.push_back(result.spec.order);
+        }
+        if (orders.size() == 1) {
+            cutoffs.push_back(result.spec.cutoffFreq);
+        }
+    }
+
+    if (!orders.empty() && !cutoffs.empty()) {
+        // Highest order on top
+        sweepHeatmap_.assign(orders.size() * cutoffs.size(), 0.0);
+        size_t index = 0;
+        for (const auto& result : *results) {
+            if (result.spec.type == heatmapType && index < sweepHeatmap_.size()) {
+                const size_t row = orders.size() - 1 - index / cutoffs.size();
+                sweepHeatmap_[row * cutoffs.size() + index % cutoffs.size()] = metricValue(result);
+                ++index;
+            }
+        }
+        const auto range = std::minmax_element(sweepHeatmap_.begin(), sweepHeatmap_.end());
+        if (ImPlot::BeginPlot("##SweepHeatmap", ImVec2(-80, 250))) {
+            ImPlot::SetupAxes("Cutoff step", "Order", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::PlotHeatmap(metrics[settings.heatmapMetric], sweepHeatmap_.data(),
+                static_cast<int>(orders.size()), static_cast<int>(cutoffs.size()), *range.first, *range.second, nullptr,
+                ImPlotPoint(0, orders.front() - 0.5), ImPlotPoint(static_cast<double>(cutoffs.size()), orders.back() + 0.5));
+            ImPlot::EndPlot();
+        }
+        ImGui::SameLine();
+        ImPlot::ColormapScale("##SweepScale", *range.first, *range.second, ImVec2(70, 250));
+        ImGui::Text("Cutoff steps span %.2f to %.2f Hz", cutoffs.front(), cutoffs.back());
+    }
+
+    // Lag against noise for every design; the front holds the best trade-offs
+    std::vector<double> lagMs;
+    std::vector<double> noise;
+    std::vector<const pipeline::SweepResult*> front;
+    for (const auto& result : *results) {
+        lagMs.push_back(result.lagSeconds * 1000.0);
+        noise.push_back(result.noisePower);
+        if (result.pareto) {
+            front.push_back(&result);
+        }
+    }
+    std::sort(front.begin(), front.end(), [](const auto* a, const auto* b) { return a->lagSamples < b->lagSamples; });
+    std::vector<double> frontLag;
+    std::vector<double> frontNoise;
+    for (const auto* result : front) {
+        frontLag.push_back(result->lagSeconds * 1000.0);
+        frontNoise.push_back(result->noisePower);
+    }
+
+    if (ImPlot::BeginPlot("Pareto Front", ImVec2(-1, 250))) {
+        ImPlot::SetupAxes("Lag (ms)", "Noise Power", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+        ImPlot::PlotScatter("Designs", lagMs.data(), noise.data(), static_cast<int>(lagMs.size()));
+        ImPlot::PlotLine("Front", frontLag.data(), frontNoise.data(), static_cast<int>(frontLag.size()));
+        ImPlot::EndPlot();
+    }
+
+    if (ImGui::BeginTable("ParetoDesigns", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, 200))) {
+        ImGui::TableSetupColumn("Type");
+        ImGui::TableSetupColumn("Order");
+        ImGui::TableSetupColumn("Cutoff (Hz)");
+        ImGui::TableSetupColumn("Lag (ms)");
+        ImGui::TableSetupColumn("Noise");
+        ImGui::TableSetupColumn("Overshoot (%)");
+        ImGui::TableHeadersRow();
+        for (const auto* result : front) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(filter::designTypeName(result->spec.type).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", result->spec.order);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", result->spec.cutoffFreq);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", result->lagSeconds * 1000.0);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3g", result->noisePower);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", result->overshoot);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+void FilterDesignUI::renderRecordingMenu() {
+    if (ImGui::BeginMenu("Record")) {
+        if (!recorder_ && ImGui::MenuItem("Start Recording...")) {
+            std::string filename;
+            if (saveFileDialog(filename)) {
+                startRecording(filename);
+            }
+        }
+        if (recorder_ && ImGui::MenuItem("Stop Recording")) {
+            stopRecording();
+        }
+        ImGui::EndMenu();
+    }
+
+    if (recorder_) {
+        if (recorder_->hasFailed()) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Recording failed");
+        } else {
+            ImGui::Text("REC %llu records, %llu dropped",
+                static_cast<unsigned long long>(recorder_->getWrittenRecords()),
+                static_cast<unsigned long long>(recorder_->getDroppedRecords()));
+        }
+    }
+}
+
+void FilterDesignUI::startRecording(const std::string& filename) {
+    // Stamp outputs on the NT clock, so they line up with the raw updates
+    recorder_ = std::make_unique<data::WpiLogRecorder>([]() { return nt::Now(); });
+
+    // Raw NT updates and every output node, each as its own entry; nodes
+    // created or re-created while recording are attached as they appear
+    for (auto& [id, node] : nodes_) {
+        attachRecorder(node);
+    }
+
+    if (!recorder_->open(filename)) {
+        stopRecording();
+    }
+}
+
+void FilterDesignUI::stopRecording() {
+    if (!recorder_) {
+        return;
+    }
+
+    // Detach the producers first; the recorder drains what they queued
+    for (auto& [id, node] : nodes_) {
+        detachRecorder(node);
+    }
+    recordChannels_.clear();
+    recorder_->close();
+    recorder_.reset();
+}
+
+void FilterDesignUI::attachRecorder(Node& node) {
+    if (!recorder_) {
+        return;
+    }
+
+    // NT inputs are named after their topic, outputs after the title shown
+    // on the node, numbered when the title is already an entry in the file
+    auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(node.inputNode.get());
+    std::string name;
+    if (node.nodeType == Node::NodeType::NetworkTableInput && ntInput) {
+        name = "NT:/" + node.networkTableName + "/" + node.networkTableKey;
+    } else if (node.nodeType == Node::NodeType::Output && !node.pipelineNodeId.empty()) {
+        name = node.title;
+    } else {
+        return;
+    }
+
+    // An input re-created for the same topic keeps appending to its entry
+    auto& channel = recordChannels_[node.id];
+    if (!channel || (ntInput && channel->getName() != name)) {
+        if (!ntInput) {
+            const std::string title = name;
+            for (int number = 2; recorder_->hasChannel(name); ++number) {
+                name = title + " " + std::to_string(number);
+            }
+        }
+        channel = recorder_->addChannel(name);
+    }
+
+    if (ntInput) {
+        ntInput->setRecorder(channel);
+    } else {
+        worker_->setRecorder(node.pipelineNodeId, channel);
+    }
+}
+
+void FilterDesignUI::detachRecorder(Node& node) {
+    if (recordChannels_.count(node.id) == 0) {
+        return;
+    }
+    if (auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(node.inputNode.get())) {
+        ntInput->setRecorder(nullptr);
+    } else if (node.nodeType == Node::NodeType::Output && !node.pipelineNodeId.empty()) {
+        worker_->setRecorder(node.pipelineNodeId, nullptr);
+    }
+}
+
+bool FilterDesignUI::saveFileDialog(std::string& outPath) {
+    auto dialog = pfd::save_file("Save output as", ".",
+        { "CSV Files", "*.csv", "WPILib Logs", "*.wpilog", "All Files", "*" },
+        pfd::opt::none);
+
+    if (dialog.result().empty()) {
+        return false;
+    }
+
+    outPath = dialog.result();
+    return true;
+}
+
+void FilterDesignUI::renderOutputParameters(int nodeId) {
+    auto& node = nodes_[nodeId];
+
+    ImGui::Separator();
+    ImGui::Text("Output File");
+
+    char filename[256] = {0};
+    strncpy(filename, node.outputFilename.c_str(), sizeof(filename) - 1);
+    if (ImGui::InputText("File", filename, sizeof(filename))) {
+        node.outputFilename = filename;
+    }
+    if (ImGui::Button("Browse...")) {
+        std::string selectedPath;
+        if (saveFileDialog(selectedPath)) {
+            node.outputFilename = selectedPath;
+        }
+    }
+
+    const char* formats[] = { "CSV", "WPILib Log" };
+    ImGui::Combo("Format", &node.outputFormat, formats, IM_ARRAYSIZE(formats));
+    ImGui::DragFloat("Sample Rate (Hz)", &node.outputRate, 1.0f, 1.0f, 10000.0f);
+
+    // The worker writes the current output, then keeps appending streamed blocks
+    if (ImGui::Button("Write") && !node.outputFilename.empty()) {
+        node.outputSink = std::make_shared<filter::OutputSink>(
+            node.outputFilename, static_cast<filter::OutputSink::Format>(node.outputFormat), node.outputRate);
+        worker_->setOutputSink(node.pipelineNodeId, node.outputSink);
+        processFilters();
+    }
+
+    if (node.outputSink) {
+        ImGui::SameLine();
+        const bool stop = ImGui::Button("Stop");
+
+        if (node.outputSink->hasFailed()) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Write failed");
+        } else {
+            ImGui::Text("%llu rows, %.1f KiB",
+                static_cast<unsigned long long>(node.outputSink->getRowsWritten()),
+                node.outputSink->getBytesWritten() / 1024.0);
+        }
+
+        if (stop) {
+            worker_->setOutputSink(node.pipelineNodeId, nullptr);
+            node.outputSink.reset();
+        }
+    }
+
+    auto channel = recordChannels_.find(nodeId);
+    if (channel != recordChannels_.end()) {
+        ImGui::Text("Recording as \"%s\"", channel->second->getName().c_str());
+    }
+
+    renderFileRun(node);
+}
+
+void FilterDesignUI::renderFileRun(Node& node) {
+    // Logs read from a file can also be filtered whole, in windows, without
+    // loading them; the output goes to the file above as CSV
+    const Node* source = findSourceInput(node.id);
+    if (!source || source->logFilename.empty() || source->logColumnName.empty() ||
+        (source->nodeType != Node::NodeType::LogFileInput && source->nodeType != Node::NodeType::LogReplayInput)) {
+        return;
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Whole Log");
+    const bool running = node.fileRun && (node.fileRun->getState() == pipeline::WindowedRun::State::Queued ||
+                                          node.fileRun->getState() == pipeline::WindowedRun::State::Running);
+    if (!running) {
+        if (ImGui::Button("Filter Whole Log to CSV") && !node.outputFilename.empty()) {
+            node.fileRun = std::make_shared<pipeline::WindowedRun>();
+            worker_->startWindowedRun(node.fileRun, source->logFilename, source->logColumnName,
+                                      source->nodeType == Node::NodeType::LogReplayInput,
+                                      source->pipelineNodeId, node.outputFilename);
+        }
+    } else if (ImGui::Button("Cancel")) {
+        node.fileRun->cancel();
+    }
+
+    if (!node.fileRun) {
+        return;
+    }
+    const auto samples = static_cast<unsigned long long>(node.fileRun->getProcessedSamples());
+    switch (node.fileRun->getState()) {
+        case pipeline::WindowedRun::State::Queued:
+        case pipeline::WindowedRun::State::Running:
+            ImGui::ProgressBar(static_cast<float>(node.fileRun->getProgress()));
+            ImGui::Text("%llu samples", samples);
+            break;
+        case pipeline::WindowedRun::State::Succeeded:
+            ImGui::Text("Done, %llu samples", samples);
+            break;
+        case pipeline::WindowedRun::State::Failed:
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Filtering the log failed");
+            break;
+        case pipeline::WindowedRun::State::Cancelled:
+            ImGui::Text("Cancelled");
+            break;
+    }
+}
+
+const FilterDesignUI::Node* FilterDesignUI::findSourceInput(int nodeId) const {
+    // Follow the first input link upstream; the visited set stops at cycles
+    std::unordered_set<int> visited;
+    auto current = nodes_.find(nodeId);
+    while (current != nodes_.end() && visited.insert(current->first).second) {
+        if (current->second.isInput()) {
+            return &current->second;
+        }
+        auto link = std::find_if(links_.begin(), links_.end(),
+            [&](const auto& entry) { return entry.second.toNode == current->first; });
+        if (link == links_.end()) {
+            break;
+        }
+        current = nodes_.find(link->second.fromNode);
+    }
+    return nullptr;
+}
+
 void FilterDesignUI::renderInputParameters(int nodeId) {
     auto& node = nodes_[nodeId];
     
@@ -452,7 +1273,7 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
             if (!node.logFilename.empty()) {
                 auto inputNode = std::make_shared<filter::LogFileInput>(node.logFilename, node.logColumnName);
                 inputNode->start();
-                pipeline_->setInputNode(node.pipelineNodeId, inputNode);
+                setNodeInput(node, inputNode);
             }
         }
 
@@ -463,15 +1284,28 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
                 if (!node.logFilename.empty()) {
                     auto inputNode = std::make_shared<filter::LogFileInput>(node.logFilename, node.logColumnName);
                     inputNode->start();
-                    pipeline_->setInputNode(node.pipelineNodeId, inputNode);
+                    setNodeInput(node, inputNode);
                 }
             }
         }
 
         // Show available fields if file is loaded
-        if (auto inputNode = pipeline_->getInputNode(node.pipelineNodeId)) {
+        if (auto inputNode = node.inputNode) {
             if (auto* logInput = dynamic_cast<filter::LogFileInput*>(inputNode.get())) {
-                const auto& fields = logInput->getAvailableFields();
+                if (ImGui::Checkbox("Follow File", &node.followLog)) {
+                    logInput->setFollow(node.followLog);
+                }
+
+                // The file is parsed in the background; the fields appear when it is done
+                if (logInput->isLoading()) {
+                    ImGui::ProgressBar(static_cast<float>(logInput->getLoadProgress()), ImVec2(-80.0f, 0.0f));
+                    ImGui::SameLine();
+                    if (ImGui::Button("Cancel")) {
+                        logInput->cancelLoad();
+                    }
+                }
+
+                const auto fields = logInput->getAvailableFields();
                 if (!fields.empty()) {
                     ImGui::Separator();
                     ImGui::Text("Available Fields");
@@ -491,6 +1325,133 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
             }
         }
     }
+    else if (node.nodeType == Node::NodeType::LogReplayInput) {
+        char filename[256] = {0};
+        strncpy(filename, node.logFilename.c_str(), sizeof(filename) - 1);
+        bool fileChanged = ImGui::InputText("Log File", filename, sizeof(filename));
+        if (fileChanged) {
+            node.logFilename = filename;
+        }
+
+        if (ImGui::Button("Browse...")) {
+            std::string selectedPath;
+            if (openFileDialog(selectedPath)) {
+                node.logFilename = selectedPath;
+                fileChanged = true;
+            }
+        }
+
+        if (fileChanged && !node.logFilename.empty()) {
+            auto inputNode = std::make_shared<filter::LogReplayInput>(node.logFilename, node.logColumnName);
+            inputNode->setSpeed(node.replayAsFast ? 0.0 : node.replaySpeed);
+            inputNode->setLoop(node.replayLoop);
+            inputNode->start();
+            setNodeInput(node, inputNode);
+        }
+
+        if (auto inputNode = node.inputNode) {
+            if (auto* replayInput = dynamic_cast<filter::LogReplayInput*>(inputNode.get())) {
+                // The log is indexed in the background; the fields appear when it is done
+                if (replayInput->isLoading()) {
+                    ImGui::TextUnformatted("Indexing log...");
+                }
+
+                const auto fields = replayInput->getAvailableFields();
+                if (!fields.empty() && ImGui::BeginCombo("Select Field", node.logColumnName.c_str())) {
+                    for (const auto& field : fields) {
+                        bool isSelected = (field == node.logColumnName);
+                        if (ImGui::Selectable(field.c_str(), isSelected)) {
+                            node.logColumnName = field;
+                            replayInput->setField(field);
+                        }
+                    }
+                    ImGui::EndCombo();
+                }
+
+                // Replay controls
+                if (ImGui::Checkbox("As Fast As Possible", &node.replayAsFast)) {
+                    replayInput->setSpeed(node.replayAsFast ? 0.0 : node.replaySpeed);
+                }
+                if (!node.replayAsFast &&
+                    ImGui::SliderFloat("Speed", &node.replaySpeed, 0.1f, 100.0f, "%.1fx", ImGuiSliderFlags_Logarithmic)) {
+                    replayInput->setSpeed(node.replaySpeed);
+                }
+                if (ImGui::Checkbox("Loop", &node.replayLoop)) {
+                    replayInput->setLoop(node.replayLoop);
+                }
+
+                float position = static_cast<float>(replayInput->getPosition());
+                if (ImGui::SliderFloat("Position", &position, 0.0f,
+                                       static_cast<float>(replayInput->getDuration()), "%.2f s")) {
+                    replayInput->seek(position);
+                }
+            }
+        }
+    }
+    else if (node.nodeType == Node::NodeType::MultiColumnInput) {
+        char filename[256] = {0};
+        strncpy(filename, node.logFilename.c_str(), sizeof(filename) - 1);
+        bool fileChanged = ImGui::InputText("Log File", filename, sizeof(filename));
+        if (fileChanged) {
+            node.logFilename = filename;
+        }
+
+        if (ImGui::Button("Browse...")) {
+            std::string selectedPath;
+            if (openFileDialog(selectedPath)) {
+                node.logFilename = selectedPath;
+                fileChanged = true;
+            }
+        }
+
+        if (fileChanged && !node.logFilename.empty()) {
+            auto inputNode = std::make_shared<filter::MultiColumnInput>(node.logFilename);
+            inputNode->setColumns(node.selectedColumns);
+            inputNode->setPattern(node.columnPattern);
+            inputNode->start();
+            setNodeInput(node, inputNode);
+        }
+
+        if (auto inputNode = node.inputNode) {
+            if (auto* multiInput = dynamic_cast<filter::MultiColumnInput*>(inputNode.get())) {
+                if (multiInput->isLoading()) {
+                    ImGui::ProgressBar(static_cast<float>(multiInput->getLoadProgress()), ImVec2(-80.0f, 0.0f));
+                    ImGui::SameLine();
+                    if (ImGui::Button("Cancel")) {
+                        multiInput->cancelLoad();
+                    }
+                }
+
+                // Columns matching the pattern are added to the ticked ones
+                char pattern[256] = {0};
+                strncpy(pattern, node.columnPattern.c_str(), sizeof(pattern) - 1);
+                if (ImGui::InputText("Pattern", pattern, sizeof(pattern))) {
+                    node.columnPattern = pattern;
+                    multiInput->setPattern(node.columnPattern);
+                    processFilters();
+                }
+
+                const auto fields = multiInput->getAvailableFields();
+                if (!fields.empty() && ImGui::TreeNode("Columns")) {
+                    for (const auto& field : fields) {
+                        auto it = std::find(node.selectedColumns.begin(), node.selectedColumns.end(), field);
+                        bool selected = it != node.selectedColumns.end();
+                        if (ImGui::Checkbox(field.c_str(), &selected)) {
+                            if (selected) {
+                                node.selectedColumns.push_back(field);
+                            } else {
+                                node.selectedColumns.erase(it);
+                            }
+                            multiInput->setColumns(node.selectedColumns);
+                            processFilters();
+                        }
+                    }
+                    ImGui::TreePop();
+                }
+                ImGui::Text("Channels: %zu", multiInput->getChannels().size());
+            }
+        }
+    }
     else if (node.nodeType == Node::NodeType::NetworkTableInput) {
         char table[256] = {0};
         strncpy(table, node.networkTableName.c_str(), sizeof(table) - 1);
@@ -498,8 +1459,9 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
             node.networkTableName = table;
             if (!node.networkTableName.empty() && !node.networkTableKey.empty()) {
                 auto inputNode = std::make_shared<filter::NetworkTableInput>(node.networkTableName, node.networkTableKey);
+                inputNode->setHistoryLimit(static_cast<size_t>(node.networkTableHistory));
                 inputNode->start();
-                pipeline_->setInputNode(node.pipelineNodeId, inputNode);
+                setNodeInput(node, inputNode);
             }
         }
 
@@ -509,8 +1471,18 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
             node.networkTableKey = key;
             if (!node.networkTableName.empty() && !node.networkTableKey.empty()) {
                 auto inputNode = std::make_shared<filter::NetworkTableInput>(node.networkTableName, node.networkTableKey);
+                inputNode->setHistoryLimit(static_cast<size_t>(node.networkTableHistory));
                 inputNode->start();
-                pipeline_->setInputNode(node.pipelineNodeId, inputNode);
+                setNodeInput(node, inputNode);
+            }
+        }
+
+        // Samples kept for batch runs; off by default, since a live topic
+        // is read through the streaming path
+        if (ImGui::InputInt("Batch History", &node.networkTableHistory, 1000, 10000)) {
+            node.networkTableHistory = std::max(0, node.networkTableHistory);
+            if (auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(node.inputNode.get())) {
+                ntInput->setHistoryLimit(static_cast<size_t>(node.networkTableHistory));
             }
         }
 
@@ -521,7 +1493,7 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
         // Connection type selection
         static int connectionType = 0;
         if (ImGui::RadioButton("USB", &connectionType, 0)) {
-            if (auto inputNode = pipeline_->getInputNode(node.pipelineNodeId)) {
+            if (auto inputNode = node.inputNode) {
                 if (auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(inputNode.get())) {
                     ntInput->setUseUSB(true);
                     ntInput->stop();
@@ -531,7 +1503,7 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
         }
         ImGui::SameLine();
         if (ImGui::RadioButton("IP Address", &connectionType, 1)) {
-            if (auto inputNode = pipeline_->getInputNode(node.pipelineNodeId)) {
+            if (auto inputNode = node.inputNode) {
                 if (auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(inputNode.get())) {
                     ntInput->setUseUSB(false);
                     ntInput->stop();
@@ -549,7 +1521,7 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
             
             if (ImGui::CollapsingHeader("Team Number")) {
                 if (ImGui::InputInt("Team Number", &teamNumber)) {
-                    if (auto inputNode = pipeline_->getInputNode(node.pipelineNodeId)) {
+                    if (auto inputNode = node.inputNode) {
                         if (auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(inputNode.get())) {
                             ntInput->setTeamNumber(teamNumber);
                             ntInput->stop();
@@ -566,7 +1538,7 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
                 }
                 if (ImGui::InputText("IP Address", ipAddress, sizeof(ipAddress))) {
                     node.networkTableIP = ipAddress;
-                    if (auto inputNode = pipeline_->getInputNode(node.pipelineNodeId)) {
+                    if (auto inputNode = node.inputNode) {
                         if (auto* ntInput = dynamic_cast<filter::NetworkTableInput*>(inputNode.get())) {
                             ntInput->setIPAddress(node.networkTableIP);
                             ntInput->stop();
@@ -578,8 +1550,10 @@ void FilterDesignUI::renderInputParameters(int nodeId) {
         }
     }
 
+    renderResampleParameters(node);
+
     // Show connection status
-    if (auto inputNode = pipeline_->getInputNode(node.pipelineNodeId)) {
+    if (auto inputNode = node.inputNode) {
         ImGui::Text("Status: %s", inputNode->isConnected() ? "Connected" : "Disconnected");
     }
 }
@@ -591,15 +1565,116 @@ void FilterDesignUI::processFilters() {
     }
     updatePipelineConnections();
 
-    // Process data through the pipeline
-    std::vector<double> output = pipeline_->processData(std::vector<double>());
-    
-    // Update node outputs
+    // The worker reruns the graph; collectResults() picks up the output
+    worker_->requestProcess();
+}
+
+void FilterDesignUI::collectResults() {
+    // A finished background load has new data, so the graph is run again
+    bool loaded = false;
     for (auto& [id, node] : nodes_) {
-        if (node.nodeType == Node::NodeType::LogFileInput || 
-            node.nodeType == Node::NodeType::NetworkTableInput) {
-            node.outputData = output;
+        bool loading = false;
+        if (auto* logInput = dynamic_cast<filter::LogFileInput*>(node.inputNode.get())) {
+            loading = logInput->isLoading();
+        } else if (auto* multiInput = dynamic_cast<filter::MultiColumnInput*>(node.inputNode.get())) {
+            loading = multiInput->isLoading();
+        } else if (auto* replayInput = dynamic_cast<filter::LogReplayInput*>(node.inputNode.get())) {
+            loading = replayInput->isLoading();
         }
+        loaded = loaded || (node.loading && !loading);
+        node.loading = loading;
+    }
+    if (loaded) {
+        processFilters();
+    }
+
+    // Adopt the newest finished batch run; the columns are shared, not copied
+    auto result = worker_->getLatestResult();
+    if (result && result->revision != shownRevision_) {
+        shownRevision_ = result->revision;
+        for (auto& [id, node] : nodes_) {
+            if (node.nodeType == Node::NodeType::MultiColumnInput) {
+                auto it = result->channelOutputs.find(node.pipelineNodeId);
+                node.channelOutputs = it != result->channelOutputs.end() ? it->second : std::vector<pipeline::ChannelResult>();
+            } else if (node.isInput() || node.nodeType == Node::NodeType::Output) {
+                // Each node plots its own output, with the summary built for it
+                auto output = result->nodeOutputs.find(node.pipelineNodeId);
+                auto pyramid = result->nodePyramids.find(node.pipelineNodeId);
+                node.outputData = output != result->nodeOutputs.end() ? output->second : filter::ColumnBuffer();
+                node.outputPyramid = pyramid != result->nodePyramids.end() ? pyramid->second : nullptr;
+            }
+        }
+    }
+
+    // Append samples the worker streamed from followed inputs
+    for (auto& entry : streamOutputs_) {
+        entry.second.clear();
+    }
+    if (worker_->takeStreamOutput(streamOutputs_) == 0) {
+        return;
+    }
+
+    for (auto& [id, node] : nodes_) {
+        if ((node.isInput() && node.nodeType != Node::NodeType::MultiColumnInput) ||
+            node.nodeType == Node::NodeType::Output) {
+            auto samples = streamOutputs_.find(node.pipelineNodeId);
+            if (samples != streamOutputs_.end() && !samples->second.empty()) {
+                appendOutput(node, samples->second);
+            }
+        }
+    }
+}
+
+void FilterDesignUI::appendOutput(Node& node, const std::vector<double>& samples) {
+    // Both the column and its summary may still be shared with a worker result
+    auto& values = node.outputData.mutableValues();
+    values.insert(values.end(), samples.begin(), samples.end());
+    if (!node.outputPyramid) {
+        node.outputPyramid = std::make_shared<data::MinMaxPyramid>();
+    } else if (node.outputPyramid.use_count() > 1) {
+        node.outputPyramid = std::make_shared<data::MinMaxPyramid>(*node.outputPyramid);
+    }
+    node.outputPyramid->update(values);
+}
+
+void FilterDesignUI::setNodeInput(Node& node, std::shared_ptr<filter::InputNode> inputNode) {
+    detachRecorder(node);
+    node.inputNode = inputNode;
+    attachRecorder(node);
+    updateNodeResampling(node);
+}
+
+void FilterDesignUI::updateNodeResampling(Node& node) {
+    if (!node.inputNode) {
+        return;
+    }
+
+    // The UI keeps the source; the pipeline reads it through the resampler
+    std::shared_ptr<filter::InputNode> pipelineInput = node.inputNode;
+    if (node.resample && node.resampleRate > 0.0f) {
+        pipelineInput = std::make_shared<filter::ResamplingInput>(
+            node.inputNode, node.resampleRate,
+            static_cast<filter::Interpolation>(node.resampleMethod), node.resampleMaxGap);
+    }
+    worker_->setInputNode(node.pipelineNodeId, std::move(pipelineInput));
+}
+
+void FilterDesignUI::renderResampleParameters(Node& node) {
+    // The resampling wrapper would hide the channels of a multi-column input
+    if (node.nodeType == Node::NodeType::MultiColumnInput) {
+        return;
+    }
+
+    ImGui::Separator();
+    bool changed = ImGui::Checkbox("Resample to Uniform Rate", &node.resample);
+    if (node.resample) {
+        static const char* methods[] = {"Zero-Order Hold", "Linear", "Cubic"};
+        changed |= ImGui::SliderFloat("Output Rate", &node.resampleRate, 1.0f, 10000.0f, "%.1f Hz", ImGuiSliderFlags_Logarithmic);
+        changed |= ImGui::Combo("Interpolation", &node.resampleMethod, methods, IM_ARRAYSIZE(methods));
+        changed |= ImGui::SliderFloat("Max Gap", &node.resampleMaxGap, 0.0f, 5.0f, "%.2f s");
+    }
+    if (changed) {
+        updateNodeResampling(node);
     }
 }
 
@@ -641,14 +1716,49 @@ void FilterDesignUI::updatePipelineNode(Node& node) const {
             type = "BandPass";
             break;
         default:
-            return;  // Skip non-filter nodes
+            // Input and output nodes get pass-through pipeline nodes to feed
+            // samples from and to collect the output at
+            params.clear();
+            if (node.isInput()) {
+                type = "Input";
+            } else if (node.nodeType == Node::NodeType::Output) {
+                type = "Output";
+            } else if (node.nodeType == Node::NodeType::PowerSpectrum) {
+                type = "PowerSpectrum";
+            } else if (node.nodeType == Node::NodeType::Spectrogram) {
+                type = "Spectrogram";
+            } else if (node.nodeType == Node::NodeType::Kalman) {
+                // The pipeline runs this filter itself
+                type = "Kalman";
+                params["model"] = node.kalmanModel;
+                params["output"] = node.kalmanOutput;
+                params["steadyState"] = node.kalmanSteadyState ? 1.0 : 0.0;
+                params["sampleRate"] = node.kalmanRate;
+                params["processNoise"] = node.kalmanProcessNoise;
+                params["measurementNoise"] = node.kalmanMeasurementNoise;
+            } else if (node.isOrderStatistic()) {
+                // The pipeline runs these filters itself
+                params["windowSize"] = static_cast<double>(node.windowSize);
+                if (node.nodeType == Node::NodeType::Median) {
+                    type = "Median";
+                } else if (node.nodeType == Node::NodeType::Percentile) {
+                    type = "Percentile";
+                    params["percentile"] = node.percentile;
+                } else {
+                    type = "TrimmedMean";
+                    params["trimFraction"] = node.trimFraction;
+                }
+            } else {
+                return;
+            }
+            break;
     }
     
     // Create or update pipeline node
     if (node.pipelineNodeId.empty()) {
-        node.pipelineNodeId = pipeline_->addNode(type, params);
+        node.pipelineNodeId = worker_->addNode(type, params);
     } else {
-        pipeline_->setNodeParameters(node.pipelineNodeId, params);
+        worker_->setNodeParameters(node.pipelineNodeId, params);
     }
 }
 
@@ -658,7 +1768,7 @@ void FilterDesignUI::updatePipelineConnections() {
         if (!node.pipelineNodeId.empty()) {
             for (const auto& [linkId, link] : links_) {
                 if (link.fromNode == id) {
-                    pipeline_->disconnectNodes(node.pipelineNodeId, nodes_[link.toNode].pipelineNodeId);
+                    worker_->disconnectNodes(node.pipelineNodeId, nodes_[link.toNode].pipelineNodeId);
                 }
             }
         }
@@ -670,7 +1780,14 @@ void FilterDesignUI::updatePipelineConnections() {
         const auto& toNode = nodes_[link.toNode];
         
         if (!fromNode.pipelineNodeId.empty() && !toNode.pipelineNodeId.empty()) {
-            pipeline_->connectNodes(fromNode.pipelineNodeId, toNode.pipelineNodeId);
+            worker_->connectNodes(fromNode.pipelineNodeId, toNode.pipelineNodeId);
+        }
+    }
+
+    // Correlation nodes are not in the pipeline; they follow their links here
+    for (auto& [id, node] : nodes_) {
+        if (node.nodeType == Node::NodeType::CrossCorrelation) {
+            updateCorrelator(node);
         }
     }
 }
@@ -752,7 +1869,47 @@ double FilterDesignUI::processSample(Node& node, double input) {
 }
 
 void FilterDesignUI::calculateFrequencyResponse(Node& node) {
-    // TODO: Implement frequency response calculation
+    node.responseFrequencies.clear();
+    node.responseDb.clear();
+    constexpr int kPoints = 512;
+
+    // The Kalman filter's response is the steady state it settles into
+    if (node.nodeType == Node::NodeType::Kalman) {
+        filter::KinematicSettings settings;
+        settings.sampleRate = node.kalmanRate;
+        settings.processNoise = node.kalmanProcessNoise;
+        settings.measurementNoise = node.kalmanMeasurementNoise;
+        settings.output = node.kalmanOutput;
+        const auto kalman = filter::makeKinematicKalmanFilter(static_cast<filter::KinematicModel>(node.kalmanModel), settings);
+        for (int i = 0; i <= kPoints; ++i) {
+            node.responseFrequencies.push_back(0.5 * node.kalmanRate * i / kPoints);
+        }
+        for (const auto& response : kalman->getFrequencyResponse(node.responseFrequencies)) {
+            node.responseDb.push_back(20.0 * std::log10(std::max(std::abs(response), 1e-12)));
+        }
+        return;
+    }
+
+    // Only the low-pass types have a designer so far
+    filter::DesignSpec spec;
+    if (node.filterType == Node::FilterType::Butterworth) {
+        spec.type = filter::DesignType::Butterworth;
+    } else if (node.filterType == Node::FilterType::Chebyshev) {
+        spec.type = filter::DesignType::Chebyshev;
+    } else {
+        return;
+    }
+    spec.order = node.order;
+    spec.cutoffFreq = node.cutoffFreq;
+    spec.sampleRate = node.sampleRate;
+    spec.ripple = node.ripple;
+    const auto sections = filter::designLowPass(spec);
+
+    for (int i = 0; i <= kPoints; ++i) {
+        const double frequency = 0.5 * node.sampleRate * i / kPoints;
+        node.responseFrequencies.push_back(frequency);
+        node.responseDb.push_back(20.0 * std::log10(std::max(filter::magnitudeResponse(sections, frequency, node.sampleRate), 1e-12)));
+    }
 }
 
 void FilterDesignUI::calculatePoleZero(Node& node) {
@@ -809,10 +1966,18 @@ void FilterDesignUI::createNode(Node::NodeType type) {
             node.title = "Log File Input";
             node.outputPins.push_back(nextNodeId_++);
             break;
+        case Node::NodeType::LogReplayInput:
+            node.title = "Log Replay Input";
+            node.outputPins.push_back(nextNodeId_++);
+            break;
         case Node::NodeType::NetworkTableInput:
             node.title = "Network Table Input";
             node.outputPins.push_back(nextNodeId_++);
             break;
+        case Node::NodeType::MultiColumnInput:
+            node.title = "Multi-Column Log Input";
+            node.outputPins.push_back(nextNodeId_++);
+            break;
         case Node::NodeType::Output:
             node.title = "Output";
             node.inputPins.push_back(nextNodeId_++);
@@ -849,6 +2014,42 @@ void FilterDesignUI::createNode(Node::NodeType type) {
             node.ui_bandwidth = static_cast<float>(node.bandwidth);
             calculateFilterCoefficients(node);
             break;
+        case Node::NodeType::Median:
+            node.title = "Median";
+            node.inputPins.push_back(nextNodeId_++);
+            node.outputPins.push_back(nextNodeId_++);
+            break;
+        case Node::NodeType::Percentile:
+            node.title = "Percentile";
+            node.inputPins.push_back(nextNodeId_++);
+            node.outputPins.push_back(nextNodeId_++);
+            break;
+        case Node::NodeType::TrimmedMean:
+            node.title = "Trimmed Mean";
+            node.inputPins.push_back(nextNodeId_++);
+            node.outputPins.push_back(nextNodeId_++);
+            break;
+        case Node::NodeType::Kalman:
+            node.title = "Kalman";
+            node.inputPins.push_back(nextNodeId_++);
+            node.outputPins.push_back(nextNodeId_++);
+            calculateFrequencyResponse(node);
+            break;
+        case Node::NodeType::PowerSpectrum:
+            node.title = "Power Spectrum";
+            node.inputPins.push_back(nextNodeId_++);
+            node.outputPins.push_back(nextNodeId_++);
+            break;
+        case Node::NodeType::Spectrogram:
+            node.title = "Spectrogram";
+            node.inputPins.push_back(nextNodeId_++);
+            node.outputPins.push_back(nextNodeId_++);
+            break;
+        case Node::NodeType::CrossCorrelation:
+            node.title = "Cross-Correlation";
+            node.inputPins.push_back(nextNodeId_++);
+            node.inputPins.push_back(nextNodeId_++);
+            break;
         case Node::NodeType::BandPass:
             node.title = "Band Pass";
             node.filterType = Node::FilterType::BandPass;
@@ -862,14 +2063,36 @@ void FilterDesignUI::createNode(Node::NodeType type) {
             break;
     }
 
-    nodes_[node.id] = std::move(node);
-    updatePipelineNode(nodes_[node.id]);
+    const int nodeId = node.id;
+    nodes_[nodeId] = std::move(node);
+    updatePipelineNode(nodes_[nodeId]);
+    if (nodes_[nodeId].isAnalysis()) {
+        attachAnalyzers(nodes_[nodeId]);
+    }
+    attachRecorder(nodes_[nodeId]);
 }
 
 void FilterDesignUI::deleteNode(int nodeId) {
     auto it = nodes_.find(nodeId);
+    if (it != nodes_.end()) {
+        detachRecorder(it->second);
+        recordChannels_.erase(nodeId);
+    }
     if (it != nodes_.end() && !it->second.pipelineNodeId.empty()) {
-        pipeline_->removeNode(it->second.pipelineNodeId);
+        if (it->second.outputSink) {
+            worker_->setOutputSink(it->second.pipelineNodeId, nullptr);
+        }
+        if (it->second.analyzer) {
+            worker_->setAnalyzer(it->second.pipelineNodeId, nullptr);
+        }
+        if (it->second.inputAnalyzer) {
+            worker_->setAnalyzer(it->second.pipelineNodeId, nullptr, true);
+        }
+        worker_->removeNode(it->second.pipelineNodeId);
+    }
+    // Correlation nodes have no pipeline node of their own
+    if (it != nodes_.end() && it->second.correlator) {
+        worker_->setCorrelator(it->second.correlator, std::string(), std::string());
     }
     nodes_.erase(nodeId);
 }
@@ -881,7 +2104,7 @@ void FilterDesignUI::deleteLink(int linkId) {
         const auto& toNode = nodes_[it->second.toNode];
         
         if (!fromNode.pipelineNodeId.empty() && !toNode.pipelineNodeId.empty()) {
-            pipeline_->disconnectNodes(fromNode.pipelineNodeId, toNode.pipelineNodeId);
+            worker_->disconnectNodes(fromNode.pipelineNodeId, toNode.pipelineNodeId);
         }
     }
     links_.erase(linkId);